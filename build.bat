@@ -72,7 +72,7 @@ GOTO nextStep
 
 :compile
 ECHO Compiling...
-gcc src/*.c -o %CompiledFile% -O1 -Wall -Wextra -Wno-unused-parameter -pedantic-errors -std=c99 -Wno-missing-braces -I src/include/ -I src/include/c11 -I src/include/raylib -I src/include/stc -L lib/ -lraylib -lopengl32 -lgdi32 -lwinmm
+gcc src/*.c -o %CompiledFile% -O1 -Wall -Wextra -Wno-unused-parameter -pedantic-errors -std=c99 -Wno-missing-braces -I src/include/ -I src/include/c11 -I src/include/raylib -I src/include/stc -L lib/ -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
 GOTO nextStep
 
 :run
@@ -45,16 +45,38 @@ if ( $compile -or $cleanAndCompile -or $compileAndRun -or $all ) {
     Write-Host "Compiling..."
     New-Item -Path ".\$BuildDir" -ItemType Directory > $null
     emcc -o "./$BuildDir/$CompiledFile.html" `
+         ./src/Benchmark.c `
          ./src/Block.c `
          ./src/Bullet.c `
          ./src/Enemy.c `
+         ./src/EnemyImpostors.c `
+         ./src/FrameCapture.c `
+         ./src/Frustum.c `
          ./src/GameWindow.c `
          ./src/GameWorld.c `
+         ./src/GpuTimer.c `
+         ./src/HpBarBatch.c `
+         ./src/HudPanel.c `
+         ./src/ImpactDecals.c `
+         ./src/LightClusters.c `
+         ./src/LightingShaders.c `
+         ./src/Lightmap.c `
          ./src/main.c `
+         ./src/OcclusionCuller.c `
+         ./src/ParticleSystem.c `
+         ./src/PickBuffer.c `
          ./src/Player.c `
          ./src/PowerUp.c `
+         ./src/Pvs.c `
+         ./src/QualityGovernor.c `
+         ./src/RenderQueue.c `
          ./src/ResourceManager.c `
+         ./src/SceneTarget.c `
+         ./src/SphereBatch.c `
+         ./src/StreamBuffer.c `
          ./src/utils.c `
+         ./src/WorldChunks.c `
+         ./src/WorldMesher.c `
          -Wall `
          -std=c99 `
          -D_DEFAULT_SOURCE `
@@ -1,5 +1,7 @@
 #version 100
 
+#extension GL_OES_standard_derivatives : enable
+
 precision mediump float;
 
 // Input vertex attributes (from vertex shader)
@@ -31,6 +33,19 @@ uniform Light lights[MAX_LIGHTS];
 uniform vec4 ambient;
 uniform vec3 viewPos;
 
+// outline width in pixels, drawn where the texture coordinates cross an
+// integer (the faces of the cube meshes and each block of the merged obstacles)
+uniform float outlineWidth;
+
+float outlineFactor(vec2 texCoord)
+{
+    if (outlineWidth <= 0.0) return 1.0;
+    vec2 f = fract(texCoord);
+    vec2 d = min(f, 1.0 - f)/max(fwidth(texCoord), vec2(1e-6));
+    float e = min(d.x, d.y);
+    return smoothstep(outlineWidth - 0.5, outlineWidth + 0.5, e);
+}
+
 void main()
 {
     // Texel color fetching from texture sampler
@@ -75,4 +90,7 @@ void main()
 
     // Gamma correction
     gl_FragColor = pow(finalColor, vec4(1.0/2.2));
+
+    // Edge outline, in the same pass
+    gl_FragColor.rgb *= outlineFactor(fragTexCoord);
 }
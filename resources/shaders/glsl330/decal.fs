@@ -0,0 +1,19 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // round mark with soft borders, darker at the center like a hole
+    float d = length(fragTexCoord*2.0 - 1.0);
+    float alpha = fragColor.a*(1.0 - smoothstep(0.7, 1.0, d));
+
+    if (alpha <= 0.0) discard;
+
+    finalColor = vec4(mix(fragColor.rgb*0.3, fragColor.rgb, smoothstep(0.0, 0.6, d)), alpha);
+}
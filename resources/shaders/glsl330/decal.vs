@@ -0,0 +1,42 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+
+// Input instance attributes
+in vec4 instancePosition;   // xyz: point of the impact, w: size (zero when removed)
+in vec4 instanceNormal;     // xyz: normal of the surface, w: time of the impact
+in vec4 instanceColor;
+
+// Input uniform values
+uniform mat4 mvp;
+uniform float time;
+uniform vec2 fade;          // x: lifetime, y: fade out time
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main()
+{
+    // basis of the surface plane
+    vec3 normal = normalize(instanceNormal.xyz);
+    vec3 helper = abs(normal.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+    vec3 tangent = normalize(cross(helper, normal));
+    vec3 bitangent = cross(normal, tangent);
+
+    float age = time - instanceNormal.w;
+    float alpha = clamp((fade.x - age)/fade.y, 0.0, 1.0);
+
+    // expired and removed decals collapse to a point and aren't rasterized,
+    // the others are moved a little away from the surface to avoid z-fighting
+    float size = alpha > 0.0 ? instancePosition.w : 0.0;
+    vec3 position = instancePosition.xyz + normal*0.01 + (tangent*vertexPosition.x + bitangent*vertexPosition.y)*size;
+
+    fragTexCoord = vertexTexCoord;
+    fragColor = vec4(instanceColor.rgb, instanceColor.a*alpha);
+
+    // Calculate final vertex position
+    gl_Position = mvp*vec4(position, 1.0);
+}
@@ -0,0 +1,10 @@
+#version 330
+
+// Output fragment color
+out vec4 finalColor;
+
+// Depth prepass: the color writes are off, only the depth matters
+void main()
+{
+    finalColor = vec4(1.0);
+}
@@ -0,0 +1,23 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    vec4 texelColor = texture(texture0, fragTexCoord);
+
+    // the impostors are opaque, the empty texels around the enemy are cut
+    // out, so they write depth only where the enemy is
+    if (texelColor.a < 0.5) discard;
+
+    finalColor = vec4(texelColor.rgb, 1.0)*colDiffuse*fragColor;
+}
@@ -1,11 +1,22 @@
 #version 330
 
+// Variants (see LightingShaders.c): LIGHTING_SPECULAR, LIGHTING_GAMMA and
+// LIGHTING_PER_VERTEX, that takes the light computed by the vertex shader
+#ifndef MAX_LIGHTS_PER_CLUSTER
+#define MAX_LIGHTS_PER_CLUSTER 32
+#endif
+
 // Input vertex attributes (from vertex shader)
 in vec3 fragPosition;
 in vec2 fragTexCoord;
 in vec4 fragColor;
 in vec3 fragNormal;
 
+#ifdef LIGHTING_PER_VERTEX
+in vec3 fragLight;
+in vec3 fragSpecular;
+#endif
+
 // Input uniform values
 uniform sampler2D texture0;
 uniform vec4 colDiffuse;
@@ -15,67 +26,104 @@ out vec4 finalColor;
 
 // NOTE: Add here your custom variables
 
-#define     MAX_LIGHTS              4
-#define     LIGHT_DIRECTIONAL       0
-#define     LIGHT_POINT             1
+#ifndef LIGHTING_PER_VERTEX
+// Clustered point lights (see LightClusters.c)
+uniform sampler2D lightData;        // 2 texels per light: position and radius, color
+uniform sampler2D clusterData;      // offset and count of the lights of each cluster
+uniform sampler2D lightIndices;     // light indexes of every cluster, one after the other
+uniform vec3 clusterGrid;           // clusters along x, y and z
+uniform vec2 clusterDepth;          // near depth and slices / log(far/near)
+uniform vec4 clusterViewport;       // region of the framebuffer, in pixels
+uniform vec3 viewForward;
 
-struct Light {
-    int enabled;
-    int type;
-    vec3 position;
-    vec3 target;
-    vec4 color;
-};
+#define     LIGHT_INDICES_WIDTH     1024
+#endif
 
 // Input lighting values
-uniform Light lights[MAX_LIGHTS];
 uniform vec4 ambient;
 uniform vec3 viewPos;
 
+// outline width in pixels, drawn where the texture coordinates cross an
+// integer (the faces of the cube meshes and each block of the merged obstacles)
+uniform float outlineWidth;
+
+float outlineFactor(vec2 texCoord)
+{
+    if (outlineWidth <= 0.0) return 1.0;
+    vec2 f = fract(texCoord);
+    vec2 d = min(f, 1.0 - f)/max(fwidth(texCoord), vec2(1e-6));
+    float e = min(d.x, d.y);
+    return smoothstep(outlineWidth - 0.5, outlineWidth + 0.5, e);
+}
+
 void main()
 {
     // Texel color fetching from texture sampler
     vec4 texelColor = texture(texture0, fragTexCoord);
+
+    vec4 tint = colDiffuse * fragColor;
+
+    // NOTE: Implement here your fragment shader code
+
+#ifdef LIGHTING_PER_VERTEX
+    vec3 lightDot = fragLight;
+    vec3 specular = fragSpecular;
+#else
     vec3 lightDot = vec3(0.0);
     vec3 normal = normalize(fragNormal);
     vec3 viewD = normalize(viewPos - fragPosition);
     vec3 specular = vec3(0.0);
 
-    vec4 tint = colDiffuse * fragColor;
+    // Cluster of the fragment
+    vec2 tile = (gl_FragCoord.xy - clusterViewport.xy)/clusterViewport.zw*clusterGrid.xy;
+    float depth = dot(fragPosition - viewPos, viewForward);
+    float slice = floor(log(max(depth, clusterDepth.x)/clusterDepth.x)*clusterDepth.y);
+    ivec3 cluster = ivec3(clamp(vec3(floor(tile), slice), vec3(0.0), clusterGrid - 1.0));
 
-    // NOTE: Implement here your fragment shader code
+    vec4 lightRange = texelFetch(clusterData, ivec2(cluster.x + cluster.y*int(clusterGrid.x), cluster.z), 0);
+    int offset = int(lightRange.r);
+    int count = int(lightRange.g);
 
-    for (int i = 0; i < MAX_LIGHTS; i++)
+    // constant bound, so the loop can be unrolled
+    for (int i = 0; i < MAX_LIGHTS_PER_CLUSTER; i++)
     {
-        if (lights[i].enabled == 1)
-        {
-            vec3 light = vec3(0.0);
-
-            if (lights[i].type == LIGHT_DIRECTIONAL)
-            {
-                light = -normalize(lights[i].target - lights[i].position);
-            }
-
-            if (lights[i].type == LIGHT_POINT)
-            {
-                light = normalize(lights[i].position - fragPosition);
-            }
-
-            float NdotL = max(dot(normal, light), 0.0);
-            lightDot += lights[i].color.rgb*NdotL;
-
-            float specCo = 0.0;
-            //if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 16.0); // 16 refers to shine
-            if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 100.0); // 16 refers to shine
-            specular += specCo;
-        }
+        if (i >= count) break;
+
+        int index = offset + i;
+        int lightIndex = int(texelFetch(lightIndices, ivec2(index%LIGHT_INDICES_WIDTH, index/LIGHT_INDICES_WIDTH), 0).r);
+
+        vec4 positionRadius = texelFetch(lightData, ivec2(lightIndex*2, 0), 0);
+        vec4 color = texelFetch(lightData, ivec2(lightIndex*2 + 1, 0), 0);
+
+        vec3 toLight = positionRadius.xyz - fragPosition;
+        float dist = length(toLight);
+        vec3 light = toLight/max(dist, 0.0001);
+
+        // smooth falloff, zero at the radius of the light
+        float attenuation = clamp(1.0 - (dist*dist)/(positionRadius.w*positionRadius.w), 0.0, 1.0);
+        attenuation *= attenuation;
+
+        float NdotL = max(dot(normal, light), 0.0);
+        lightDot += color.rgb*NdotL*attenuation;
+
+#ifdef LIGHTING_SPECULAR
+        float specCo = 0.0;
+        if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 100.0); // 100 refers to shine
+        specular += specCo*attenuation;
+#endif
     }
+#endif
 
     //finalColor = (texelColor*((colDiffuse + vec4(specular, 1.0))*vec4(lightDot, 1.0)));
     //finalColor += texelColor*(ambient/10.0)*colDiffuse;
     finalColor = (texelColor*((tint + vec4(specular, 1.0))*vec4(lightDot, 1.0)));
     finalColor += texelColor*(ambient/10.0)*tint;
 
+#ifdef LIGHTING_GAMMA
     // Gamma correction
     finalColor = pow(finalColor, vec4(1.0/2.2));
+#endif
+
+    // Edge outline, in the same pass
+    finalColor.rgb *= outlineFactor(fragTexCoord);
 }
@@ -1,5 +1,11 @@
 #version 330
 
+// Variants (see LightingShaders.c): LIGHTING_SPECULAR, LIGHTING_GAMMA and
+// LIGHTING_PER_VERTEX, that moves the lighting to this shader
+#ifndef MAX_LIGHTS
+#define MAX_LIGHTS 128
+#endif
+
 // Input vertex attributes
 in vec3 vertexPosition;
 in vec2 vertexTexCoord;
@@ -19,6 +25,16 @@ out vec3 fragNormal;
 
 // NOTE: Add here your custom variables
 
+#ifdef LIGHTING_PER_VERTEX
+// Every enabled light, packed by the light clusters
+uniform sampler2D lightData;        // 2 texels per light: position and radius, color
+uniform int lightCount;
+uniform vec3 viewPos;
+
+out vec3 fragLight;
+out vec3 fragSpecular;
+#endif
+
 void main()
 {
     // Send vertex attributes to fragment shader
@@ -27,6 +43,37 @@ void main()
     fragColor = vertexColor;
     fragNormal = normalize(vec3(matNormal*vec4(vertexNormal, 1.0)));
 
+#ifdef LIGHTING_PER_VERTEX
+    vec3 viewD = normalize(viewPos - fragPosition);
+    fragLight = vec3(0.0);
+    fragSpecular = vec3(0.0);
+
+    for (int i = 0; i < MAX_LIGHTS; i++)
+    {
+        if (i >= lightCount) break;
+
+        vec4 positionRadius = texelFetch(lightData, ivec2(i*2, 0), 0);
+        vec4 color = texelFetch(lightData, ivec2(i*2 + 1, 0), 0);
+
+        vec3 toLight = positionRadius.xyz - fragPosition;
+        float dist = length(toLight);
+        vec3 light = toLight/max(dist, 0.0001);
+
+        // smooth falloff, zero at the radius of the light
+        float attenuation = clamp(1.0 - (dist*dist)/(positionRadius.w*positionRadius.w), 0.0, 1.0);
+        attenuation *= attenuation;
+
+        float NdotL = max(dot(fragNormal, light), 0.0);
+        fragLight += color.rgb*NdotL*attenuation;
+
+#ifdef LIGHTING_SPECULAR
+        float specCo = 0.0;
+        if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), fragNormal))), 100.0); // 100 refers to shine
+        fragSpecular += specCo*attenuation;
+#endif
+    }
+#endif
+
     // Calculate final vertex position
     gl_Position = mvp*vec4(vertexPosition, 1.0);
 }
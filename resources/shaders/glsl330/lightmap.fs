@@ -0,0 +1,76 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec2 fragTexCoord2;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform sampler2D texture1;         // lightmap
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+// Static lighting baked in the lightmap (see Lightmap.c), that stores the
+// light divided by its range
+#define LIGHTMAP_RANGE 2.0
+
+uniform vec4 ambient;
+uniform float lightmapScale;        // zero when the lights are off
+
+#ifdef PROCEDURAL_CHECKER
+in vec3 fragPosition;
+in vec3 fragNormal;
+
+// the ground and the walls are painted with squares of this size, in world
+// units, and the two colors are the texels of texture0 (2x1)
+#define CHECKER_SIZE 2.0
+
+uniform int unlit;                  // the map has no lights at all
+#endif
+
+// outline width in pixels, drawn where the texture coordinates cross an
+// integer (the faces of the cube meshes and each block of the merged obstacles)
+uniform float outlineWidth;
+
+float outlineFactor(vec2 texCoord)
+{
+    if (outlineWidth <= 0.0) return 1.0;
+    vec2 f = fract(texCoord);
+    vec2 d = min(f, 1.0 - f)/max(fwidth(texCoord), vec2(1e-6));
+    float e = min(d.x, d.y);
+    return smoothstep(outlineWidth - 0.5, outlineWidth + 0.5, e);
+}
+
+void main()
+{
+#ifdef PROCEDURAL_CHECKER
+    // a bit inside the surface, so the cell along the normal doesn't flicker
+    vec3 cell = floor((fragPosition - fragNormal*0.25)/CHECKER_SIZE);
+    float odd = mod(cell.x + cell.y + cell.z, 2.0);
+    vec4 texelColor = texture(texture0, vec2((odd + 0.5)/2.0, 0.5));
+#else
+    vec4 texelColor = texture(texture0, fragTexCoord);
+#endif
+    vec4 tint = colDiffuse * fragColor;
+
+#ifdef PROCEDURAL_CHECKER
+    if (unlit != 0)
+    {
+        finalColor = texelColor*tint;
+        return;
+    }
+#endif
+    vec3 light = texture(texture1, fragTexCoord2).rgb*LIGHTMAP_RANGE*lightmapScale;
+
+    finalColor = texelColor*tint*vec4(light, 1.0);
+    finalColor += texelColor*(ambient/10.0)*tint;
+
+    // Gamma correction
+    finalColor = pow(finalColor, vec4(1.0/2.2));
+
+    // Edge outline, in the same pass
+    finalColor.rgb *= outlineFactor(fragTexCoord);
+}
@@ -0,0 +1,37 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec2 vertexTexCoord2;
+in vec4 vertexColor;
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec2 fragTexCoord2;
+out vec4 fragColor;
+
+#ifdef PROCEDURAL_CHECKER
+in vec3 vertexNormal;
+uniform mat4 matModel;
+out vec3 fragPosition;
+out vec3 fragNormal;
+#endif
+
+void main()
+{
+    // Send vertex attributes to fragment shader
+    fragTexCoord = vertexTexCoord;
+    fragTexCoord2 = vertexTexCoord2;
+    fragColor = vertexColor;
+#ifdef PROCEDURAL_CHECKER
+    fragPosition = vec3(matModel*vec4(vertexPosition, 1.0));
+    fragNormal = normalize(mat3(matModel)*vertexNormal);
+#endif
+
+    // Calculate final vertex position
+    gl_Position = mvp*vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,22 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform int entity;         // entity type << 22 | entity id
+uniform vec2 clipPlanes;    // near and far
+
+// Output fragment color
+out vec4 finalColor;
+
+// Picking: the float target stores the entity in red and the distance
+// from the camera in green, so both come from the same fragment
+void main()
+{
+    float ndc = gl_FragCoord.z*2.0 - 1.0;
+    float depth = 2.0*clipPlanes.x*clipPlanes.y/(clipPlanes.y + clipPlanes.x - ndc*(clipPlanes.y - clipPlanes.x));
+
+    finalColor = vec4(float(entity), depth, 0.0, 1.0);
+}
@@ -0,0 +1,64 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec3 fragPosition;
+in vec2 fragTexCoord;
+in vec3 fragNormal;
+in vec3 fragObjectNormal;
+in vec4 fragColor;
+flat in int fragFlags;
+
+// Input uniform values
+uniform vec3 viewPos;
+uniform vec2 gridSize;      // rings and slices of the mesh being drawn
+
+// Output fragment color
+out vec4 finalColor;
+
+#define FLAG_CHECKERED 1
+#define FLAG_UNLIT 2
+#define FLAG_WIRES 4
+#define FLAG_WIRES_ONLY 8
+
+const float PI = 3.14159265358979;
+
+// 1 pixel lines over the slices and rings of the sphere
+float wireFactor()
+{
+    vec2 uv = fragTexCoord*gridSize;
+    vec2 f = fract(uv);
+    vec2 d = min(f, 1.0 - f)/max(fwidth(uv), vec2(1e-6));
+    return smoothstep(0.5, 1.5, min(d.x, d.y));
+}
+
+void main()
+{
+    vec4 color = fragColor;
+    float wire = 1.0;
+
+    if ((fragFlags & (FLAG_WIRES | FLAG_WIRES_ONLY)) != 0) {
+        wire = wireFactor();
+        if ((fragFlags & FLAG_WIRES_ONLY) != 0) {
+            if (wire > 0.5) discard;
+            finalColor = vec4(0.0, 0.0, 0.0, 1.0);
+            return;
+        }
+    }
+
+    // same 2x2 checker of the power-ups texture, in spherical coordinates
+    if ((fragFlags & FLAG_CHECKERED) != 0) {
+        vec3 n = normalize(fragObjectNormal);
+        float u = atan(n.z, n.x)/(2.0*PI) + 0.5;
+        float v = acos(clamp(n.y, -1.0, 1.0))/PI;
+        if ((u < 0.5) != (v < 0.5)) color.rgb *= vec3(200.0/255.0);
+    }
+
+    if ((fragFlags & FLAG_UNLIT) == 0) {
+        vec3 viewDir = normalize(viewPos - fragPosition);
+        color.rgb *= 0.4 + 0.6*max(dot(normalize(fragNormal), viewDir), 0.0);
+    }
+
+    color.rgb *= wire;
+
+    finalColor = color;
+}
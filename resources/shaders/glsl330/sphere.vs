@@ -0,0 +1,40 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec3 vertexNormal;
+
+// Input instance attributes
+in vec4 instancePosition;   // xyz: center, w: radius
+in vec4 instanceColor;
+in vec2 instanceParams;     // x: rotation around y (degrees), y: flags
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+out vec3 fragPosition;
+out vec2 fragTexCoord;
+out vec3 fragNormal;
+out vec3 fragObjectNormal;
+out vec4 fragColor;
+flat out int fragFlags;
+
+void main()
+{
+    // object space normal, rotated back so the checker pattern turns with the sphere
+    float angle = -radians(instanceParams.x);
+    float c = cos(angle);
+    float s = sin(angle);
+    fragObjectNormal = vec3(c*vertexNormal.x + s*vertexNormal.z, vertexNormal.y, -s*vertexNormal.x + c*vertexNormal.z);
+
+    fragPosition = instancePosition.xyz + vertexPosition*instancePosition.w;
+    fragTexCoord = vertexTexCoord;
+    fragNormal = vertexNormal;
+    fragColor = instanceColor;
+    fragFlags = int(instanceParams.y);
+
+    // Calculate final vertex position
+    gl_Position = mvp*vec4(fragPosition, 1.0);
+}
@@ -0,0 +1,264 @@
+/**
+ * @file Benchmark.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Benchmark implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "GameWorld.h"
+#include "Benchmark.h"
+#include "GpuTimer.h"
+#include "QualityGovernor.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+// fraction of the loop between the camera and the point it looks at
+static const float LOOK_AHEAD = 0.03f;
+
+static Vector3 getPathPoint( Benchmark *b, float t );
+static int compareFloats( const void *p1, const void *p2 );
+static float getPercentile( float *sorted, int quantity, float percentile );
+
+void initBenchmark( Benchmark *b, GameWorld *gw, int frameQuantity ) {
+
+    *b = (Benchmark){
+        .frames = (BenchmarkFrame*) calloc( frameQuantity, sizeof( BenchmarkFrame ) ),
+        .frameQuantity = frameQuantity,
+        .frame = -BENCHMARK_WARMUP_FRAMES
+    };
+
+    // alternates between the borders and the middle of the map, low and
+    // high, so the frames see from a few obstacles to the whole map
+    Vector3 center = gw->ground.pos;
+    Vector3 halfDim = Vector3Scale( gw->ground.dim, 0.5f );
+    const float heights[4] = { 3.0f, 8.0f, 18.0f, 8.0f };
+
+    for ( int i = 0; i < BENCHMARK_PATH_POINTS; i++ ) {
+        float angle = 2.0f * PI * i / BENCHMARK_PATH_POINTS;
+        float radius = i % 2 == 0 ? 0.8f : 0.35f;
+        b->path[i] = (Vector3){
+            center.x + cosf( angle ) * halfDim.x * radius,
+            center.y + halfDim.y + heights[i % 4],
+            center.z + sinf( angle ) * halfDim.z * radius
+        };
+    }
+
+    // the same quality in every frame and in every run
+    setEnabledQualityGovernor( &gw->governor, false );
+    applyQualityLevel( gw );
+
+    setEnabledGpuTimer( &gw->gpuTimer, true );
+
+}
+
+void destroyBenchmark( Benchmark *b ) {
+    free( b->frames );
+    *b = (Benchmark){ 0 };
+}
+
+void updateBenchmark( Benchmark *b, GameWorld *gw ) {
+
+    gw->frameStartTime = GetTime();
+
+    float t = b->frame < 0 ? 0.0f : (float) b->frame / b->frameQuantity;
+    Vector3 ahead = getPathPoint( b, t + LOOK_AHEAD );
+
+    gw->cameras[0].position = getPathPoint( b, t );
+    gw->cameras[0].target = (Vector3){ ahead.x, ahead.y - 3.0f, ahead.z };
+    gw->cameras[0].up = (Vector3){ 0.0f, 1.0f, 0.0f };
+
+}
+
+void recordBenchmark( Benchmark *b, GameWorld *gw ) {
+
+    if ( b->frame >= 0 && b->frame < b->frameQuantity ) {
+
+        // the present time overlaps the GPU work without measuring it; the
+        // GPU time only comes from the timer queries, read back below
+        float frameTime = GetTime() - gw->frameStartTime;
+
+        b->frames[b->frame] = (BenchmarkFrame){
+            .frameTime = frameTime,
+            .workTime = gw->workTime,
+            .presentTime = frameTime - gw->workTime,
+            .drawCalls = gw->renderQueue.drawCalls + gw->spheres.drawCalls + gw->stream.drawCalls + ( gw->impostors.count > 0 ? 1 : 0 ),
+            .triangleCount = gw->renderQueue.triangleCount + gw->spheres.triangleCount + gw->stream.count / 3 + gw->impostors.count * 2
+        };
+
+    }
+
+    // the GPU results arrive a few frames later
+    GpuTimer *gt = &gw->gpuTimer;
+    int gpuFrame = b->frame - getResultAgeGpuTimer( gt );
+
+    if ( gt->resultFrame >= 0 && gpuFrame >= 0 && gpuFrame < b->frameQuantity ) {
+        BenchmarkFrame *f = &b->frames[gpuFrame];
+        f->gpuMeasured = true;
+        f->gpuTime = gt->frameTime;
+        for ( int i = 0; i < GPU_TIMER_PASS_QUANTITY; i++ ) {
+            f->passTimes[i] = gt->passTimes[i];
+        }
+    }
+
+    b->frame++;
+
+}
+
+bool isFinishedBenchmark( Benchmark *b ) {
+    return b->frame >= b->frameQuantity;
+}
+
+bool writeReportBenchmark( Benchmark *b, const char *filePath ) {
+
+    int quantity = b->frame < b->frameQuantity ? b->frame : b->frameQuantity;
+
+    if ( quantity <= 0 ) {
+        TraceLog( LOG_WARNING, "BENCHMARK: No frames were measured" );
+        return false;
+    }
+
+    FILE *file = fopen( filePath, "w" );
+
+    if ( file == NULL ) {
+        TraceLog( LOG_WARNING, "BENCHMARK: Report %s could not be written", filePath );
+        return false;
+    }
+
+    float *frameTimes = (float*) malloc( quantity * sizeof( float ) );
+    float *workTimes = (float*) malloc( quantity * sizeof( float ) );
+    float *gpuTimes = (float*) malloc( quantity * sizeof( float ) );
+    double totalTime = 0.0;
+    double passTotals[GPU_TIMER_PASS_QUANTITY] = { 0 };
+    int gpuQuantity = 0;
+
+    for ( int i = 0; i < quantity; i++ ) {
+        BenchmarkFrame *f = &b->frames[i];
+        frameTimes[i] = f->frameTime;
+        workTimes[i] = f->workTime;
+        totalTime += f->frameTime;
+        if ( f->gpuMeasured ) {
+            gpuTimes[gpuQuantity++] = f->gpuTime;
+            for ( int j = 0; j < GPU_TIMER_PASS_QUANTITY; j++ ) {
+                passTotals[j] += f->passTimes[j];
+            }
+        }
+    }
+
+    qsort( frameTimes, quantity, sizeof( float ), compareFloats );
+    qsort( workTimes, quantity, sizeof( float ), compareFloats );
+    qsort( gpuTimes, gpuQuantity, sizeof( float ), compareFloats );
+
+    // compares the medians, the frame waits for the slowest of the two
+    const char *gpuSummary = "# gpu ms: not measured (no timer queries)";
+    if ( gpuQuantity > 0 ) {
+        int heaviest = 0;
+        double passesTotal = 0.0;
+        for ( int i = 0; i < GPU_TIMER_PASS_QUANTITY; i++ ) {
+            passesTotal += passTotals[i];
+            if ( passTotals[i] > passTotals[heaviest] ) {
+                heaviest = i;
+            }
+        }
+        float gpuMedian = getPercentile( gpuTimes, gpuQuantity, 0.5f );
+        gpuSummary = TextFormat( "# gpu ms: p50 %.2f, p95 %.2f, p99 %.2f, max %.2f; %s bound, heaviest pass %s (%.0f%%)",
+            gpuMedian * 1000.0f, getPercentile( gpuTimes, gpuQuantity, 0.95f ) * 1000.0f,
+            getPercentile( gpuTimes, gpuQuantity, 0.99f ) * 1000.0f, gpuTimes[gpuQuantity - 1] * 1000.0f,
+            gpuMedian > getPercentile( workTimes, quantity, 0.5f ) ? "GPU" : "CPU",
+            getGpuTimerPassName( heaviest ), passesTotal > 0.0 ? passTotals[heaviest] / passesTotal * 100.0 : 0.0 );
+    }
+
+    const char *summary[3] = {
+        TextFormat( "# frames: %d at %dx%d, average %.1f FPS", quantity, GetRenderWidth(), GetRenderHeight(), quantity / totalTime ),
+        TextFormat( "# frame ms: p50 %.2f, p95 %.2f, p99 %.2f, max %.2f; work ms: p50 %.2f, p95 %.2f, p99 %.2f, max %.2f",
+            getPercentile( frameTimes, quantity, 0.5f ) * 1000.0f, getPercentile( frameTimes, quantity, 0.95f ) * 1000.0f,
+            getPercentile( frameTimes, quantity, 0.99f ) * 1000.0f, frameTimes[quantity - 1] * 1000.0f,
+            getPercentile( workTimes, quantity, 0.5f ) * 1000.0f, getPercentile( workTimes, quantity, 0.95f ) * 1000.0f,
+            getPercentile( workTimes, quantity, 0.99f ) * 1000.0f, workTimes[quantity - 1] * 1000.0f ),
+        gpuSummary
+    };
+
+    for ( int i = 0; i < 3; i++ ) {
+        fprintf( file, "%s\n", summary[i] );
+        TraceLog( LOG_INFO, "BENCHMARK: %s", summary[i] + 2 );
+    }
+
+    fprintf( file, "frame,frame_ms,work_ms,present_ms,draw_calls,triangles,gpu_ms" );
+    for ( int i = 0; i < GPU_TIMER_PASS_QUANTITY; i++ ) {
+        fprintf( file, ",%s_ms", getGpuTimerPassName( i ) );
+    }
+    fprintf( file, "\n" );
+
+    // the GPU columns stay empty in the frames that weren't measured
+    for ( int i = 0; i < quantity; i++ ) {
+        BenchmarkFrame *f = &b->frames[i];
+        fprintf( file, "%d,%.3f,%.3f,%.3f,%d,%d,", i, f->frameTime * 1000.0f, f->workTime * 1000.0f, f->presentTime * 1000.0f, f->drawCalls, f->triangleCount );
+        if ( f->gpuMeasured ) {
+            fprintf( file, "%.3f", f->gpuTime * 1000.0f );
+        }
+        for ( int j = 0; j < GPU_TIMER_PASS_QUANTITY; j++ ) {
+            if ( f->gpuMeasured ) {
+                fprintf( file, ",%.3f", f->passTimes[j] * 1000.0f );
+            } else {
+                fprintf( file, "," );
+            }
+        }
+        fprintf( file, "\n" );
+    }
+
+    fclose( file );
+    free( frameTimes );
+    free( workTimes );
+    free( gpuTimes );
+
+    TraceLog( LOG_INFO, "BENCHMARK: Report written to %s", filePath );
+
+    return true;
+
+}
+
+// closed Catmull-Rom spline through the control points, t in [0, 1) is the whole loop
+static Vector3 getPathPoint( Benchmark *b, float t ) {
+
+    float s = ( t - floorf( t ) ) * BENCHMARK_PATH_POINTS;
+    int i = (int) s;
+    float u = s - i;
+
+    Vector3 p0 = b->path[( i + BENCHMARK_PATH_POINTS - 1 ) % BENCHMARK_PATH_POINTS];
+    Vector3 p1 = b->path[i % BENCHMARK_PATH_POINTS];
+    Vector3 p2 = b->path[( i + 1 ) % BENCHMARK_PATH_POINTS];
+    Vector3 p3 = b->path[( i + 2 ) % BENCHMARK_PATH_POINTS];
+
+    float u2 = u * u;
+    float u3 = u2 * u;
+
+    // 0.5 * ( 2p1 + ( p2 - p0 )u + ( 2p0 - 5p1 + 4p2 - p3 )u² + ( 3p1 - p0 - 3p2 + p3 )u³ )
+    Vector3 r = Vector3Scale( p1, 2.0f );
+    r = Vector3Add( r, Vector3Scale( Vector3Subtract( p2, p0 ), u ) );
+    r = Vector3Add( r, Vector3Scale( (Vector3){
+        2.0f * p0.x - 5.0f * p1.x + 4.0f * p2.x - p3.x,
+        2.0f * p0.y - 5.0f * p1.y + 4.0f * p2.y - p3.y,
+        2.0f * p0.z - 5.0f * p1.z + 4.0f * p2.z - p3.z }, u2 ) );
+    r = Vector3Add( r, Vector3Scale( (Vector3){
+        3.0f * p1.x - p0.x - 3.0f * p2.x + p3.x,
+        3.0f * p1.y - p0.y - 3.0f * p2.y + p3.y,
+        3.0f * p1.z - p0.z - 3.0f * p2.z + p3.z }, u3 ) );
+
+    return Vector3Scale( r, 0.5f );
+
+}
+
+static int compareFloats( const void *p1, const void *p2 ) {
+    float f1 = *( (const float*) p1 );
+    float f2 = *( (const float*) p2 );
+    return ( f1 > f2 ) - ( f1 < f2 );
+}
+
+static float getPercentile( float *sorted, int quantity, float percentile ) {
+    int i = (int) ( percentile * ( quantity - 1 ) + 0.5f );
+    return sorted[i];
+}
@@ -1,17 +1,25 @@
 #include "Block.h"
+#include "EntitySupport.h"
 #include "raylib/raylib.h"
+#include "raylib/raymath.h"
 
 void drawBlock( Block *block ) {
 
     if ( block->visible ) {
 
         if ( block->renderModel ) {
+            // the models are shared, so the lightmap is bound for each draw
+            if ( block->lightmap.id != 0 ) {
+                block->model.materials[0].maps[MATERIAL_MAP_METALNESS].texture = block->lightmap;
+            }
             if ( block->renderTouchColor ) {
                 DrawModel( block->model, block->pos, 1.0f, block->touchColor );
             } else {
                 DrawModel( block->model, block->pos, 1.0f, block->tintColor );
             }
-            DrawCubeWiresV( block->pos, block->dim, BLACK );
+            if ( !shaderOutlines ) {
+                DrawCubeWiresV( block->pos, block->dim, BLACK );
+            }
         } else {
             if ( block->renderTouchColor ) {
                 DrawCubeV( block->pos, block->dim, block->touchColor );
@@ -25,6 +33,37 @@ void drawBlock( Block *block ) {
 
 }
 
+void drawBlockMeshes( Block *block, RenderQueue *rq, StreamBuffer *sb, const bool *visible ) {
+
+    if ( !block->visible || !block->renderModel ) {
+        return;
+    }
+
+    Matrix transform = MatrixTranslate( block->pos.x, block->pos.y, block->pos.z );
+    Color tint = block->renderTouchColor ? block->touchColor : block->tintColor;
+    bool anyVisible = false;
+
+    for ( int i = 0; i < block->model.meshCount; i++ ) {
+
+        if ( visible != NULL && !visible[i] ) {
+            continue;
+        }
+
+        Mesh *mesh = &block->model.meshes[i];
+        BoundingBox bounds = GetMeshBoundingBox( *mesh );
+        Vector3 center = Vector3Add( block->pos, Vector3Scale( Vector3Add( bounds.min, bounds.max ), 0.5f ) );
+
+        addRenderQueue( rq, mesh, &block->model.materials[block->model.meshMaterial[i]], MatrixMultiply( block->model.transform, transform ), center, tint, block->lightmap, true );
+        anyVisible = true;
+
+    }
+
+    if ( anyVisible && !shaderOutlines ) {
+        addCubeWiresStreamBuffer( sb, block->pos, block->dim, BLACK );
+    }
+
+}
+
 BoundingBox getBlockBoundingBox( Block *block ) {
     return (BoundingBox){
         .min = {
@@ -7,6 +7,7 @@
 #include "Enemy.h"
 #include "Block.h"
 #include "Bullet.h"
+#include "SphereBatch.h"
 #include "raylib/raylib.h"
 
 Bullet createBullet( Vector3 pos, Color color, float radius ) {
@@ -26,6 +27,6 @@ Bullet createBullet( Vector3 pos, Color color, float radius ) {
 
 }
 
-void drawBullet( Bullet *bullet ) {
-    DrawSphere( bullet->pos, bullet->radius, bullet->color );
+void drawBullet( Bullet *bullet, SphereBatch *sb ) {
+    addSphereBatch( sb, bullet->pos, bullet->radius, bullet->color, 0.0f, SPHERE_BATCH_FLAG_NONE );
 }
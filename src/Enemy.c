@@ -7,8 +7,9 @@
 #include "Block.h"
 #include "Bullet.h"
 #include "Enemy.h"
-#include "ExplosionBillboard.h"
+#include "ParticleSystem.h"
 #include "ResourceManager.h"
+#include "SphereBatch.h"
 #include "raylib/raylib.h"
 #include "raylib/raymath.h"
 
@@ -97,13 +98,11 @@ Enemy createEnemy( Vector3 pos, Color color, Color eyeColor ) {
         case 2: enemy.deathSound = rm.enemyDeathSound03; break;
     }
 
-    enemy.eb = createExplosionBillboard( pos );
-
     return enemy;
 
 }
 
-void drawEnemy( Enemy *enemy ) {
+void drawEnemy( Enemy *enemy, SphereBatch *sb, RenderQueue *rq, EnemyLod lod ) {
 
     if ( enemy->state == ENEMY_STATE_ALIVE ) {
 
@@ -118,66 +117,80 @@ void drawEnemy( Enemy *enemy ) {
 
         if ( !enemy->showWiresOnly ) {
 
-            DrawModelEx( enemy->model, enemy->pos, enemy->rotationAxis, enemy->rotationHorizontalAngle, enemy->scale, enemy->color );
+            // without the outline in the middle distance
+            Matrix transform = getRenderTransform( enemy->pos, enemy->rotationAxis, enemy->rotationHorizontalAngle, enemy->scale );
+            addModelRenderQueue( rq, &enemy->model, transform, enemy->pos, enemy->color, (Texture2D){ 0 }, lod == ENEMY_LOD_FULL );
 
             float a = 45.0f;
 
-            DrawSphere(
+            addSphereBatch(
+                sb,
                 (Vector3){
                     .x = enemy->pos.x - cos( DEG2RAD * ( enemy->rotationHorizontalAngle + a ) ) * 1.0f,
                     .y = enemy->pos.y + 1.0f,
                     .z = enemy->pos.z + sin( DEG2RAD * ( enemy->rotationHorizontalAngle + a ) ) * 1.0f,
                 },
                 0.5f, 
-                enemy->eyeColor
+                enemy->eyeColor,
+                0.0f,
+                SPHERE_BATCH_FLAG_NONE
             );
 
-            DrawSphere(
+            addSphereBatch(
+                sb,
                 (Vector3){
                     .x = enemy->pos.x - cos( DEG2RAD * ( enemy->rotationHorizontalAngle - a ) ) * 1.0f,
                     .y = enemy->pos.y + 1.0f,
                     .z = enemy->pos.z + sin( DEG2RAD * ( enemy->rotationHorizontalAngle - a ) ) * 1.0f,
                 },
                 0.5f, 
-                enemy->eyeColor
+                enemy->eyeColor,
+                0.0f,
+                SPHERE_BATCH_FLAG_NONE
             );
 
         }
 
-        int collidedBullets = enemy->collidedBulletCount < enemy->maxCollidedBullets ? enemy->collidedBulletCount : enemy->maxCollidedBullets;
-        for ( int i = 0; i < collidedBullets; i++ ) {
-            drawBullet( &enemy->collidedBullets[i] );
+        if ( lod == ENEMY_LOD_FULL ) {
+            int collidedBullets = enemy->collidedBulletCount < enemy->maxCollidedBullets ? enemy->collidedBulletCount : enemy->maxCollidedBullets;
+            for ( int i = 0; i < collidedBullets; i++ ) {
+                drawBullet( &enemy->collidedBullets[i], sb );
+            }
         }
 
-        DrawModelWiresEx( enemy->model, enemy->pos, enemy->rotationAxis, enemy->rotationHorizontalAngle, enemy->scale, BLACK );
+        if ( enemy->showWiresOnly || ( lod == ENEMY_LOD_FULL && !shaderOutlines ) ) {
+            DrawModelWiresEx( enemy->model, enemy->pos, enemy->rotationAxis, enemy->rotationHorizontalAngle, enemy->scale, BLACK );
+        }
 
     }
 
 }
 
-void drawEnemyExplosionBillboard( Enemy *enemy, Camera3D camera ) {
-    if ( enemy->state == ENEMY_STATE_DYING ) {
-        drawExplosionBillboard( &enemy->eb, camera );
+EnemyLod getEnemyLod( Enemy *enemy, Camera3D camera, int viewportHeight ) {
+
+    float distance = Vector3Distance( enemy->pos, camera.position );
+
+    if ( distance <= 0.0f ) {
+        return ENEMY_LOD_FULL;
     }
-}
 
-void drawEnemyHpBar( Enemy *enemy, Camera3D camera ) {
+    float pixels = enemy->dim.y * viewportHeight / ( 2.0f * distance * tanf( camera.fovy * 0.5f * DEG2RAD ) );
 
-    if ( enemy->showHpBar && enemy->state == ENEMY_STATE_ALIVE && enemy->detectedByPlayer ) {
+    if ( pixels >= ENEMY_LOD_FULL_PIXELS ) {
+        return ENEMY_LOD_FULL;
+    } else if ( pixels >= ENEMY_LOD_MEDIUM_PIXELS ) {
+        return ENEMY_LOD_MEDIUM;
+    }
 
-        float distance = Vector3Distance( enemy->pos, camera.position );
-        float barWidth = 1200.0f / distance;
-        int barHeight = (int) ( 200.f / distance );
+    return ENEMY_LOD_IMPOSTOR;
 
-        Vector3 p = enemy->pos;
-        p.x += cos( DEG2RAD * ( enemy->rotationHorizontalAngle + 180 ) ) * enemy->dim.x / 2;
-        p.y += enemy->dim.y - 0.5f;
-        p.z += -sin( DEG2RAD * ( enemy->rotationHorizontalAngle + 180 ) ) * enemy->dim.z / 2;
+}
 
-        Vector2 v = GetWorldToScreen( p, camera );
-        DrawRectangle( v.x - barWidth / 2, v.y - barHeight / 2, (int) (barWidth * enemy->currentHp / enemy->maxHp), barHeight, RED );
-        DrawRectangleLines( v.x - barWidth / 2, v.y - barHeight / 2, barWidth, barHeight, BLACK );
+void addEnemyHpBar( Enemy *enemy, HpBarBatch *hb ) {
 
+    if ( enemy->showHpBar && enemy->state == ENEMY_STATE_ALIVE && enemy->detectedByPlayer ) {
+        Vector3 anchor = { enemy->pos.x, enemy->pos.y + enemy->dim.y - 0.5f, enemy->pos.z };
+        addHpBarBatch( hb, anchor, (float) enemy->currentHp / enemy->maxHp );
     }
 
 }
@@ -223,11 +236,12 @@ void updateEnemy( Enemy *enemy, Player *player, GameWorld *gw, float delta ) {
             bullet->pos.y = enemy->pos.y - ( sin( DEG2RAD * ( bullet->vAngle ) ) * bullet->vDistance );
         }
 
-        enemy->eb.pos.y = enemy->pos.y + 0.5f;
-
     } else if ( enemy->state == ENEMY_STATE_DYING ) {
-        updateExplosionBillboard( &enemy->eb, delta );
-        if ( enemy->eb.finished ) {
+        if ( enemy->dyingTimeCounter == 0.0f ) {
+            emitExplosionParticles( &gw->particles, (Vector3){ enemy->pos.x, enemy->pos.y + 0.5f, enemy->pos.z } );
+        }
+        enemy->dyingTimeCounter += delta;
+        if ( enemy->dyingTimeCounter >= PARTICLE_EXPLOSION_DURATION ) {
             enemy->state = ENEMY_STATE_DEAD;
             cleanDeadEnemies( gw );
         }
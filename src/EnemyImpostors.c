@@ -0,0 +1,182 @@
+/**
+ * @file EnemyImpostors.c
+ * @author Prof. Dr. David Buzatto
+ * @brief EnemyImpostors implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "GameWorld.h"
+#include "EnemyImpostors.h"
+#include "Enemy.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+static const float VIEW_DISTANCE = 10.0f;
+
+// the eyes stick out of the top of the cube
+static const float SIZE_MARGIN = 1.6f;
+
+void initEnemyImpostors( EnemyImpostors *ei, Shader shader ) {
+
+    *ei = (EnemyImpostors){
+        .initialized = true,
+        .shader = shader,
+        .capacity = 64
+    };
+
+    ei->impostors = (EnemyImpostor*) malloc( ei->capacity * sizeof( EnemyImpostor ) );
+
+}
+
+void destroyEnemyImpostors( EnemyImpostors *ei ) {
+
+    if ( !ei->initialized ) {
+        return;
+    }
+
+    if ( ei->atlas.id != 0 ) {
+        UnloadRenderTexture( ei->atlas );
+    }
+
+    free( ei->impostors );
+
+    *ei = (EnemyImpostors){ 0 };
+
+}
+
+void bakeEnemyImpostors( EnemyImpostors *ei, Enemy *enemy ) {
+
+    if ( ei->atlas.id == 0 ) {
+        ei->atlas = LoadRenderTexture( ENEMY_IMPOSTOR_FRAME_SIZE * ENEMY_IMPOSTOR_VIEWS, ENEMY_IMPOSTOR_FRAME_SIZE );
+        SetTextureFilter( ei->atlas.texture, TEXTURE_FILTER_BILINEAR );
+    }
+
+    float half = fmaxf( enemy->dim.x, enemy->dim.y ) / 2 * SIZE_MARGIN;
+    ei->size = half * 2;
+
+    // the views are unlit, the light shader needs the light clusters
+    Material *material = &enemy->model.materials[0];
+    Shader shader = material->shader;
+    material->shader = (Shader){ rlGetShaderIdDefault(), rlGetShaderLocsDefault() };
+
+    BeginTextureMode( ei->atlas );
+    ClearBackground( BLANK );
+    rlEnableDepthTest();
+
+    for ( int i = 0; i < ENEMY_IMPOSTOR_VIEWS; i++ ) {
+
+        float angle = i * 2.0f * PI / ENEMY_IMPOSTOR_VIEWS;
+        Vector3 eye = { cosf( angle ) * VIEW_DISTANCE, 0.0f, -sinf( angle ) * VIEW_DISTANCE };
+
+        rlViewport( i * ENEMY_IMPOSTOR_FRAME_SIZE, 0, ENEMY_IMPOSTOR_FRAME_SIZE, ENEMY_IMPOSTOR_FRAME_SIZE );
+
+        rlMatrixMode( RL_PROJECTION );
+        rlPushMatrix();
+        rlLoadIdentity();
+        rlOrtho( -half, half, -half, half, 0.1, VIEW_DISTANCE * 2 );
+
+        rlMatrixMode( RL_MODELVIEW );
+        rlLoadIdentity();
+        rlMultMatrixf( MatrixToFloat( MatrixLookAt( eye, Vector3Zero(), (Vector3){ 0.0f, 1.0f, 0.0f } ) ) );
+
+        // the enemy at the origin, not rotated, with the eyes of drawEnemy
+        DrawModelEx( enemy->model, Vector3Zero(), enemy->rotationAxis, 0.0f, enemy->scale, enemy->color );
+
+        float a = 45.0f;
+        DrawSphere( (Vector3){ -cosf( DEG2RAD * a ), 1.0f, sinf( DEG2RAD * a ) }, 0.5f, enemy->eyeColor );
+        DrawSphere( (Vector3){ -cosf( DEG2RAD * -a ), 1.0f, sinf( DEG2RAD * -a ) }, 0.5f, enemy->eyeColor );
+
+        rlDrawRenderBatchActive();
+
+        rlMatrixMode( RL_PROJECTION );
+        rlPopMatrix();
+        rlMatrixMode( RL_MODELVIEW );
+
+    }
+
+    rlDisableDepthTest();
+    EndTextureMode();
+
+    material->shader = shader;
+
+}
+
+void beginEnemyImpostors( EnemyImpostors *ei ) {
+    ei->count = 0;
+}
+
+void addEnemyImpostor( EnemyImpostors *ei, Enemy *enemy ) {
+
+    if ( ei->count == ei->capacity ) {
+        ei->capacity *= 2;
+        ei->impostors = (EnemyImpostor*) realloc( ei->impostors, ei->capacity * sizeof( EnemyImpostor ) );
+    }
+
+    ei->impostors[ei->count++] = (EnemyImpostor){
+        .pos = enemy->pos,
+        .angle = enemy->rotationHorizontalAngle
+    };
+
+}
+
+void drawEnemyImpostors( EnemyImpostors *ei, Camera3D camera ) {
+
+    if ( ei->count == 0 || ei->atlas.id == 0 ) {
+        return;
+    }
+
+    float half = ei->size / 2;
+    float frameWidth = 1.0f / ENEMY_IMPOSTOR_VIEWS;
+
+    BeginShaderMode( ei->shader );
+    rlSetTexture( ei->atlas.texture.id );
+    rlBegin( RL_QUADS );
+
+    for ( int i = 0; i < ei->count; i++ ) {
+
+        EnemyImpostor *p = &ei->impostors[i];
+
+        // horizontal direction to the camera, in world space and in the
+        // space of the enemy, where the views were rendered
+        Vector3 toCamera = { camera.position.x - p->pos.x, 0.0f, camera.position.z - p->pos.z };
+        float length = Vector3Length( toCamera );
+        toCamera = length > 0.0f ? Vector3Scale( toCamera, 1.0f / length ) : (Vector3){ 1.0f, 0.0f, 0.0f };
+
+        float viewAngle = atan2f( -toCamera.z, toCamera.x ) * RAD2DEG - p->angle;
+        int frame = (int) floorf( viewAngle / ( 360.0f / ENEMY_IMPOSTOR_VIEWS ) + 0.5f ) % ENEMY_IMPOSTOR_VIEWS;
+        frame = frame < 0 ? frame + ENEMY_IMPOSTOR_VIEWS : frame;
+
+        Vector3 right = Vector3Scale( (Vector3){ toCamera.z, 0.0f, -toCamera.x }, half );
+
+        Vector3 bottomLeft = { p->pos.x - right.x, p->pos.y - half, p->pos.z - right.z };
+        Vector3 bottomRight = { p->pos.x + right.x, p->pos.y - half, p->pos.z + right.z };
+        Vector3 topRight = { p->pos.x + right.x, p->pos.y + half, p->pos.z + right.z };
+        Vector3 topLeft = { p->pos.x - right.x, p->pos.y + half, p->pos.z - right.z };
+
+        float u0 = frame * frameWidth;
+        float u1 = u0 + frameWidth;
+
+        rlColor4ub( 255, 255, 255, 255 );
+
+        // render textures are upside down
+        rlTexCoord2f( u0, 0.0f );
+        rlVertex3f( bottomLeft.x, bottomLeft.y, bottomLeft.z );
+        rlTexCoord2f( u1, 0.0f );
+        rlVertex3f( bottomRight.x, bottomRight.y, bottomRight.z );
+        rlTexCoord2f( u1, 1.0f );
+        rlVertex3f( topRight.x, topRight.y, topRight.z );
+        rlTexCoord2f( u0, 1.0f );
+        rlVertex3f( topLeft.x, topLeft.y, topLeft.z );
+
+    }
+
+    rlEnd();
+    rlSetTexture( 0 );
+    EndShaderMode();
+
+}
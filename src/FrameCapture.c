@@ -0,0 +1,370 @@
+/**
+ * @file FrameCapture.c
+ * @author Prof. Dr. David Buzatto
+ * @brief FrameCapture implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L     // popen and pclose
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include "FrameCapture.h"
+#include "GlFunctions.h"
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#define PIPE_MODE "wb"
+#else
+#define PIPE_MODE "w"
+#endif
+
+#define PIXEL_PACK_BUFFER 0x88EB            // GL_PIXEL_PACK_BUFFER
+#define STREAM_READ 0x88E1                  // GL_STREAM_READ
+#define MAP_READ_BIT 0x0001                 // GL_MAP_READ_BIT
+#define RGBA 0x1908                         // GL_RGBA
+#define UNSIGNED_BYTE 0x1401                // GL_UNSIGNED_BYTE
+#define SYNC_GPU_COMMANDS_COMPLETE 0x9117   // GL_SYNC_GPU_COMMANDS_COMPLETE
+#define SYNC_FLUSH_COMMANDS_BIT 0x0001      // GL_SYNC_FLUSH_COMMANDS_BIT
+#define WAIT_FAILED 0x911D                  // GL_WAIT_FAILED
+
+// how long to wait for a copy that isn't finished yet, in nanoseconds
+#define FENCE_TIMEOUT 1000000000ull
+
+static bool isReadbackAvailable( void );
+static void readSlot( FrameCapture *fc, int slot );
+static bool writeFrame( FrameCapture *fc, Image *image, int frameNumber );
+static void *runFrameCaptureWorker( void *data );
+
+bool startFrameCapture( FrameCapture *fc, FrameCaptureFormat format, int targetFPS ) {
+
+    if ( fc->recording ) {
+        return true;
+    }
+
+    if ( !isReadbackAvailable() ) {
+        TraceLog( LOG_WARNING, "CAPTURE: Asynchronous readback not available, the frames can't be recorded" );
+        return false;
+    }
+
+    if ( format == FRAME_CAPTURE_FORMAT_ENCODER && targetFPS <= 0 ) {
+        TraceLog( LOG_WARNING, "CAPTURE: The encoder needs a target FPS, the frames can't be recorded" );
+        return false;
+    }
+
+    *fc = (FrameCapture){
+        .format = format,
+        .width = GetRenderWidth(),
+        .height = GetRenderHeight()
+    };
+
+    switch ( format ) {
+        case FRAME_CAPTURE_FORMAT_RAW:
+            fc->output = fopen( FRAME_CAPTURE_FILE_NAME ".rgba", "wb" );
+            break;
+        case FRAME_CAPTURE_FORMAT_ENCODER:
+#ifndef _WIN32
+            // if ffmpeg exits the writes fail instead of killing the game
+            signal( SIGPIPE, SIG_IGN );
+#endif
+            // yuv420p needs an even size, odd windows get one black column or row
+            fc->output = popen( TextFormat( "ffmpeg -y -loglevel error -f rawvideo -pixel_format rgba -video_size %dx%d -framerate %d -i - "
+                                            "-vf \"pad=ceil(iw/2)*2:ceil(ih/2)*2\" -pix_fmt yuv420p %s.mp4",
+                                            fc->width, fc->height, targetFPS, FRAME_CAPTURE_FILE_NAME ), PIPE_MODE );
+            break;
+        default:
+            break;
+    }
+
+    if ( format != FRAME_CAPTURE_FORMAT_PNG && fc->output == NULL ) {
+        TraceLog( LOG_WARNING, "CAPTURE: Output for the %s format could not be opened", getFrameCaptureFormatName( format ) );
+        return false;
+    }
+
+    pthread_mutex_init( &fc->mutex, NULL );
+    pthread_cond_init( &fc->frameAvailable, NULL );
+
+    // encoding in the main thread would stall the frames, so there's no fallback
+    fc->workerRunning = true;
+    if ( pthread_create( &fc->worker, NULL, runFrameCaptureWorker, fc ) != 0 ) {
+        TraceLog( LOG_WARNING, "CAPTURE: Worker thread not available, the frames can't be recorded" );
+        pthread_mutex_destroy( &fc->mutex );
+        pthread_cond_destroy( &fc->frameAvailable );
+        if ( fc->output != NULL ) {
+            if ( format == FRAME_CAPTURE_FORMAT_ENCODER ) {
+                pclose( fc->output );
+            } else {
+                fclose( fc->output );
+            }
+        }
+        *fc = (FrameCapture){ 0 };
+        return false;
+    }
+
+#ifndef __EMSCRIPTEN__
+    glad_glGenBuffers( FRAME_CAPTURE_SLOTS, fc->pixelBuffers );
+    for ( int i = 0; i < FRAME_CAPTURE_SLOTS; i++ ) {
+        glad_glBindBuffer( PIXEL_PACK_BUFFER, fc->pixelBuffers[i] );
+        glad_glBufferData( PIXEL_PACK_BUFFER, (ptrdiff_t) fc->width * fc->height * 4, NULL, STREAM_READ );
+    }
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, 0 );
+#endif
+
+    fc->recording = true;
+    TraceLog( LOG_INFO, "CAPTURE: Recording %dx%d frames (%s)", fc->width, fc->height, getFrameCaptureFormatName( format ) );
+
+    return true;
+
+}
+
+void stopFrameCapture( FrameCapture *fc ) {
+
+    if ( !fc->recording ) {
+        return;
+    }
+
+    // the frames still in the ring, from the oldest
+    for ( int i = 0; i < FRAME_CAPTURE_SLOTS; i++ ) {
+        int slot = ( fc->slot + i ) % FRAME_CAPTURE_SLOTS;
+        if ( fc->fences[slot] != NULL ) {
+            readSlot( fc, slot );
+        }
+    }
+
+    // the worker empties the queue before leaving
+    pthread_mutex_lock( &fc->mutex );
+    fc->workerRunning = false;
+    pthread_cond_broadcast( &fc->frameAvailable );
+    pthread_mutex_unlock( &fc->mutex );
+    pthread_join( fc->worker, NULL );
+
+    int encodedFrames = getEncodedFramesFrameCapture( fc );
+    pthread_mutex_destroy( &fc->mutex );
+    pthread_cond_destroy( &fc->frameAvailable );
+
+    if ( fc->output != NULL ) {
+        if ( fc->format == FRAME_CAPTURE_FORMAT_ENCODER ) {
+            pclose( fc->output );
+        } else {
+            fclose( fc->output );
+        }
+        fc->output = NULL;
+    }
+
+#ifndef __EMSCRIPTEN__
+    glad_glDeleteBuffers( FRAME_CAPTURE_SLOTS, fc->pixelBuffers );
+#endif
+
+    fc->recording = false;
+    TraceLog( LOG_INFO, "CAPTURE: %d frames recorded, %d dropped", encodedFrames, fc->droppedFrames );
+
+}
+
+void captureFrameCapture( FrameCapture *fc ) {
+
+    if ( !fc->recording ) {
+        return;
+    }
+
+    if ( GetRenderWidth() != fc->width || GetRenderHeight() != fc->height ) {
+        TraceLog( LOG_WARNING, "CAPTURE: The window was resized, recording stopped" );
+        stopFrameCapture( fc );
+        return;
+    }
+
+    pthread_mutex_lock( &fc->mutex );
+    bool writeFailed = fc->writeFailed;
+    pthread_mutex_unlock( &fc->mutex );
+
+    if ( writeFailed ) {
+        TraceLog( LOG_WARNING, "CAPTURE: Failed to write the frames to the %s output, recording stopped", getFrameCaptureFormatName( fc->format ) );
+        stopFrameCapture( fc );
+        return;
+    }
+
+    // this slot was copied FRAME_CAPTURE_SLOTS frames ago, the GPU is done with it
+    if ( fc->fences[fc->slot] != NULL ) {
+        readSlot( fc, fc->slot );
+    }
+
+    rlDrawRenderBatchActive();
+
+#ifndef __EMSCRIPTEN__
+    // the copy goes to the buffer on the GPU, nothing waits here
+    rlBindFramebuffer( RL_READ_FRAMEBUFFER, 0 );
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, fc->pixelBuffers[fc->slot] );
+    glad_glReadPixels( 0, 0, fc->width, fc->height, RGBA, UNSIGNED_BYTE, NULL );
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, 0 );
+    fc->fences[fc->slot] = glad_glFenceSync( SYNC_GPU_COMMANDS_COMPLETE, 0 );
+#endif
+
+    fc->slot = ( fc->slot + 1 ) % FRAME_CAPTURE_SLOTS;
+    fc->capturedFrames++;
+
+}
+
+int getEncodedFramesFrameCapture( FrameCapture *fc ) {
+
+    pthread_mutex_lock( &fc->mutex );
+    int encodedFrames = fc->encodedFrames;
+    pthread_mutex_unlock( &fc->mutex );
+
+    return encodedFrames;
+
+}
+
+const char *getFrameCaptureFormatName( FrameCaptureFormat format ) {
+
+    switch ( format ) {
+        case FRAME_CAPTURE_FORMAT_RAW: return "raw";
+        case FRAME_CAPTURE_FORMAT_PNG: return "png";
+        case FRAME_CAPTURE_FORMAT_ENCODER: return "ffmpeg";
+        default: return "unknown";
+    }
+
+}
+
+static bool isReadbackAvailable( void ) {
+
+#ifndef __EMSCRIPTEN__
+    int version = rlGetVersion();
+
+    return ( version == RL_OPENGL_33 || version == RL_OPENGL_43 ) &&
+           glad_glGenBuffers != NULL && glad_glBindBuffer != NULL && glad_glBufferData != NULL &&
+           glad_glMapBufferRange != NULL && glad_glUnmapBuffer != NULL && glad_glReadPixels != NULL &&
+           glad_glFenceSync != NULL && glad_glClientWaitSync != NULL && glad_glDeleteSync != NULL;
+#else
+    return false;
+#endif
+
+}
+
+// the mapping belongs to the GL thread, so the pixels are copied to an
+// image the worker can keep
+static void readSlot( FrameCapture *fc, int slot ) {
+
+    Image image = {
+        .width = fc->width,
+        .height = fc->height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+    };
+
+#ifndef __EMSCRIPTEN__
+    // usually signalled long ago, the wait only happens when the GPU is far behind
+    if ( glad_glClientWaitSync( fc->fences[slot], SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT ) == WAIT_FAILED ) {
+        TraceLog( LOG_WARNING, "CAPTURE: Failed to wait for the copy of slot %d", slot );
+    }
+    glad_glDeleteSync( fc->fences[slot] );
+    fc->fences[slot] = NULL;
+
+    size_t size = (size_t) fc->width * fc->height * 4;
+
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, fc->pixelBuffers[slot] );
+    void *pixels = glad_glMapBufferRange( PIXEL_PACK_BUFFER, 0, (ptrdiff_t) size, MAP_READ_BIT );
+
+    if ( pixels != NULL ) {
+        image.data = malloc( size );
+        memcpy( image.data, pixels, size );
+        glad_glUnmapBuffer( PIXEL_PACK_BUFFER );
+    }
+
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, 0 );
+#else
+    (void) slot;
+#endif
+
+    if ( image.data == NULL ) {
+        fc->droppedFrames++;
+        return;
+    }
+
+    pthread_mutex_lock( &fc->mutex );
+
+    if ( fc->queueCount == FRAME_CAPTURE_QUEUE_CAPACITY ) {
+        fc->droppedFrames++;
+        UnloadImage( image );
+    } else {
+        fc->queue[( fc->queueStart + fc->queueCount ) % FRAME_CAPTURE_QUEUE_CAPACITY] = image;
+        fc->queueCount++;
+        pthread_cond_signal( &fc->frameAvailable );
+    }
+
+    pthread_mutex_unlock( &fc->mutex );
+
+}
+
+// runs in the worker thread, so it can't use TextFormat
+static bool writeFrame( FrameCapture *fc, Image *image, int frameNumber ) {
+
+    // glReadPixels returns the rows bottom up
+    ImageFlipVertical( image );
+
+    if ( fc->format == FRAME_CAPTURE_FORMAT_PNG ) {
+        char fileName[64];
+        snprintf( fileName, sizeof( fileName ), "%s_%05d.png", FRAME_CAPTURE_FILE_NAME, frameNumber );
+        return ExportImage( *image, fileName );
+    }
+
+    size_t pixelQuantity = (size_t) image->width * image->height;
+
+    return fwrite( image->data, 4, pixelQuantity, fc->output ) == pixelQuantity && !ferror( fc->output );
+
+}
+
+static void *runFrameCaptureWorker( void *data ) {
+
+    FrameCapture *fc = (FrameCapture*) data;
+
+    pthread_mutex_lock( &fc->mutex );
+
+    while ( true ) {
+
+        while ( fc->workerRunning && fc->queueCount == 0 ) {
+            pthread_cond_wait( &fc->frameAvailable, &fc->mutex );
+        }
+
+        if ( fc->queueCount == 0 ) {
+            break;
+        }
+
+        Image image = fc->queue[fc->queueStart];
+        int frameNumber = fc->encodedFrames;
+        fc->queueStart = ( fc->queueStart + 1 ) % FRAME_CAPTURE_QUEUE_CAPACITY;
+        fc->queueCount--;
+
+        // after a failed write the queue is only emptied, the main thread
+        // stops the recording on its next capture
+        bool written = false;
+        bool writeFailed = fc->writeFailed;
+
+        pthread_mutex_unlock( &fc->mutex );
+        if ( !writeFailed ) {
+            written = writeFrame( fc, &image, frameNumber );
+        }
+        UnloadImage( image );
+        pthread_mutex_lock( &fc->mutex );
+
+        if ( written ) {
+            fc->encodedFrames++;
+        } else {
+            fc->writeFailed = true;
+        }
+
+    }
+
+    pthread_mutex_unlock( &fc->mutex );
+
+    return NULL;
+
+}
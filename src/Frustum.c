@@ -0,0 +1,250 @@
+/**
+ * @file Frustum.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Frustum and FrustumCuller implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "Frustum.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define FRUSTUM_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+static Vector4 normalizePlane( float x, float y, float z, float w );
+
+Frustum createFrustumFromCamera( Camera3D camera, float aspect ) {
+    return createFrustumFromMatrix( getViewProjectionFromCamera( camera, aspect ) );
+}
+
+Matrix getViewProjectionFromCamera( Camera3D camera, float aspect ) {
+
+    double nearPlane = rlGetCullDistanceNear();
+    double farPlane = rlGetCullDistanceFar();
+
+    Matrix view = MatrixLookAt( camera.position, camera.target, camera.up );
+    Matrix projection;
+
+    if ( camera.projection == CAMERA_PERSPECTIVE ) {
+        projection = MatrixPerspective( camera.fovy * DEG2RAD, aspect, nearPlane, farPlane );
+    } else {
+        double top = camera.fovy / 2.0;
+        double right = top * aspect;
+        projection = MatrixOrtho( -right, right, -top, top, nearPlane, farPlane );
+    }
+
+    return MatrixMultiply( view, projection );
+
+}
+
+// Gribb/Hartmann: each plane is the sum or the difference of the fourth
+// row of the matrix with one of the other three
+Frustum createFrustumFromMatrix( Matrix m ) {
+
+    Frustum frustum;
+
+    frustum.planes[FRUSTUM_PLANE_LEFT]   = normalizePlane( m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8,  m.m15 + m.m12 );
+    frustum.planes[FRUSTUM_PLANE_RIGHT]  = normalizePlane( m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8,  m.m15 - m.m12 );
+    frustum.planes[FRUSTUM_PLANE_BOTTOM] = normalizePlane( m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9,  m.m15 + m.m13 );
+    frustum.planes[FRUSTUM_PLANE_TOP]    = normalizePlane( m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9,  m.m15 - m.m13 );
+    frustum.planes[FRUSTUM_PLANE_NEAR]   = normalizePlane( m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14 );
+    frustum.planes[FRUSTUM_PLANE_FAR]    = normalizePlane( m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14 );
+
+    return frustum;
+
+}
+
+bool isBoxInsideFrustum( Frustum *frustum, BoundingBox box ) {
+
+    Vector3 c = Vector3Scale( Vector3Add( box.min, box.max ), 0.5f );
+    Vector3 e = Vector3Scale( Vector3Subtract( box.max, box.min ), 0.5f );
+
+    for ( int i = 0; i < FRUSTUM_PLANE_QUANTITY; i++ ) {
+        Vector4 p = frustum->planes[i];
+        float d = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+        float r = fabsf( p.x ) * e.x + fabsf( p.y ) * e.y + fabsf( p.z ) * e.z;
+        if ( d + r < 0.0f ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+void resetFrustumCuller( FrustumCuller *fc ) {
+    fc->count = 0;
+}
+
+void destroyFrustumCuller( FrustumCuller *fc ) {
+    free( fc->centerX );
+    free( fc->centerY );
+    free( fc->centerZ );
+    free( fc->extentX );
+    free( fc->extentY );
+    free( fc->extentZ );
+    free( fc->visible );
+    *fc = (FrustumCuller){ 0 };
+}
+
+int addBoxFrustumCuller( FrustumCuller *fc, BoundingBox box ) {
+
+    if ( fc->count == fc->capacity ) {
+
+        // always a multiple of four, so the last group can be loaded whole
+        int capacity = fc->capacity == 0 ? 64 : fc->capacity * 2;
+
+        fc->centerX = (float*) realloc( fc->centerX, capacity * sizeof( float ) );
+        fc->centerY = (float*) realloc( fc->centerY, capacity * sizeof( float ) );
+        fc->centerZ = (float*) realloc( fc->centerZ, capacity * sizeof( float ) );
+        fc->extentX = (float*) realloc( fc->extentX, capacity * sizeof( float ) );
+        fc->extentY = (float*) realloc( fc->extentY, capacity * sizeof( float ) );
+        fc->extentZ = (float*) realloc( fc->extentZ, capacity * sizeof( float ) );
+        fc->visible = (bool*) realloc( fc->visible, capacity * sizeof( bool ) );
+
+        for ( int i = fc->capacity; i < capacity; i++ ) {
+            fc->centerX[i] = fc->centerY[i] = fc->centerZ[i] = 0.0f;
+            fc->extentX[i] = fc->extentY[i] = fc->extentZ[i] = 0.0f;
+        }
+
+        fc->capacity = capacity;
+
+    }
+
+    int i = fc->count++;
+
+    fc->centerX[i] = ( box.min.x + box.max.x ) * 0.5f;
+    fc->centerY[i] = ( box.min.y + box.max.y ) * 0.5f;
+    fc->centerZ[i] = ( box.min.z + box.max.z ) * 0.5f;
+    fc->extentX[i] = ( box.max.x - box.min.x ) * 0.5f;
+    fc->extentY[i] = ( box.max.y - box.min.y ) * 0.5f;
+    fc->extentZ[i] = ( box.max.z - box.min.z ) * 0.5f;
+    fc->visible[i] = true;
+
+    return i;
+
+}
+
+// a box is outside when, for some plane, its center is farther behind the
+// plane than the projection of its half extents on the plane normal
+int cullFrustumCuller( FrustumCuller *fc, Frustum *frustum ) {
+
+    int culled = 0;
+
+#ifdef FRUSTUM_USE_SSE
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signMask = _mm_set1_ps( -0.0f );
+
+    __m128 px[FRUSTUM_PLANE_QUANTITY];
+    __m128 py[FRUSTUM_PLANE_QUANTITY];
+    __m128 pz[FRUSTUM_PLANE_QUANTITY];
+    __m128 pw[FRUSTUM_PLANE_QUANTITY];
+
+    for ( int p = 0; p < FRUSTUM_PLANE_QUANTITY; p++ ) {
+        px[p] = _mm_set1_ps( frustum->planes[p].x );
+        py[p] = _mm_set1_ps( frustum->planes[p].y );
+        pz[p] = _mm_set1_ps( frustum->planes[p].z );
+        pw[p] = _mm_set1_ps( frustum->planes[p].w );
+    }
+
+    for ( int i = 0; i < fc->count; i += 4 ) {
+
+        __m128 cx = _mm_loadu_ps( fc->centerX + i );
+        __m128 cy = _mm_loadu_ps( fc->centerY + i );
+        __m128 cz = _mm_loadu_ps( fc->centerZ + i );
+        __m128 ex = _mm_loadu_ps( fc->extentX + i );
+        __m128 ey = _mm_loadu_ps( fc->extentY + i );
+        __m128 ez = _mm_loadu_ps( fc->extentZ + i );
+
+        __m128 outside = zero;
+
+        for ( int p = 0; p < FRUSTUM_PLANE_QUANTITY; p++ ) {
+
+            __m128 d = _mm_add_ps(
+                _mm_add_ps( _mm_mul_ps( px[p], cx ), _mm_mul_ps( py[p], cy ) ),
+                _mm_add_ps( _mm_mul_ps( pz[p], cz ), pw[p] )
+            );
+
+            __m128 r = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps( _mm_andnot_ps( signMask, px[p] ), ex ),
+                    _mm_mul_ps( _mm_andnot_ps( signMask, py[p] ), ey )
+                ),
+                _mm_mul_ps( _mm_andnot_ps( signMask, pz[p] ), ez )
+            );
+
+            outside = _mm_or_ps( outside, _mm_cmplt_ps( _mm_add_ps( d, r ), zero ) );
+
+        }
+
+        int mask = _mm_movemask_ps( outside );
+
+        for ( int k = 0; k < 4 && i + k < fc->count; k++ ) {
+            fc->visible[i + k] = ( mask & ( 1 << k ) ) == 0;
+            if ( !fc->visible[i + k] ) {
+                culled++;
+            }
+        }
+
+    }
+
+#else
+
+    for ( int i = 0; i < fc->count; i++ ) {
+
+        bool visible = true;
+
+        for ( int p = 0; p < FRUSTUM_PLANE_QUANTITY && visible; p++ ) {
+            Vector4 pl = frustum->planes[p];
+            float d = pl.x * fc->centerX[i] + pl.y * fc->centerY[i] + pl.z * fc->centerZ[i] + pl.w;
+            float r = fabsf( pl.x ) * fc->extentX[i] + fabsf( pl.y ) * fc->extentY[i] + fabsf( pl.z ) * fc->extentZ[i];
+            visible = d + r >= 0.0f;
+        }
+
+        fc->visible[i] = visible;
+        if ( !visible ) {
+            culled++;
+        }
+
+    }
+
+#endif
+
+    return culled;
+
+}
+
+int countVisibleFrustumCuller( FrustumCuller *fc, int start, int count ) {
+
+    int visible = 0;
+
+    for ( int i = start; i < start + count; i++ ) {
+        if ( fc->visible[i] ) {
+            visible++;
+        }
+    }
+
+    return visible;
+
+}
+
+static Vector4 normalizePlane( float x, float y, float z, float w ) {
+
+    float length = sqrtf( x * x + y * y + z * z );
+
+    if ( length == 0.0f ) {
+        return (Vector4){ x, y, z, w };
+    }
+
+    return (Vector4){ x / length, y / length, z / length, w / length };
+
+}
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "Benchmark.h"
 #include "GameWindow.h"
 #include "GameWorld.h"
 #include "ResourceManager.h"
@@ -44,6 +45,7 @@ GameWindow* createGameWindow(
     gameWindow->alwaysRun = alwaysRun;
     gameWindow->loadResources = loadResources;
     gameWindow->initAudio = initAudio;
+    gameWindow->benchmarkFrames = 0;
     gameWindow->gw = NULL;
     gameWindow->initialized = false;
 
@@ -100,10 +102,33 @@ void initGameWindow( GameWindow *gameWindow ) {
 
         gameWindow->gw = createGameWorld();
 
-        // game loop
-        while ( !WindowShouldClose() ) {
-            inputAndUpdateGameWorld( gameWindow->gw );
-            drawGameWorld( gameWindow->gw );
+        // the quality governor holds the frame time of the target FPS
+        if ( gameWindow->targetFPS > 0 ) {
+            gameWindow->gw->governor.budget = 1.0f / gameWindow->targetFPS;
+        }
+
+        if ( gameWindow->benchmarkFrames > 0 ) {
+
+            Benchmark benchmark;
+            initBenchmark( &benchmark, gameWindow->gw, gameWindow->benchmarkFrames );
+
+            while ( !WindowShouldClose() && !isFinishedBenchmark( &benchmark ) ) {
+                updateBenchmark( &benchmark, gameWindow->gw );
+                drawGameWorld( gameWindow->gw );
+                recordBenchmark( &benchmark, gameWindow->gw );
+            }
+
+            writeReportBenchmark( &benchmark, BENCHMARK_REPORT_FILE_NAME );
+            destroyBenchmark( &benchmark );
+
+        } else {
+
+            // game loop
+            while ( !WindowShouldClose() ) {
+                inputAndUpdateGameWorld( gameWindow->gw );
+                drawGameWorld( gameWindow->gw );
+            }
+
         }
 
         if ( gameWindow->loadResources ) {
@@ -17,6 +17,12 @@
 #include "Enemy.h"
 #include "Bullet.h"
 #include "Block.h"
+#include "WorldChunks.h"
+#include "Frustum.h"
+#include "Pvs.h"
+#include "SphereBatch.h"
+#include "LightClusters.h"
+#include "Lightmap.h"
 #include "utils.h"
 #include "raylib/raylib.h"
 #include "raylib/raymath.h"
@@ -31,21 +37,45 @@
 
 #define MAX_HITS 100
 
+// markers read from a map, the ones over these limits are ignored
+#define MAP_MAX_OBSTACLES 1000
+#define MAP_MAX_ENEMIES 100
+#define MAP_MAX_POWER_UPS 100
+#define MAP_MAX_LIGHTS 100
+
 // extern from GameWorld.h
 const float GRAVITY = 50.0f;
 
 // id generation - extern from Types.h
 int entityIdCounter = 1;
 
+// extern from EntitySupport.h
+bool shaderOutlines = false;
+
 const int GAMEPAD_ID = 0;
 const int CAMERA_TYPE_QUANTITY = 2;
 
 const float FIRST_PERSON_CAMERA_TARGET_DIST = 30.0f;
+const float LIGHT_RADIUS = 60.0f;
+
+// side of the culled pieces of the ground, in world units
+const float GROUND_TILE_SIZE = 16.0f;
 
 bool loadTestMap = true;
 const char *TEST_MAP_FILENAME = "testMap.txt";
 const char *TEST_IMAGE_MAP_FILENAME = "testMap.png";
 
+// extern from GameWorld.h - when set replaces the maps above (used by the benchmark)
+const char *customMapFilePath = NULL;
+
+// the governor keeps the frames inside this time (GameWindow sets it from the target FPS)
+const float DEFAULT_FRAME_BUDGET = 1.0f / 60.0f;
+
+// seconds between updates of the debug info text
+const float DEBUG_INFO_REFRESH_TIME = 0.25f;
+
+const LightingTier DEFAULT_LIGHTING_TIER = LIGHTING_TIER_HIGH;
+//const LightingTier DEFAULT_LIGHTING_TIER = LIGHTING_TIER_LOW;
 const CameraType DEFAULT_CAMERA_TYPE = CAMERA_TYPE_FIRST_PERSON;
 //const CameraType DEFAULT_CAMERA_TYPE = CAMERA_TYPE_THIRD_PERSON_FIXED;
 const GameWorldPlayerInputType DEFAULT_INPUT_TYPE = GAME_WORLD_PLAYER_INPUT_TYPE_GAMEPAD;
@@ -55,6 +85,7 @@ const GameWorldPlayerInputType DEFAULT_INPUT_TYPE = GAME_WORLD_PLAYER_INPUT_TYPE
 bool showDebugInfo = false;
 bool showInputHelp = true;
 bool drawWalls = true;
+bool renderObstaclesTouchColor = false;
 
 IdentifiedRayCollision hits[MAX_HITS];
 int hitCounter = 0;
@@ -75,10 +106,32 @@ GameWorld* createGameWorld( void ) {
 
     GameWorld *gw = (GameWorld*) calloc( 1, sizeof( GameWorld ) );
 
-    gw->lightShader = rm.lightShader;
-    gw->ambientLoc = GetShaderLocation( gw->lightShader, "ambient" );
-    SetShaderValue( gw->lightShader, gw->ambientLoc, (float[4]){ 0.1f, 0.1f, 0.1f, 1.0f }, SHADER_UNIFORM_VEC4 );
-
+    initImpactDecals( &gw->impacts, rm.decalShader );
+    initEnemyImpostors( &gw->impostors, rm.impostorShader );
+    initRenderQueue( &gw->renderQueue, rm.depthShader );
+    initStreamBuffer( &gw->stream );
+    initPickBuffer( &gw->picking, rm.pickShader );
+    initGpuTimer( &gw->gpuTimer );
+    setEnabledGpuTimer( &gw->gpuTimer, true );     // the quality governor reads the GPU time
+    initOcclusionCuller( &gw->occlusion );
+    initParticleSystem( &gw->particles, rm.particleAtlas, rm.particleFrames );
+
+    gw->lightingTier = DEFAULT_LIGHTING_TIER;
+    gw->preferredLightingTier = DEFAULT_LIGHTING_TIER;
+    gw->lightRadius = LIGHT_RADIUS;
+    gw->lightShader = getLightShaderResourceManager( gw->lightingTier );
+    setConstantUniforms( gw->lightShader, gw->renderQueue.outlineWidth );
+    initLightClusters( &gw->lightClusters, gw->lightShader );
+
+    gw->lightmapShader = rm.lightmapShader;
+    gw->checkerShader = rm.checkerShader;
+    setConstantUniforms( gw->lightmapShader, gw->renderQueue.outlineWidth );
+    setConstantUniforms( gw->checkerShader, gw->renderQueue.outlineWidth );
+    setLightmapScale( gw, 1.0f );
+
+    initQualityGovernor( &gw->governor, DEFAULT_FRAME_BUDGET );
+
+    gw->playerQuantity = 1;
     configureGameWorld( gw );
 
     return gw;
@@ -93,6 +146,7 @@ void configureGameWorld( GameWorld *gw ) {
     Color wallColor = DARKBLUE;
     Color obstacleColor = LIME;
     //Color obstacleColor = Fade( LIME, 0.8f );
+    Color breakableObstacleColor = DARKGREEN;
     Color enemyColor = RED;
     Color enemyEyeColor = { 38, 0, 82, 255 };
     Color bulletColor = WHITE;
@@ -102,11 +156,15 @@ void configureGameWorld( GameWorld *gw ) {
     yCam = 25.0f;
     zCam = 1.0f;
 
-    gw->maxCollidedBullets = 50;
-    gw->collidedBulletCount = 0;
+    clearImpactDecals( &gw->impacts );
+    clearParticleSystem( &gw->particles );
     gw->bulletColor = bulletColor;
+    gw->breakableObstacleColor = breakableObstacleColor;
 
-    if ( loadTestMap ) {
+    if ( customMapFilePath != NULL ) {
+        processMapFile( customMapFilePath, gw, blockSize, wallColor, obstacleColor, enemyColor, enemyEyeColor, lightColor );
+        resetBgMusic( gw );
+    } else if ( loadTestMap ) {
         processMapFile( TextFormat( "resources/maps/%s", TEST_MAP_FILENAME ), gw, blockSize, wallColor, obstacleColor, enemyColor, enemyEyeColor, lightColor );
         //processImageMapFile( TextFormat( "resources/maps/%s", TEST_IMAGE_MAP_FILENAME ), gw, blockSize, wallColor, obstacleColor, enemyColor, enemyEyeColor, lightColor );
         setBgMusic( gw, &rm.bgMusicTestMap );
@@ -116,29 +174,39 @@ void configureGameWorld( GameWorld *gw ) {
     }
 
     gw->lightSpeed = 0.0f;
+    shaderOutlines = gw->activeLights != 0;
+
+    // the ground and the walls always paint their checkerboard in the shader
+    SetShaderValue( gw->checkerShader, GetShaderLocation( gw->checkerShader, "unlit" ), (int[1]){ gw->activeLights == 0 }, SHADER_UNIFORM_INT );
+
+    if ( gw->activeLights != 0 ) {
+
+        // the static geometry uses the baked lights, the rest is lit per frame
+        bakeStaticLightmaps( gw );
+        setLightmapScale( gw, 1.0f );
+
+        setEntityModelsShader( gw->lightShader );
+        setShaderWorldChunks( &gw->chunks, gw->lightmapShader );
 
-    if ( gw->lightQuantity != 0 ) {
-        gw->player.model.materials[0].shader = gw->lightShader;
-        gw->ground.model.materials[0].shader = gw->lightShader;
-        gw->enemies[0].model.materials[0].shader = gw->lightShader;
-        gw->powerUps[0].model.materials[0].shader = gw->lightShader;
-        gw->obstacles.data[0].model.materials[0].shader = gw->lightShader;
-        gw->leftWall.model.materials[0].shader = gw->lightShader;
-        gw->rightWall.model.materials[0].shader = gw->lightShader;
-        gw->farWall.model.materials[0].shader = gw->lightShader;
-        gw->nearWall.model.materials[0].shader = gw->lightShader;
     }
 
-    gw->cameraType = DEFAULT_CAMERA_TYPE;
-    setupCamera( gw );
-    updateCameraTarget( gw, &gw->player );
-    updateCameraPosition( gw, &gw->player, xCam, yCam, zCam );
+    initSphereBatch( &gw->spheres, rm.sphereShader );
 
-    if ( gw->lightQuantity != 0 ) {
-        updateShaders( gw );
+    if ( gw->enemyQuantity != 0 ) {
+        bakeEnemyImpostors( &gw->impostors, &gw->enemies[0] );
     }
 
+    gw->cameraType = DEFAULT_CAMERA_TYPE;
     gw->playerInputType = DEFAULT_INPUT_TYPE;
+    setupCamera( gw );
+
+    // the results of the previous map are for other entities
+    setEnabledOcclusionCuller( &gw->occlusion, gw->occlusion.enabled );
+
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        updateCameraTarget( gw, &gw->players[i] );
+        updateCameraPosition( gw, &gw->players[i], xCam, yCam, zCam );
+    }
 
 }
 
@@ -148,7 +216,29 @@ void configureGameWorld( GameWorld *gw ) {
 void destroyGameWorld( GameWorld *gw ) {
     free( gw->enemies );
     free( gw->powerUps );
+    destroyPvs( &gw->pvs );
+    destroyWorldChunks( &gw->chunks );
     Obstacles_drop( &gw->obstacles );
+    destroyFrustumCuller( &gw->culler );
+    destroySphereBatch( &gw->spheres );
+    destroyLightClusters( &gw->lightClusters );
+    destroyImpactDecals( &gw->impacts );
+    destroyEnemyImpostors( &gw->impostors );
+    destroyRenderQueue( &gw->renderQueue );
+    destroyStreamBuffer( &gw->stream );
+    stopFrameCapture( &gw->capture );
+    destroyPickBuffer( &gw->picking );
+    destroyGpuTimer( &gw->gpuTimer );
+    destroyOcclusionCuller( &gw->occlusion );
+    destroyParticleSystem( &gw->particles );
+    destroyHpBarBatch( &gw->hpBars );
+    unloadSceneTarget( &gw->scene );
+    for ( int i = 0; i < GAME_WORLD_MAX_PLAYERS; i++ ) {
+        unloadHudPanel( &gw->playerHuds[i] );
+    }
+    unloadHudPanel( &gw->helpPanel );
+    unloadHudPanel( &gw->debugPanel );
+    unloadStaticLightmaps( gw );
     free( gw->lights );
     free( gw );
 }
@@ -159,41 +249,68 @@ void destroyGameWorld( GameWorld *gw ) {
 void inputAndUpdateGameWorld( GameWorld *gw ) {
 
     float delta = GetFrameTime();
-    Player *player = &gw->player;
 
-    processOptionsInput( player, gw );
+    gw->frameStartTime = GetTime();
+    // the GPU time of a frame read back a few frames late
+    float gpuTime = gw->gpuTimer.enabled && gw->gpuTimer.resultFrame >= 0 ? gw->gpuTimer.frameTime : -1.0f;
+    updateQualityGovernor( &gw->governor, delta, gw->workTime, gpuTime );
+    if ( gw->governor.changed ) {
+        applyQualityLevel( gw );
+    }
+
+    processOptionsInput( gw );
+    updateWorldChunks( &gw->chunks );
+    updateImpactDecals( &gw->impacts, delta );
+    updateParticleSystem( &gw->particles, delta );
+    updatePvs( &gw->pvs, 0.002 );
     
-    if ( player->state == PLAYER_STATE_ALIVE ) {
+    if ( isAnyPlayerAlive( gw ) ) {
 
-        Player *player = &gw->player;
         Block *ground = &gw->ground;
         Block *leftWall = &gw->leftWall;
         Block *rightWall = &gw->rightWall;
         Block *farWall = &gw->farWall;
         Block *nearWall = &gw->nearWall;
 
-        if ( gw->playerInputType == GAME_WORLD_PLAYER_INPUT_TYPE_KEYBOARD ) {
-            processPlayerInputByKeyboard( gw, player, gw->cameraType, delta );
-        } else if ( gw->playerInputType == GAME_WORLD_PLAYER_INPUT_TYPE_GAMEPAD ) {
-            processPlayerInputByGamepad( gw, player, gw->cameraType, delta );
+        for ( int i = 0; i < gw->playerQuantity; i++ ) {
+
+            Player *player = &gw->players[i];
+
+            if ( player->state != PLAYER_STATE_ALIVE ) {
+                continue;
+            }
+
+            int gamepadId = getPlayerGamepadId( gw, i );
+
+            if ( gamepadId < 0 ) {
+                processPlayerInputByKeyboard( gw, player, gw->cameraType, delta );
+            } else {
+                processPlayerInputByGamepad( gw, player, gw->cameraType, gamepadId, delta );
+            }
+            
+            updatePlayer( player, delta );
+            updatePlayerCollisionProbes( player );
+            
+            resolveCollisionPlayerObstacles( player, gw );
+            updatePlayerCollisionProbes( player );
+            resolveCollisionPlayerGround( player, ground );
+            resolveCollisionPlayerWalls( player, leftWall, rightWall, farWall, nearWall );
+
         }
-        
-        updatePlayer( player, delta );
-        updatePlayerCollisionProbes( player );
-        
-        resolveCollisionPlayerObstacles( player, gw );
-        updatePlayerCollisionProbes( player );
-        resolveCollisionPlayerGround( player, ground );
-        resolveCollisionPlayerWalls( player, leftWall, rightWall, farWall, nearWall );
 
         for ( int i = 0; i < gw->powerUpQuantity; i++ ) {
             PowerUp *powerUp = &gw->powerUps[i];
             updatePowerUp( powerUp, delta );
-            resolveCollisionPlayerPowerUp( player, powerUp );
+            for ( int j = 0; j < gw->playerQuantity; j++ ) {
+                if ( gw->players[j].state == PLAYER_STATE_ALIVE ) {
+                    resolveCollisionPlayerPowerUp( &gw->players[j], powerUp );
+                }
+            }
             resolveCollisionPowerUpGround( powerUp, ground );
         }
         cleanConsumedPowerUps( gw );
 
+        // each enemy chases the nearest player
         for ( int i = 0; i < gw->enemyQuantity; i++ ) {
             Enemy *enemy = &gw->enemies[i];
             if ( enemy->positionState == ENEMY_POSITION_STATE_ON_GROUND ) {
@@ -201,22 +318,25 @@ void inputAndUpdateGameWorld( GameWorld *gw ) {
                     jumpEnemy( enemy );
                 }
             }
+            Player *player = getNearestAlivePlayer( gw, enemy->pos );
             updateEnemy( enemy, player, gw, delta );
             updateEnemyCollisionProbes( enemy );
             resolveCollisionEnemyObstacles( enemy, gw );
             resolveCollisionEnemyGround( enemy, ground );
             resolveCollisionEnemyWalls( enemy, leftWall, rightWall, farWall, nearWall );
-            resolveCollisionPlayerEnemy( player, enemy );
-            setEnemyDetectedByPlayer( enemy, &gw->player, true );
+            for ( int j = 0; j < gw->playerQuantity; j++ ) {
+                if ( gw->players[j].state == PLAYER_STATE_ALIVE ) {
+                    resolveCollisionPlayerEnemy( &gw->players[j], enemy );
+                }
+            }
+            setEnemyDetectedByPlayer( enemy, player, true );
         }
 
         updateLights( gw, delta );
 
-        updateCameraTarget( gw, &gw->player );
-        updateCameraPosition( gw, &gw->player, xCam, yCam, zCam );
-        
-        if ( gw->lightQuantity != 0 ) {
-            updateShaders( gw );
+        for ( int i = 0; i < gw->playerQuantity; i++ ) {
+            updateCameraTarget( gw, &gw->players[i] );
+            updateCameraPosition( gw, &gw->players[i], xCam, yCam, zCam );
         }
 
         /*if ( player->currentWeapon->type == WEAPON_TYPE_SHOTGUN ) {
@@ -237,110 +357,519 @@ void inputAndUpdateGameWorld( GameWorld *gw ) {
 void drawGameWorld( GameWorld *gw ) {
 
     BeginDrawing();
-    ClearBackground( WHITE );
+    beginGpuTimer( &gw->gpuTimer );
+
+    if ( gw->picking.enabled && gw->cameraType == CAMERA_TYPE_FIRST_PERSON ) {
+        markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_PICKING );
+        drawPickGameWorld( gw );
+    }
 
-    BeginMode3D( gw->camera );
+    // the boxes and the 2D lines are shared by the views
+    addRenderablesGameWorld( gw );
+    beginStreamBuffer( &gw->stream );
+    advanceOcclusionCuller( &gw->occlusion );
 
-    if ( gw->lightQuantity != 0 ) {
+    // with three players the last quarter has no view
+    if ( gw->playerQuantity == 3 ) {
+        Rectangle r = getViewportGameWorld( gw, 3 );
+        DrawRectangleRec( r, BLACK );
+    }
+
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        drawViewGameWorld( gw, i );
+    }
+
+    markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_OVERLAYS );
+
+    if ( showDebugInfo ) {
+        drawDebugInfo( gw );
+    }
+
+    // the debug lines
+    drawStreamBuffer( &gw->stream );
+
+    if ( showInputHelp ) {
+        drawInputHelp( gw );
+    }
+
+    captureFrameCapture( &gw->capture );
+    endGpuTimer( &gw->gpuTimer );
+
+    // presenting the frame waits for the GPU and for the target FPS
+    gw->workTime = GetTime() - gw->frameStartTime;
+
+    EndDrawing();
+
+}
+
+void drawViewGameWorld( GameWorld *gw, int view ) {
+
+    Camera3D camera = gw->cameras[view];
+    Player *player = &gw->players[view];
+    Rectangle viewport = getViewportGameWorld( gw, view );
+
+    markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_WORLD );
+    beginSceneTarget( &gw->scene, gw->governor.resolutionScale, viewport, WHITE );
+
+    beginOcclusionCuller( &gw->occlusion, view, gw->enemyQuantity + gw->powerUpQuantity );
+    cullGameWorld( gw, camera, (float) gw->scene.width / gw->scene.height );
+
+    if ( gw->activeLights != 0 ) {
+        markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_LIGHTS );
+        updateLightClusters( &gw->lightClusters, camera, (Rectangle){ gw->scene.x, gw->scene.y, gw->scene.width, gw->scene.height }, gw->lights, gw->activeLights, gw->lightRadius );
+        bindLightClusters( &gw->lightClusters );
+        updateShaders( gw, camera );
+        markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_WORLD );
+    }
+
+    beginSphereBatch( &gw->spheres, camera, gw->scene.height );
+    setCameraStreamBuffer( &gw->stream, camera, gw->scene.height );
+
+    beginSceneMode3D( &gw->scene, camera );
+
+    if ( gw->activeLights != 0 ) {
         BeginShaderMode( gw->lightShader );
     }
 
     //DrawGrid( 120, 1.0f );
 
-    int collidedBullets = gw->collidedBulletCount < gw->maxCollidedBullets ? gw->collidedBulletCount : gw->maxCollidedBullets;
-    for ( int i = 0; i < collidedBullets; i++ ) {
-        drawBullet( &gw->collidedBullets[i] );
-    }
+    // the meshes are queued and drawn sorted, the rest is drawn right away
+    beginRenderQueue( &gw->renderQueue, camera );
 
-    drawBlock( &gw->ground );
-    drawPlayer( &gw->player );
-    
-    for ( int i = 0; i < gw->enemyQuantity; i++ ) {
-        drawEnemy( &gw->enemies[i] );
+    drawBlockMeshes( &gw->ground, &gw->renderQueue, &gw->stream, &gw->culler.visible[gw->renderableStart[RENDERABLE_TYPE_GROUND]] );
+
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        if ( isRenderableVisible( gw, RENDERABLE_TYPE_PLAYER, i ) ) {
+            drawPlayer( &gw->players[i], &gw->renderQueue );
+        }
     }
+    
+    drawEnemies( gw, camera );
 
     for ( int i = 0; i < gw->powerUpQuantity; i++ ) {
-        drawPowerUp( &gw->powerUps[i] );
+        if ( isRenderableVisible( gw, RENDERABLE_TYPE_POWER_UP, i ) ) {
+            drawPowerUp( &gw->powerUps[i], &gw->spheres );
+        }
     }
 
-    c_foreach ( i, Obstacles, gw->obstacles ) {
-        drawBlock( i.ref );
-    }
+    drawWorldChunks( &gw->chunks, &gw->renderQueue, &gw->stream, renderObstaclesTouchColor, &gw->culler.visible[gw->renderableStart[RENDERABLE_TYPE_WORLD_CHUNK]] );
 
     if ( drawWalls ) {
-        drawBlock( &gw->leftWall );
-        drawBlock( &gw->rightWall );
-        drawBlock( &gw->farWall );
-        drawBlock( &gw->nearWall );
+        Block *walls[4] = { &gw->leftWall, &gw->rightWall, &gw->farWall, &gw->nearWall };
+        for ( int i = 0; i < 4; i++ ) {
+            if ( isRenderableVisible( gw, RENDERABLE_TYPE_WALL, i ) ) {
+                drawBlockMeshes( walls[i], &gw->renderQueue, &gw->stream, NULL );
+            }
+        }
     }
 
-    if ( gw->lightQuantity != 0 ) {
+    drawRenderQueue( &gw->renderQueue );
+
+    if ( gw->activeLights != 0 ) {
         EndShaderMode();
     }
 
+    // the wires of the blocks
+    drawStreamBuffer( &gw->stream );
+
+    // tested against the depth of the world, the results are used in the next frames
+    drawProxiesOcclusionCuller( &gw->occlusion );
+
+    markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_ENTITIES );
+
+    if ( gw->governor.level < QUALITY_LEVEL_NO_DECALS ) {
+        drawImpactDecals( &gw->impacts );
+    }
     drawLights( gw );
+    drawSphereBatch( &gw->spheres );
 
+    markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_BILLBOARDS );
+    drawEnemyImpostors( &gw->impostors, camera );
+
+    drawParticleSystem( &gw->particles, camera );
+
+    EndMode3D();
+
+    // the interface is drawn over the scaled scene, with the window resolution
+    markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_WORLD );
+    endSceneTarget( &gw->scene );
+
+    markGpuTimer( &gw->gpuTimer, GPU_TIMER_PASS_HUD );
+    beginHpBarBatch( &gw->hpBars );
     for ( int i = 0; i < gw->enemyQuantity; i++ ) {
-        drawEnemyExplosionBillboard( &gw->enemies[i], gw->camera );
+        if ( isRenderableVisible( gw, RENDERABLE_TYPE_ENEMY, i ) ) {
+            addEnemyHpBar( &gw->enemies[i], &gw->hpBars );
+        }
     }
+    drawHpBarBatch( &gw->hpBars, &gw->stream, camera, viewport );
 
-    EndMode3D();
+    drawPlayerHud( player, &gw->playerHuds[view], viewport );
+    drawReticle( gw, view, 30 );
+
+    // the reticle, before the next view changes the viewport
+    drawStreamBuffer( &gw->stream );
+
+    if ( player->state == PLAYER_STATE_DEAD ) {
+        drawGameoverOverlay( viewport );
+    }
+
+}
+
+/**
+ * @brief Queues the visible enemies with the detail of their size on the
+ * screen. The far ones become impostors, drawn later in one batch, and the
+ * ones in the middle distance lose the attached bullets and the outlines.
+ */
+void drawEnemies( GameWorld *gw, Camera3D camera ) {
+
+    beginEnemyImpostors( &gw->impostors );
+
+    for ( int i = 0; i < ENEMY_LOD_QUANTITY; i++ ) {
+        gw->enemyLodQuantity[i] = 0;
+    }
 
     for ( int i = 0; i < gw->enemyQuantity; i++ ) {
-        drawEnemyHpBar( &gw->enemies[i], gw->camera );
+
+        Enemy *enemy = &gw->enemies[i];
+
+        if ( !isRenderableVisible( gw, RENDERABLE_TYPE_ENEMY, i ) || enemy->state != ENEMY_STATE_ALIVE ) {
+            continue;
+        }
+
+        // the debug views are always in full detail
+        if ( enemy->showWiresOnly || enemy->showCollisionProbes ) {
+            enemy->lod = ENEMY_LOD_FULL;
+        } else {
+            enemy->lod = getEnemyLod( enemy, camera, gw->scene.height );
+        }
+
+        gw->enemyLodQuantity[enemy->lod]++;
+
+        if ( enemy->lod == ENEMY_LOD_IMPOSTOR ) {
+            addEnemyImpostor( &gw->impostors, enemy );
+        } else {
+            drawEnemy( enemy, &gw->spheres, &gw->renderQueue, enemy->lod );
+        }
+
     }
 
-    drawPlayerHud( &gw->player );
-    drawReticle( gw, gw->cameraType, gw->player.weaponState, 30 );
+}
+
+/**
+ * @brief Draws what the reticle ray can hit in the picking target, the
+ * same entities tested by resolveHitsWorld.
+ */
+void drawPickGameWorld( GameWorld *gw ) {
+
+    PickBuffer *pb = &gw->picking;
+    beginPickBuffer( pb, getPlayerToVector3Ray( &gw->players[0], gw->cameras[0].target ) );
+
+    Block *b[5] = {
+        &gw->ground,
+        &gw->leftWall,
+        &gw->rightWall,
+        &gw->farWall,
+        &gw->nearWall
+    };
+
+    for ( int i = 0; i < 5; i++ ) {
+
+        if ( !b[i]->renderModel ) {
+            continue;
+        }
+
+        Model *model = &b[i]->model;
+        Matrix transform = MatrixMultiply( model->transform, MatrixTranslate( b[i]->pos.x, b[i]->pos.y, b[i]->pos.z ) );
+
+        for ( int j = 0; j < model->meshCount; j++ ) {
+            BoundingBox bounds = GetMeshBoundingBox( model->meshes[j] );
+            bounds = (BoundingBox){ Vector3Add( bounds.min, b[i]->pos ), Vector3Add( bounds.max, b[i]->pos ) };
+            addMeshPickBuffer( pb, &model->meshes[j], &model->materials[model->meshMaterial[j]], transform, bounds, ENTITY_TYPE_BLOCK, b[i]->id );
+        }
 
-    if ( showDebugInfo ) {
-        drawDebugInfo( gw );
     }
 
-    if ( gw->player.state == PLAYER_STATE_DEAD ) {
-        drawGameoverOverlay();
+    for ( int i = 0; i < gw->chunks.chunkQuantity; i++ ) {
+        WorldChunk *chunk = &gw->chunks.chunks[i];
+        if ( chunk->modelLoaded ) {
+            for ( int j = 0; j < chunk->model.meshCount; j++ ) {
+                addMeshPickBuffer( pb, &chunk->model.meshes[j], &chunk->model.materials[chunk->model.meshMaterial[j]], chunk->model.transform, chunk->bounds, ENTITY_TYPE_OBSTACLE, 0 );
+            }
+        }
     }
 
-    if ( showInputHelp ) {
-        drawInputHelp( gw );
+    for ( int i = 0; i < gw->enemyQuantity; i++ ) {
+        Enemy *e = &gw->enemies[i];
+        addMeshPickBuffer( pb, &e->model.meshes[0], &e->model.materials[e->model.meshMaterial[0]], getEnemyTransformMatrix( e ), getEnemyBoundingBox( e ), ENTITY_TYPE_ENEMY, e->id );
     }
 
-    EndDrawing();
+    endPickBuffer( pb );
 
 }
 
-void drawReticle( GameWorld *gw, CameraType cameraType, PlayerWeaponState weaponState, int reticleSize ) {
+void addRenderablesGameWorld( GameWorld *gw ) {
 
-    if ( cameraType == CAMERA_TYPE_FIRST_PERSON ) {
+    FrustumCuller *fc = &gw->culler;
+    resetFrustumCuller( fc );
 
-        Vector2 v = {0};
-        IdentifiedRayCollision reticleHit = resolveHitsWorld( gw );
+    // one box for each tile of the ground
+    gw->renderableStart[RENDERABLE_TYPE_GROUND] = fc->count;
+    for ( int i = 0; i < gw->ground.model.meshCount; i++ ) {
+        BoundingBox tile = GetMeshBoundingBox( gw->ground.model.meshes[i] );
+        addBoxFrustumCuller( fc, (BoundingBox){ Vector3Add( tile.min, gw->ground.pos ), Vector3Add( tile.max, gw->ground.pos ) } );
+    }
 
-        if ( reticleHit.entityType == ENTITY_TYPE_NONE ) {
-            v = GetWorldToScreen( gw->camera.target, gw->camera );
-        } else {
-            v = GetWorldToScreen( reticleHit.collision.point, gw->camera );
+    gw->renderableStart[RENDERABLE_TYPE_WALL] = fc->count;
+    addBoxFrustumCuller( fc, getBlockBoundingBox( &gw->leftWall ) );
+    addBoxFrustumCuller( fc, getBlockBoundingBox( &gw->rightWall ) );
+    addBoxFrustumCuller( fc, getBlockBoundingBox( &gw->farWall ) );
+    addBoxFrustumCuller( fc, getBlockBoundingBox( &gw->nearWall ) );
+
+    gw->renderableStart[RENDERABLE_TYPE_PLAYER] = fc->count;
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        addBoxFrustumCuller( fc, getPlayerBoundingBox( &gw->players[i] ) );
+    }
+
+    gw->renderableStart[RENDERABLE_TYPE_WORLD_CHUNK] = fc->count;
+    for ( int i = 0; i < gw->chunks.chunkQuantity; i++ ) {
+        addBoxFrustumCuller( fc, gw->chunks.chunks[i].bounds );
+    }
+
+    // eyes and attached bullets stick out of the enemy, explosions are bigger
+    gw->renderableStart[RENDERABLE_TYPE_ENEMY] = fc->count;
+    for ( int i = 0; i < gw->enemyQuantity; i++ ) {
+        Enemy *enemy = &gw->enemies[i];
+        addBoxFrustumCuller( fc, expandBoundingBox( getEnemyBoundingBox( enemy ), enemy->state == ENEMY_STATE_DYING ? 2.5f : 1.0f ) );
+    }
+
+    gw->renderableStart[RENDERABLE_TYPE_POWER_UP] = fc->count;
+    for ( int i = 0; i < gw->powerUpQuantity; i++ ) {
+        addBoxFrustumCuller( fc, getPowerUpBoundingBox( &gw->powerUps[i] ) );
+    }
+
+    gw->renderableStart[RENDERABLE_TYPE_LIGHT] = fc->count;
+    for ( int i = 0; i < gw->activeLights; i++ ) {
+        Vector3 p = gw->lights[i].position;
+        addBoxFrustumCuller( fc, (BoundingBox){ Vector3SubtractValue( p, 1.0f ), Vector3AddValue( p, 1.0f ) } );
+    }
+
+    for ( int i = 0; i < RENDERABLE_TYPE_QUANTITY; i++ ) {
+        int end = i + 1 < RENDERABLE_TYPE_QUANTITY ? gw->renderableStart[i + 1] : fc->count;
+        gw->renderableCount[i] = end - gw->renderableStart[i];
+    }
+
+}
+
+// the box added to the culler by addRenderablesGameWorld
+static BoundingBox getRenderableBox( GameWorld *gw, RenderableType type, int index ) {
+
+    FrustumCuller *fc = &gw->culler;
+    int i = gw->renderableStart[type] + index;
+
+    return (BoundingBox){
+        { fc->centerX[i] - fc->extentX[i], fc->centerY[i] - fc->extentY[i], fc->centerZ[i] - fc->extentZ[i] },
+        { fc->centerX[i] + fc->extentX[i], fc->centerY[i] + fc->extentY[i], fc->centerZ[i] + fc->extentZ[i] }
+    };
+
+}
+
+void cullGameWorld( GameWorld *gw, Camera3D camera, float aspect ) {
+
+    FrustumCuller *fc = &gw->culler;
+
+    gw->frustum = createFrustumFromCamera( camera, aspect );
+    gw->culledQuantity = cullFrustumCuller( fc, &gw->frustum );
+
+    // what survived the frustum but is hidden by the obstacles
+    gw->pvsCulledQuantity = 0;
+    int viewerCell = getViewerCellPvs( &gw->pvs, camera.position );
+
+    if ( viewerCell >= 0 && isReadyPvs( &gw->pvs ) ) {
+
+        for ( int i = 0; i < gw->chunks.chunkQuantity; i++ ) {
+            WorldChunk *chunk = &gw->chunks.chunks[i];
+            bool *visible = &fc->visible[gw->renderableStart[RENDERABLE_TYPE_WORLD_CHUNK] + i];
+            if ( *visible && !isRegionVisiblePvs( &gw->pvs, viewerCell, chunk->minX, chunk->minZ, chunk->maxX, chunk->maxZ ) ) {
+                *visible = false;
+                gw->pvsCulledQuantity++;
+            }
         }
 
-        Color reticleColor = weaponState == PLAYER_WEAPON_STATE_READY ? RED : BLACK;
-        DrawLine( v.x - reticleSize, v.y, v.x + reticleSize, v.y, reticleColor );
-        DrawLine( v.x, v.y - reticleSize, v.x, v.y + reticleSize, reticleColor );
+        for ( int i = 0; i < gw->enemyQuantity; i++ ) {
+            bool *visible = &fc->visible[gw->renderableStart[RENDERABLE_TYPE_ENEMY] + i];
+            if ( *visible && !isPositionVisiblePvs( &gw->pvs, viewerCell, gw->enemies[i].pos ) ) {
+                *visible = false;
+                gw->pvsCulledQuantity++;
+            }
+        }
+
+        for ( int i = 0; i < gw->powerUpQuantity; i++ ) {
+            bool *visible = &fc->visible[gw->renderableStart[RENDERABLE_TYPE_POWER_UP] + i];
+            if ( *visible && !isPositionVisiblePvs( &gw->pvs, viewerCell, gw->powerUps[i].pos ) ) {
+                *visible = false;
+                gw->pvsCulledQuantity++;
+            }
+        }
+
+    }
+
+    // what survived both but was hidden behind the world in the last frames;
+    // the enemies come first in the indexes of the occlusion culler
+    gw->occlusionCulledQuantity = 0;
+
+    for ( int i = 0; i < gw->enemyQuantity; i++ ) {
+        bool *visible = &fc->visible[gw->renderableStart[RENDERABLE_TYPE_ENEMY] + i];
+        if ( *visible && !testOcclusionCuller( &gw->occlusion, i, getRenderableBox( gw, RENDERABLE_TYPE_ENEMY, i ), camera.position ) ) {
+            *visible = false;
+            gw->occlusionCulledQuantity++;
+        }
+    }
+
+    for ( int i = 0; i < gw->powerUpQuantity; i++ ) {
+        bool *visible = &fc->visible[gw->renderableStart[RENDERABLE_TYPE_POWER_UP] + i];
+        if ( *visible && !testOcclusionCuller( &gw->occlusion, gw->enemyQuantity + i, getRenderableBox( gw, RENDERABLE_TYPE_POWER_UP, i ), camera.position ) ) {
+            *visible = false;
+            gw->occlusionCulledQuantity++;
+        }
+    }
+
+}
+
+bool isRenderableVisible( GameWorld *gw, RenderableType type, int index ) {
+    return gw->culler.visible[gw->renderableStart[type] + index];
+}
+
+Rectangle getViewportGameWorld( GameWorld *gw, int view ) {
+
+    float width = GetScreenWidth();
+    float height = GetScreenHeight();
+
+    if ( gw->playerQuantity == 1 ) {
+        return (Rectangle){ 0, 0, width, height };
+    } else if ( gw->playerQuantity == 2 ) {
+        return (Rectangle){ 0, view * height / 2, width, height / 2 };
+    }
+
+    return (Rectangle){ ( view % 2 ) * width / 2, ( view / 2 ) * height / 2, width / 2, height / 2 };
+
+}
+
+// the players start side by side, from the start position of the map
+static void spawnPlayer( GameWorld *gw, int index ) {
+
+    Player *player = &gw->players[index];
+
+    *player = createPlayer( (Vector3){
+        .x = gw->playerStartPos.x + index * 2.0f,
+        .y = gw->playerStartPos.y,
+        .z = gw->playerStartPos.z
+    });
+    player->currentWeapon = &player->handgun;
+    player->rotationHorizontalAngle = gw->playerStartAngle;
+
+}
+
+void setPlayerQuantity( GameWorld *gw, int quantity ) {
+
+    quantity = quantity < 1 ? 1 : quantity > GAME_WORLD_MAX_PLAYERS ? GAME_WORLD_MAX_PLAYERS : quantity;
+
+    for ( int i = gw->playerQuantity; i < quantity; i++ ) {
+        spawnPlayer( gw, i );
+        updateCameraTarget( gw, &gw->players[i] );
+        updateCameraPosition( gw, &gw->players[i], xCam, yCam, zCam );
+    }
+
+    gw->playerQuantity = quantity;
+
+}
+
+Camera3D *getPlayerCamera( GameWorld *gw, Player *player ) {
+    return &gw->cameras[player - gw->players];
+}
+
+int getPlayerGamepadId( GameWorld *gw, int playerIndex ) {
+
+    bool keyboard = gw->playerInputType == GAME_WORLD_PLAYER_INPUT_TYPE_KEYBOARD;
+
+    if ( playerIndex == 0 ) {
+        return keyboard ? -1 : GAMEPAD_ID;
+    }
+
+    // the gamepads not taken by the first player, in order
+    return GAMEPAD_ID + ( keyboard ? playerIndex - 1 : playerIndex );
+
+}
+
+Player *getNearestAlivePlayer( GameWorld *gw, Vector3 pos ) {
+
+    Player *nearest = &gw->players[0];
+    float nearestDistance = -1.0f;
+
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        Player *player = &gw->players[i];
+        float distance = Vector3DistanceSqr( player->pos, pos );
+        if ( player->state == PLAYER_STATE_ALIVE && ( nearestDistance < 0.0f || distance < nearestDistance ) ) {
+            nearest = player;
+            nearestDistance = distance;
+        }
+    }
+
+    return nearest;
+
+}
+
+bool isAnyPlayerAlive( GameWorld *gw ) {
+
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        if ( gw->players[i].state == PLAYER_STATE_ALIVE ) {
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+void drawReticle( GameWorld *gw, int view, int reticleSize ) {
+
+    if ( gw->cameraType == CAMERA_TYPE_FIRST_PERSON ) {
+
+        Player *player = &gw->players[view];
+        Camera3D camera = gw->cameras[view];
+        Rectangle viewport = getViewportGameWorld( gw, view );
+
+        // the picking result is one frame old, but costs nothing on the CPU;
+        // the picking target follows only the first player
+        IdentifiedRayCollision reticleHit = gw->picking.enabled && view == 0 ? getHitPickBuffer( &gw->picking ) : resolveHitsWorld( gw, player );
+        Vector3 p = reticleHit.entityType == ENTITY_TYPE_NONE ? camera.target : reticleHit.collision.point;
+
+        Vector2 v = GetWorldToScreenEx( p, camera, viewport.width, viewport.height );
+        v.x += viewport.x;
+        v.y += viewport.y;
+
+        Color reticleColor = player->weaponState == PLAYER_WEAPON_STATE_READY ? RED : BLACK;
+        addLine2DStreamBuffer( &gw->stream, (Vector2){ v.x - reticleSize, v.y }, (Vector2){ v.x + reticleSize, v.y }, reticleColor );
+        addLine2DStreamBuffer( &gw->stream, (Vector2){ v.x, v.y - reticleSize }, (Vector2){ v.x, v.y + reticleSize }, reticleColor );
 
     }
 
 }
 
 void setupCamera( GameWorld *gw ) {
-    gw->camera = (Camera3D){ 0 };
-    gw->camera.position = (Vector3){ 0.0f, 25.0f, 0.0f };   // Camera position
-    gw->camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };          // Camera up vector (rotation towards target)
-    gw->camera.fovy = 45.0f;                                // Camera field-of-view Y
-    gw->camera.projection = CAMERA_PERSPECTIVE;             // Camera mode type
+    for ( int i = 0; i < GAME_WORLD_MAX_PLAYERS; i++ ) {
+        Camera3D *camera = &gw->cameras[i];
+        *camera = (Camera3D){ 0 };
+        camera->position = (Vector3){ 0.0f, 25.0f, 0.0f };  // Camera position
+        camera->up = (Vector3){ 0.0f, 1.0f, 0.0f };         // Camera up vector (rotation towards target)
+        camera->fovy = 45.0f;                               // Camera field-of-view Y
+        camera->projection = CAMERA_PERSPECTIVE;            // Camera mode type
+    }
 }
 
 void updateCameraTarget( GameWorld *gw, Player *player ) {
 
     float delta = GetFrameTime();
+    Camera3D *camera = getPlayerCamera( gw, player );
 
     float cosH = cos( DEG2RAD * player->rotationHorizontalAngle );
     float sinH = -sin( DEG2RAD * player->rotationHorizontalAngle );
@@ -350,12 +879,13 @@ void updateCameraTarget( GameWorld *gw, Player *player ) {
     switch ( gw->cameraType ) {
 
         case CAMERA_TYPE_THIRD_PERSON_FIXED:
-            gw->camera.target = player->pos;
+            camera->target = player->pos;
             break;
 
         case CAMERA_TYPE_FIRST_PERSON:
 
-            if ( gw->playerInputType == GAME_WORLD_PLAYER_INPUT_TYPE_KEYBOARD ) {
+            // only the first player may use the mouse
+            if ( player == &gw->players[0] && gw->playerInputType == GAME_WORLD_PLAYER_INPUT_TYPE_KEYBOARD ) {
 
                 int mouseX = GetMouseX();
                 int mouseY = GetMouseY();
@@ -371,13 +901,13 @@ void updateCameraTarget( GameWorld *gw, Player *player ) {
 
                 HideCursor();
 
-            } else {
+            } else if ( player == &gw->players[0] ) {
                 ShowCursor();
             }
 
-            gw->camera.target.x = player->pos.x + cosH * FIRST_PERSON_CAMERA_TARGET_DIST;
-            gw->camera.target.y = player->pos.y + cosV * FIRST_PERSON_CAMERA_TARGET_DIST;
-            gw->camera.target.z = player->pos.z + sinH * FIRST_PERSON_CAMERA_TARGET_DIST;
+            camera->target.x = player->pos.x + cosH * FIRST_PERSON_CAMERA_TARGET_DIST;
+            camera->target.y = player->pos.y + cosV * FIRST_PERSON_CAMERA_TARGET_DIST;
+            camera->target.z = player->pos.z + sinH * FIRST_PERSON_CAMERA_TARGET_DIST;
 
             break;
             
@@ -389,17 +919,18 @@ void updateCameraPosition( GameWorld *gw, Player *player, float xOffset, float y
 
     float cosH = cos( DEG2RAD * player->rotationHorizontalAngle );
     float sinH = -sin( DEG2RAD * player->rotationHorizontalAngle );
+    Camera3D *camera = getPlayerCamera( gw, player );
 
     switch ( gw->cameraType ) {
         case CAMERA_TYPE_THIRD_PERSON_FIXED:
-            gw->camera.position.x = player->pos.x + xOffset;
-            gw->camera.position.y = yOffset;
-            gw->camera.position.z = player->pos.z + zOffset;
+            camera->position.x = player->pos.x + xOffset;
+            camera->position.y = yOffset;
+            camera->position.z = player->pos.z + zOffset;
             break;
         case CAMERA_TYPE_FIRST_PERSON:
-            gw->camera.position = player->pos;
-            gw->camera.position.x += cosH * ( player->dim.x / 2 );
-            gw->camera.position.z += sinH * ( player->dim.z / 2 );
+            camera->position = player->pos;
+            camera->position.x += cosH * ( player->dim.x / 2 );
+            camera->position.z += sinH * ( player->dim.z / 2 );
             break;
     }
 
@@ -445,70 +976,287 @@ Block createGround( float thickness, int lines, int columns ) {
 
 }
 
-void createObstacles( GameWorld *gw, Vector3 *positions, int obstacleQuantity, float blockSize, Color obstacleColor ) {
+void createObstacles( GameWorld *gw, Vector3 *positions, bool *breakable, int obstacleQuantity, float blockSize, Color obstacleColor, Color breakableObstacleColor ) {
 
+    destroyWorldChunks( &gw->chunks );
     Obstacles_drop( &gw->obstacles );
     gw->obstacles = (Obstacles){ 0 };
 
     for ( int i = 0; i < obstacleQuantity; i++ ) {
+        Color color = breakable[i] ? breakableObstacleColor : obstacleColor;
         Obstacles_push( &gw->obstacles, (Block){
             .id = entityIdCounter++,
             .pos = positions[i],
             .dim = { blockSize, blockSize, blockSize },
-            .color = obstacleColor,
-            .tintColor = obstacleColor,
-            .touchColor = obstacleColor,
+            .color = color,
+            .tintColor = color,
+            .touchColor = color,
             .visible = true,
             .renderModel = false,
-            .renderTouchColor = false
+            .renderTouchColor = renderObstaclesTouchColor,
+            .maxHp = breakable[i] ? 100 : 0,
+            .currentHp = breakable[i] ? 100 : 0
         });
     }
 
+    gw->obstacleColor = obstacleColor;
     createObstaclesModel( &gw->obstacles );
 
+    // the map area, up to the top of the walls
+    BoundingBox worldBounds = getBlockBoundingBox( &gw->ground );
+    worldBounds.min.y = 0.0f;
+    worldBounds.max.y = gw->leftWall.dim.y;
+
+    initWorldChunks( &gw->chunks, &gw->obstacles, worldBounds, blockSize, obstacleColor, breakableObstacleColor, gw->lights, gw->activeLights, LIGHT_RADIUS );
+
 }
 
 void createLights( GameWorld *gw, Vector3 *positions, int lightQuantity, Color lightColor ) {
 
+    // the lights go to the shader through the light clusters, every frame
     if ( gw->lightQuantity == 0 ) {
-
-        gw->lightQuantity = MAX_LIGHTS;
+        gw->lightQuantity = LIGHT_CLUSTERS_MAX_LIGHTS;
         gw->lights = (Light*) malloc( sizeof( Light ) * gw->lightQuantity );
+    }
+
+    gw->activeLights = lightQuantity < LIGHT_CLUSTERS_MAX_LIGHTS ? lightQuantity : LIGHT_CLUSTERS_MAX_LIGHTS;
+
+    for ( int i = 0; i < gw->activeLights; i++ ) {
+        gw->lights[i] = (Light){
+            .type = LIGHT_POINT,
+            .enabled = true,
+            .position = positions[i],
+            .color = lightColor
+        };
+    }
+
+}
+
+void createPvs( GameWorld *gw, const char *mapFilePath, unsigned int mapHash ) {
+    destroyPvs( &gw->pvs );
+    initPvs( &gw->pvs, &gw->chunks.grid, TextFormat( "%s.pvs", mapFilePath ), mapHash );
+}
+
+/**
+ * @brief Sets the uniforms of a light or lightmap shader that don't change
+ * every frame.
+ */
+void setConstantUniforms( Shader shader, float outlineWidth ) {
+    SetShaderValue( shader, GetShaderLocation( shader, "ambient" ), (float[4]){ 0.1f, 0.1f, 0.1f, 1.0f }, SHADER_UNIFORM_VEC4 );
+    SetShaderValue( shader, GetShaderLocation( shader, "outlineWidth" ), &outlineWidth, SHADER_UNIFORM_FLOAT );
+}
+
+/**
+ * @brief Sets the shader of the player, enemy, power-up and obstacle
+ * models. The entities share the materials of the models kept in the
+ * resource manager, so the map may have none of some kind (or have lost
+ * all of its obstacles) and the shader is still set.
+ */
+void setEntityModelsShader( Shader shader ) {
+
+    if ( rm.playerModelCreated ) {
+        rm.playerModel.materials[0].shader = shader;
+    }
+
+    if ( rm.enemyModelCreated ) {
+        rm.enemyModel.materials[0].shader = shader;
+    }
+
+    if ( rm.powerUpModelCreated ) {
+        rm.powerUpModel.materials[0].shader = shader;
+    }
+
+    if ( rm.obstacleModelCreated ) {
+        rm.obstacleModel.materials[0].shader = shader;
+    }
+
+}
+
+/**
+ * @brief Switches the light shader of the dynamic entities to the variant
+ * of a lighting tier.
+ */
+void setLightingTier( GameWorld *gw, LightingTier tier ) {
+
+    // the variant may have just been compiled
+    gw->lightingTier = tier;
+    gw->lightShader = getLightShaderResourceManager( tier );
+    setConstantUniforms( gw->lightShader, gw->renderQueue.outlineWidth );
+    setShaderLightClusters( &gw->lightClusters, gw->lightShader );
+
+    if ( gw->activeLights != 0 ) {
+        setEntityModelsShader( gw->lightShader );
+    }
 
-        for ( int i = 0; i < gw->lightQuantity; i++ ) {
-            gw->lights[i] = CreateLight( LIGHT_POINT, Vector3Zero(), Vector3Zero(), lightColor, rm.lightShader );
+}
+
+/**
+ * @brief Sets the features of the current level of the quality governor.
+ * The lighting tier is never better than the one chosen by the player.
+ */
+void applyQualityLevel( GameWorld *gw ) {
+
+    QualityLevel level = gw->governor.level;
+
+    gw->particles.density = level >= QUALITY_LEVEL_FEWER_PARTICLES ? 0.25f : 1.0f;
+    gw->lightRadius = level >= QUALITY_LEVEL_SHORT_DYNAMIC_LIGHTS ? LIGHT_RADIUS * 0.6f : LIGHT_RADIUS;
+
+    float outlineWidth = level >= QUALITY_LEVEL_NO_OUTLINES ? 0.0f : 1.0f;
+    gw->renderQueue.outlineWidth = outlineWidth;
+    SetShaderValue( gw->lightShader, GetShaderLocation( gw->lightShader, "outlineWidth" ), &outlineWidth, SHADER_UNIFORM_FLOAT );
+    SetShaderValue( gw->lightmapShader, GetShaderLocation( gw->lightmapShader, "outlineWidth" ), &outlineWidth, SHADER_UNIFORM_FLOAT );
+    SetShaderValue( gw->checkerShader, GetShaderLocation( gw->checkerShader, "outlineWidth" ), &outlineWidth, SHADER_UNIFORM_FLOAT );
+
+    LightingTier tier = gw->preferredLightingTier;
+    if ( level >= QUALITY_LEVEL_LOW_LIGHTING ) {
+        tier = LIGHTING_TIER_LOW;
+    } else if ( level >= QUALITY_LEVEL_MEDIUM_LIGHTING && tier < LIGHTING_TIER_MEDIUM ) {
+        tier = LIGHTING_TIER_MEDIUM;
+    }
+
+    if ( tier != gw->lightingTier ) {
+        setLightingTier( gw, tier );
+    }
+
+}
+
+/**
+ * @brief Bakes the lights in the lightmaps of the ground and the walls, with
+ * the shadows of the obstacles. The chunks bake their own lightmaps.
+ */
+void bakeStaticLightmaps( GameWorld *gw ) {
+
+    Block *blocks[] = { &gw->ground, &gw->leftWall, &gw->rightWall, &gw->farWall, &gw->nearWall };
+    int blockQuantity = sizeof( blocks ) / sizeof( blocks[0] );
+
+    unloadStaticLightmaps( gw );
+
+    for ( int i = 0; i < blockQuantity; i++ ) {
+
+        Block *block = blocks[i];
+
+        LightmapBakeInput input = {
+            .meshes = block->model.meshes,
+            .meshCount = block->model.meshCount,
+            .offset = block->pos,
+            .occluders = &gw->chunks.grid,
+            .lights = gw->lights,
+            .lightQuantity = gw->activeLights,
+            .lightRadius = LIGHT_RADIUS,
+            .threadQuantity = LIGHTMAP_BAKE_THREADS
+        };
+
+        Image lightmap = bakeLightmap( &input );
+
+        for ( int j = 0; j < block->model.meshCount; j++ ) {
+            uploadLightmapCoordinates( &block->model.meshes[j] );
         }
 
+        block->lightmap = loadLightmapTexture( &lightmap );
+
     }
 
-    for ( int i = 0; i < MAX_LIGHTS; i++ ) {
-        gw->lights[i].position = Vector3Zero();
-        gw->lights[i].enabled = false;
-        UpdateLightValues( gw->lightShader, gw->lights[i] );
+}
+
+void setLightmapScale( GameWorld *gw, float scale ) {
+    SetShaderValue( gw->lightmapShader, GetShaderLocation( gw->lightmapShader, "lightmapScale" ), &scale, SHADER_UNIFORM_FLOAT );
+    SetShaderValue( gw->checkerShader, GetShaderLocation( gw->checkerShader, "lightmapScale" ), &scale, SHADER_UNIFORM_FLOAT );
+}
+
+void unloadStaticLightmaps( GameWorld *gw ) {
+
+    Block *blocks[] = { &gw->ground, &gw->leftWall, &gw->rightWall, &gw->farWall, &gw->nearWall };
+    int blockQuantity = sizeof( blocks ) / sizeof( blocks[0] );
+
+    for ( int i = 0; i < blockQuantity; i++ ) {
+        if ( blocks[i]->lightmap.id != 0 ) {
+            UnloadTexture( blocks[i]->lightmap );
+            blocks[i]->lightmap = (Texture2D){ 0 };
+        }
     }
 
-    gw->activeLights = lightQuantity < MAX_LIGHTS ? lightQuantity : MAX_LIGHTS;
+}
 
-    for ( int i = 0; i < gw->activeLights; i++ ) {
-        gw->lights[i].position = positions[i];
-        gw->lights[i].enabled = true;
-        UpdateLightValues( gw->lightShader, gw->lights[i] );
+// one quad facing up, with the vertices in the order of the faces of the
+// cube meshes, as the lightmap baker expects
+static Mesh genMeshGroundTile( float x0, float z0, float x1, float z1, float y, Vector3 groundDim ) {
+
+    Mesh mesh = { 0 };
+    mesh.vertexCount = 4;
+    mesh.triangleCount = 2;
+
+    mesh.vertices = (float*) MemAlloc( 4 * 3 * sizeof( float ) );
+    mesh.normals = (float*) MemAlloc( 4 * 3 * sizeof( float ) );
+    mesh.texcoords = (float*) MemAlloc( 4 * 2 * sizeof( float ) );
+    mesh.indices = (unsigned short*) MemAlloc( 6 * sizeof( unsigned short ) );
+
+    float xs[4] = { x0, x0, x1, x1 };
+    float zs[4] = { z0, z1, z1, z0 };
+
+    for ( int i = 0; i < 4; i++ ) {
+        mesh.vertices[i * 3] = xs[i];
+        mesh.vertices[i * 3 + 1] = y;
+        mesh.vertices[i * 3 + 2] = zs[i];
+        mesh.normals[i * 3] = 0.0f;
+        mesh.normals[i * 3 + 1] = 1.0f;
+        mesh.normals[i * 3 + 2] = 0.0f;
+        mesh.texcoords[i * 2] = xs[i] / groundDim.x + 0.5f;
+        mesh.texcoords[i * 2 + 1] = zs[i] / groundDim.z + 0.5f;
     }
 
+    unsigned short indices[6] = { 0, 1, 2, 0, 2, 3 };
+    for ( int i = 0; i < 6; i++ ) {
+        mesh.indices[i] = indices[i];
+    }
+
+    UploadMesh( &mesh, false );
+
+    return mesh;
+
 }
 
+/**
+ * @brief The ground is the top face of its block, split in square tiles
+ * that are culled one by one. The texture coordinates span the whole
+ * ground, so the outline is only drawn at its borders.
+ */
 void createGroundModel( Block *ground ) {
 
     if ( !rm.groundModelCreated ) {
 
-        Mesh mesh = GenMeshCube( ground->dim.x, ground->dim.y, ground->dim.z );
-        Model model = LoadModelFromMesh( mesh );
+        int tilesX = (int) ceilf( ground->dim.x / GROUND_TILE_SIZE );
+        int tilesZ = (int) ceilf( ground->dim.z / GROUND_TILE_SIZE );
+        tilesX = tilesX < 1 ? 1 : tilesX;
+        tilesZ = tilesZ < 1 ? 1 : tilesZ;
+
+        Model model = { 0 };
+        model.transform = MatrixIdentity();
+        model.meshCount = tilesX * tilesZ;
+        model.meshes = (Mesh*) MemAlloc( model.meshCount * sizeof( Mesh ) );
+        model.materialCount = 1;
+        model.materials = (Material*) MemAlloc( sizeof( Material ) );
+        model.materials[0] = LoadMaterialDefault();
+        model.meshMaterial = (int*) MemAlloc( model.meshCount * sizeof( int ) );
+
+        float top = ground->dim.y / 2;
+
+        for ( int i = 0; i < tilesZ; i++ ) {
+            for ( int j = 0; j < tilesX; j++ ) {
+                float x0 = -ground->dim.x / 2 + j * GROUND_TILE_SIZE;
+                float z0 = -ground->dim.z / 2 + i * GROUND_TILE_SIZE;
+                float x1 = fminf( x0 + GROUND_TILE_SIZE, ground->dim.x / 2 );
+                float z1 = fminf( z0 + GROUND_TILE_SIZE, ground->dim.z / 2 );
+                model.meshes[i * tilesX + j] = genMeshGroundTile( x0, z0, x1, z1, top, ground->dim );
+            }
+        }
 
-        Image img = GenImageChecked( ground->dim.x, ground->dim.z, 2, 2, ORANGE, (Color){ 192, 96, 0, 255 } );
+        // the two colors of the checkerboard painted by the shader
+        Image img = GenImageChecked( 2, 1, 1, 1, ORANGE, (Color){ 192, 96, 0, 255 } );
         Texture2D texture = LoadTextureFromImage( img );
         UnloadImage( img );
 
         model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+        model.materials[0].shader = rm.checkerShader;
         rm.groundModel = model;
         rm.groundModelCreated = true;
 
@@ -526,11 +1274,12 @@ void createLRWallModel( Block *wall ) {
         Mesh mesh = GenMeshCube( wall->dim.x, wall->dim.y, wall->dim.z );
         Model model = LoadModelFromMesh( mesh );
 
-        Image img = GenImageChecked( wall->dim.z, wall->dim.y, 2, 2, BLUE, DARKBLUE );
+        Image img = GenImageChecked( 2, 1, 1, 1, BLUE, DARKBLUE );
         Texture2D texture = LoadTextureFromImage( img );
         UnloadImage( img );
 
         model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+        model.materials[0].shader = rm.checkerShader;
         rm.lrWallModel = model;
         rm.lrWallModelCreated = true;
 
@@ -548,11 +1297,12 @@ void createFNWallModel( Block *wall ) {
         Mesh mesh = GenMeshCube( wall->dim.x, wall->dim.y, wall->dim.z );
         Model model = LoadModelFromMesh( mesh );
 
-        Image img = GenImageChecked( wall->dim.x, wall->dim.y, 2, 2, BLUE, DARKBLUE );
+        Image img = GenImageChecked( 2, 1, 1, 1, BLUE, DARKBLUE );
         Texture2D texture = LoadTextureFromImage( img );
         UnloadImage( img );
 
         model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+        model.materials[0].shader = rm.checkerShader;
         rm.fnWallModel = model;
         rm.fnWallModelCreated = true;
 
@@ -565,7 +1315,7 @@ void createFNWallModel( Block *wall ) {
 
 void createObstaclesModel( Obstacles *obst ) {
 
-    if ( !rm.obstacleModelCreated ) {
+    if ( !rm.obstacleModelCreated && Obstacles_size( obst ) > 0 ) {
 
         Block *baseObstacle = &obst->data[0];
 
@@ -682,12 +1432,49 @@ void createWalls( GameWorld *gw, Color wallColor, int groundLines, int groundCol
 
 }
 
-void processOptionsInput( Player *player, GameWorld *gw ) {
+void processOptionsInput( GameWorld *gw ) {
 
     if ( IsKeyPressed( KEY_F1 ) ) {
         showInputHelp = !showInputHelp;
     }
 
+    if ( IsKeyPressed( KEY_F3 ) ) {
+        gw->renderQueue.depthPrepass = !gw->renderQueue.depthPrepass;
+    }
+
+    if ( IsKeyPressed( KEY_F4 ) ) {
+        setEnabledPickBuffer( &gw->picking, !gw->picking.enabled );
+    }
+
+    if ( IsKeyPressed( KEY_F8 ) ) {
+        setEnabledGpuTimer( &gw->gpuTimer, !gw->gpuTimer.enabled );
+    }
+
+    if ( IsKeyPressed( KEY_F10 ) ) {
+        setEnabledOcclusionCuller( &gw->occlusion, !gw->occlusion.enabled );
+    }
+
+    if ( IsKeyPressed( KEY_F9 ) ) {
+        setPlayerQuantity( gw, gw->playerQuantity % GAME_WORLD_MAX_PLAYERS + 1 );
+    }
+
+    // F5 to F7 start recording in each format, any of them stops it
+    FrameCaptureFormat captureFormats[3] = { FRAME_CAPTURE_FORMAT_RAW, FRAME_CAPTURE_FORMAT_PNG, FRAME_CAPTURE_FORMAT_ENCODER };
+    for ( int i = 0; i < 3; i++ ) {
+        if ( IsKeyPressed( KEY_F5 + i ) ) {
+            if ( gw->capture.recording ) {
+                stopFrameCapture( &gw->capture );
+            } else {
+                startFrameCapture( &gw->capture, captureFormats[i], (int) ( 1.0f / gw->governor.budget + 0.5f ) );
+            }
+        }
+    }
+
+    if ( IsKeyPressed( KEY_F2 ) ) {
+        setEnabledQualityGovernor( &gw->governor, !gw->governor.enabled );
+        applyQualityLevel( gw );
+    }
+
     if ( IsKeyPressed( KEY_ONE ) ) {
         showDebugInfo = !showDebugInfo;
     }
@@ -697,10 +1484,13 @@ void processOptionsInput( Player *player, GameWorld *gw ) {
     }
 
     if ( IsKeyPressed( KEY_THREE ) ) {
-        player->showCollisionProbes = !player->showCollisionProbes;
+        for ( int i = 0; i < gw->playerQuantity; i++ ) {
+            gw->players[i].showCollisionProbes = !gw->players[i].showCollisionProbes;
+        }
     }
 
     if ( IsKeyPressed( KEY_FOUR ) ) {
+        renderObstaclesTouchColor = !renderObstaclesTouchColor;
         for ( int i = 0; i < Obstacles_size( &gw->obstacles ); i++ ) {
             gw->obstacles.data[i].renderTouchColor = !gw->obstacles.data[i].renderTouchColor;
         }
@@ -712,7 +1502,9 @@ void processOptionsInput( Player *player, GameWorld *gw ) {
     }
 
     if ( IsKeyPressed( KEY_SIX ) ) {
-        player->immortal = !player->immortal;
+        for ( int i = 0; i < gw->playerQuantity; i++ ) {
+            gw->players[i].immortal = !gw->players[i].immortal;
+        }
     }
 
     if ( IsKeyPressed( KEY_SEVEN ) ) {
@@ -723,8 +1515,14 @@ void processOptionsInput( Player *player, GameWorld *gw ) {
     if ( IsKeyPressed( KEY_EIGHT ) ) {
         for ( int i = 0; i < gw->activeLights; i++ ) {
             gw->lights[i].enabled = !gw->lights[i].enabled;
-            UpdateLightValues( gw->lightShader, gw->lights[i] );
         }
+        // the baked lights can't be toggled one by one, all of them follow the first
+        setLightmapScale( gw, gw->activeLights != 0 && gw->lights[0].enabled ? 1.0f : 0.0f );
+    }
+
+    if ( IsKeyPressed( KEY_NINE ) ) {
+        gw->preferredLightingTier = ( gw->preferredLightingTier + 1 ) % LIGHTING_TIER_QUANTITY;
+        applyQualityLevel( gw );
     }
 
     if ( IsKeyPressed( KEY_ZERO ) || 
@@ -819,18 +1617,18 @@ void processPlayerInputByKeyboard( GameWorld *gw, Player *player, CameraType cam
 
 }
 
-void processPlayerInputByGamepad( GameWorld *gw, Player *player, CameraType cameraType, float delta ) {
+void processPlayerInputByGamepad( GameWorld *gw, Player *player, CameraType cameraType, int gamepadId, float delta ) {
 
-    if ( IsGamepadAvailable( GAMEPAD_ID ) ) {
+    if ( IsGamepadAvailable( gamepadId ) ) {
 
         // standard
-        float gpxLeft = GetGamepadAxisMovement( GAMEPAD_ID, GAMEPAD_AXIS_LEFT_X );
-        float gpyLeft = GetGamepadAxisMovement( GAMEPAD_ID, GAMEPAD_AXIS_LEFT_Y );
+        float gpxLeft = GetGamepadAxisMovement( gamepadId, GAMEPAD_AXIS_LEFT_X );
+        float gpyLeft = GetGamepadAxisMovement( gamepadId, GAMEPAD_AXIS_LEFT_Y );
 
-        float gpxRight = GetGamepadAxisMovement( GAMEPAD_ID, GAMEPAD_AXIS_RIGHT_X );
-        float gpyRight = GetGamepadAxisMovement( GAMEPAD_ID, GAMEPAD_AXIS_RIGHT_Y );
+        float gpxRight = GetGamepadAxisMovement( gamepadId, GAMEPAD_AXIS_RIGHT_X );
+        float gpyRight = GetGamepadAxisMovement( gamepadId, GAMEPAD_AXIS_RIGHT_Y );
 
-        if ( IsGamepadButtonPressed( GAMEPAD_ID, GAMEPAD_BUTTON_LEFT_THUMB ) ) {
+        if ( IsGamepadButtonPressed( gamepadId, GAMEPAD_BUTTON_LEFT_THUMB ) ) {
             player->speed = player->runningSpeed;
             player->running = true;
         }
@@ -852,18 +1650,18 @@ void processPlayerInputByGamepad( GameWorld *gw, Player *player, CameraType came
             player->vel.z = player->speed * zMultiplier;
         }
 
-        if ( IsGamepadButtonPressed( GAMEPAD_ID, GAMEPAD_BUTTON_RIGHT_FACE_DOWN ) ) {
+        if ( IsGamepadButtonPressed( gamepadId, GAMEPAD_BUTTON_RIGHT_FACE_DOWN ) ) {
             jumpPlayer( player );
         }
 
-        if ( IsGamepadButtonDown( GAMEPAD_ID, GAMEPAD_BUTTON_LEFT_TRIGGER_2 ) ) {
+        if ( IsGamepadButtonDown( gamepadId, GAMEPAD_BUTTON_LEFT_TRIGGER_2 ) ) {
             player->weaponState = PLAYER_WEAPON_STATE_READY;
-            playerShotUsingGamepad( gw, player, GAMEPAD_ID );
+            playerShotUsingGamepad( gw, player, gamepadId );
         } else {
             player->weaponState = PLAYER_WEAPON_STATE_IDLE;
         }
 
-        if ( IsGamepadButtonPressed( GAMEPAD_ID, GAMEPAD_BUTTON_RIGHT_FACE_UP ) ) {
+        if ( IsGamepadButtonPressed( gamepadId, GAMEPAD_BUTTON_RIGHT_FACE_UP ) ) {
             playerSwapWeapon( player );
         }
 
@@ -873,8 +1671,11 @@ void processPlayerInputByGamepad( GameWorld *gw, Player *player, CameraType came
 
 void resolveCollisionPlayerObstacles( Player *player, GameWorld *gw ) {
 
-    for ( int i = 0; i < Obstacles_size( &gw->obstacles ); i++ ) {
-        Block *obs = &gw->obstacles.data[i];
+    int nearObstacles[256];
+    int nearQuantity = queryBoxWorldChunks( &gw->chunks, expandBoundingBox( getPlayerBoundingBox( player ), 0.5f ), nearObstacles, 256 );
+
+    for ( int i = 0; i < nearQuantity; i++ ) {
+        Block *obs = &gw->obstacles.data[nearObstacles[i]];
         PlayerCollisionType coll = checkCollisionPlayerBlock( player, obs, true );
         switch ( coll ) {
             case PLAYER_COLLISION_LEFT:
@@ -914,8 +1715,11 @@ void resolveCollisionPlayerObstacles( Player *player, GameWorld *gw ) {
 
 void resolveCollisionEnemyObstacles( Enemy *enemy, GameWorld *gw ) {
 
-    for ( int i = 0; i < Obstacles_size( &gw->obstacles ); i++ ) {
-        Block *obs = &gw->obstacles.data[i];
+    int nearObstacles[256];
+    int nearQuantity = queryBoxWorldChunks( &gw->chunks, expandBoundingBox( getEnemyBoundingBox( enemy ), 0.5f ), nearObstacles, 256 );
+
+    for ( int i = 0; i < nearQuantity; i++ ) {
+        Block *obs = &gw->obstacles.data[nearObstacles[i]];
         EnemyCollisionType coll = checkCollisionEnemyBlock( enemy, obs, true );
         switch ( coll ) {
             case ENEMY_COLLISION_LEFT:
@@ -1079,9 +1883,9 @@ void resolveCollisionPlayerPowerUp( Player *player, PowerUp *powerUp ) {
 
 // returns the identified collision of the closest entity or a zeroed collision
 // if there is not a detected collision
-IdentifiedRayCollision resolveHitsWorld( GameWorld *gw ) {
+IdentifiedRayCollision resolveHitsWorld( GameWorld *gw, Player *player ) {
 
-    Ray ray = getPlayerToVector3Ray( &gw->player, gw->camera.target );
+    Ray ray = getPlayerToVector3Ray( player, getPlayerCamera( gw, player )->target );
     hitCounter = 0;
 
     Block *b[5] = {
@@ -1103,17 +1907,7 @@ IdentifiedRayCollision resolveHitsWorld( GameWorld *gw ) {
         }
     }
 
-    for ( int i = 0; i < Obstacles_size( &gw->obstacles ); i++ ) {
-        RayCollision rc = GetRayCollisionBox( ray, getBlockBoundingBox( &gw->obstacles.data[i] ) );
-        if ( rc.hit && hitCounter < MAX_HITS ) {
-            hits[hitCounter++] = (IdentifiedRayCollision) {
-                //.entityId = gw->obstacles[i].id,
-                .entityId = gw->obstacles.data[i].id,
-                .entityType = ENTITY_TYPE_OBSTACLE,
-                .collision = rc
-            };
-        }
-    }
+    resolveHitsObstacles( gw, ray );
 
     for ( int i = 0; i < gw->enemyQuantity; i++ ) {
         Enemy *e = &gw->enemies[i];
@@ -1136,11 +1930,10 @@ IdentifiedRayCollision resolveHitsWorld( GameWorld *gw ) {
 
 }
 
-MultipleIdentifiedRayCollision resolveMultipleHitsWorld( GameWorld *gw ) {
+MultipleIdentifiedRayCollision resolveMultipleHitsWorld( GameWorld *gw, Player *player ) {
 
     int pelletQuantity = 20;
-    Player *player = &gw->player;
-    Vector3 centralTraget = gw->camera.target;
+    Vector3 centralTraget = getPlayerCamera( gw, player )->target;
 
     MultipleIdentifiedRayCollision mirc = {0};
     //DrawSphere( centralTraget, 0.5, BLACK );
@@ -1169,7 +1962,7 @@ MultipleIdentifiedRayCollision resolveMultipleHitsWorld( GameWorld *gw ) {
 
         //DrawSphere( cPos, 0.5, BLACK );
 
-        Ray ray = getPlayerToVector3Ray( &gw->player, cPos );
+        Ray ray = getPlayerToVector3Ray( player, cPos );
         hitCounter = 0;
 
         Block *b[5] = {
@@ -1191,17 +1984,7 @@ MultipleIdentifiedRayCollision resolveMultipleHitsWorld( GameWorld *gw ) {
             }
         }
 
-        for ( int i = 0; i < Obstacles_size( &gw->obstacles ); i++ ) {
-            RayCollision rc = GetRayCollisionBox( ray, getBlockBoundingBox( &gw->obstacles.data[i] ) );
-            if ( rc.hit && hitCounter < MAX_HITS ) {
-                hits[hitCounter++] = (IdentifiedRayCollision) {
-                    //.entityId = gw->obstacles[i].id,
-                    .entityId = gw->obstacles.data[i].id,
-                    .entityType = ENTITY_TYPE_OBSTACLE,
-                    .collision = rc
-                };
-            }
-        }
+        resolveHitsObstacles( gw, ray );
 
         for ( int i = 0; i < gw->enemyQuantity; i++ ) {
             Enemy *e = &gw->enemies[i];
@@ -1228,6 +2011,67 @@ MultipleIdentifiedRayCollision resolveMultipleHitsWorld( GameWorld *gw ) {
 
 }
 
+// only the obstacles of the chunks crossed by the ray are tested
+void resolveHitsObstacles( GameWorld *gw, Ray ray ) {
+
+    for ( int i = 0; i < gw->chunks.chunkQuantity; i++ ) {
+
+        WorldChunk *chunk = &gw->chunks.chunks[i];
+
+        if ( BlockIndexes_size( &chunk->blocks ) == 0 || !GetRayCollisionBox( ray, chunk->bounds ).hit ) {
+            continue;
+        }
+
+        c_foreach ( it, BlockIndexes, chunk->blocks ) {
+            Block *obs = &gw->obstacles.data[*it.ref];
+            RayCollision rc = GetRayCollisionBox( ray, getBlockBoundingBox( obs ) );
+            if ( rc.hit && hitCounter < MAX_HITS ) {
+                hits[hitCounter++] = (IdentifiedRayCollision) {
+                    .entityId = obs->id,
+                    .entityType = ENTITY_TYPE_OBSTACLE,
+                    .collision = rc
+                };
+            }
+        }
+
+    }
+
+}
+
+bool damageObstacle( GameWorld *gw, int obstacleId, int damage ) {
+
+    for ( int i = 0; i < Obstacles_size( &gw->obstacles ); i++ ) {
+
+        Block *obs = &gw->obstacles.data[i];
+
+        if ( obs->id == obstacleId ) {
+
+            if ( obs->maxHp == 0 ) {
+                return false;
+            }
+
+            obs->currentHp -= damage;
+
+            if ( obs->currentHp > 0 ) {
+                return false;
+            }
+
+            // the marks of the bullets go away with the obstacle
+            removeImpactDecalsInBox( &gw->impacts, expandBoundingBox( getBlockBoundingBox( obs ), 0.1f ) );
+            removeBlockWorldChunks( &gw->chunks, i );
+            invalidatePvs( &gw->pvs, &gw->chunks.grid );
+
+            return true;
+
+        }
+
+    }
+
+    // already destroyed, e.g. by another pellet of the same shot
+    return true;
+
+}
+
 int compareRaycollision( const void *pr1, const void *pr2 ) {
     IdentifiedRayCollision *r1 = (IdentifiedRayCollision*) pr1;
     IdentifiedRayCollision *r2 = (IdentifiedRayCollision*) pr2;
@@ -1243,33 +2087,38 @@ void resetGameWorld( GameWorld *gw ) {
     free( gw->enemies );
     free( gw->powerUps );
     //free( gw->obstacles );
+    unloadStaticLightmaps( gw );
     unloadModelsResourceManager();
     configureGameWorld( gw );
 }
 
 void drawDebugInfo( GameWorld *gw ) {
 
-    DrawFPS( 10, 10 );
-    DrawText( TextFormat( "player: x=%.1f, y=%.1f, z=%.1f", gw->player.pos.x, gw->player.pos.y, gw->player.pos.z ), 10, 30, 20, BLACK );
-    DrawText( TextFormat( "active enemies: %d", gw->enemyQuantity ), 10, 50, 20, BLACK );
-    DrawText( TextFormat( "active power-ups: %d", gw->powerUpQuantity ), 10, 70, 20, BLACK );
-    DrawText( TextFormat( "input type: %s", gw->playerInputType == GAME_WORLD_PLAYER_INPUT_TYPE_GAMEPAD ? "gamepad" : "keyboard" ), 10, 90, 20, BLACK );
-    DrawText( TextFormat( "weapon type: %s", gw->player.currentWeapon->name ), 10, 110, 20, BLACK );
-    DrawText( TextFormat( "mouse offset: x=%d, y=%d", mouseMoveOffsetX, mouseMoveOffsetY ), 10, 130, 20, BLACK );
-    showCameraInfo( &gw->camera, 10, 150 );
+    // the text is refreshed a few times per second, like the FPS counter
+    int key[] = { (int) ( GetTime() / DEBUG_INFO_REFRESH_TIME ) };
+
+    if ( beginHudPanel( &gw->debugPanel, 900, 490, key, 1 ) ) {
+        drawDebugInfoText( gw );
+        endHudPanel( &gw->debugPanel );
+    }
+
+    drawHudPanel( &gw->debugPanel, 0, 0 );
 
     // draw collision points with raycast (debug)
     if ( gw->cameraType == CAMERA_TYPE_FIRST_PERSON ) {
 
         Color colors[] = { BLACK, WHITE, DARKPURPLE, GREEN, BLUE, YELLOW, ORANGE, DARKGRAY };
 
+        // the hits of the last raycast, seen from the first player
+        Rectangle viewport = getViewportGameWorld( gw, 0 );
+
         for ( int i = 0; i < hitCounter; i++ ) {
 
-            Vector2 v = GetWorldToScreen( hits[i].collision.point, gw->camera );
+            Vector2 v = GetWorldToScreenEx( hits[i].collision.point, gw->cameras[0], viewport.width, viewport.height );
             Color c = i < 8 ? colors[i] : BLACK;
             float d = i == 0 ? 2 : hits[i].collision.distance * 100;
             
-            DrawCircleLinesV( v, d, c );
+            addCircleLinesStreamBuffer( &gw->stream, v, d, c );
             DrawText( TextFormat( "%d", hits[i].entityId ), v.x + d + 10, v.y, 20, c );
             DrawText( TextFormat( "%.2f", hits[i].collision.distance ), v.x, v.y + d + 10, 20, c );
 
@@ -1279,21 +2128,93 @@ void drawDebugInfo( GameWorld *gw ) {
 
 }
 
-void drawGameoverOverlay( void ) {
-    DrawRectangle( 0, 0, GetScreenWidth(), GetScreenHeight(), Fade( BLACK, 0.85f ) );
+void drawDebugInfoText( GameWorld *gw ) {
+
+    DrawFPS( 10, 10 );
+    DrawText( TextFormat( "player: x=%.1f, y=%.1f, z=%.1f", gw->players[0].pos.x, gw->players[0].pos.y, gw->players[0].pos.z ), 10, 30, 20, BLACK );
+    DrawText( TextFormat( "active enemies: %d", gw->enemyQuantity ), 10, 50, 20, BLACK );
+    DrawText( TextFormat( "active power-ups: %d", gw->powerUpQuantity ), 10, 70, 20, BLACK );
+    DrawText( TextFormat( "input type: %s, %d %s", gw->playerInputType == GAME_WORLD_PLAYER_INPUT_TYPE_GAMEPAD ? "gamepad" : "keyboard",
+        gw->playerQuantity, gw->playerQuantity == 1 ? "player" : "players (split screen)" ), 10, 90, 20, BLACK );
+    DrawText( TextFormat( "weapon type: %s", gw->players[0].currentWeapon->name ), 10, 110, 20, BLACK );
+    DrawText( TextFormat( "mouse offset: x=%d, y=%d", mouseMoveOffsetX, mouseMoveOffsetY ), 10, 130, 20, BLACK );
+    showCameraInfo( &gw->cameras[0], 10, 150 );
+    DrawText( TextFormat( "obstacle triangles: %d (%d as cubes)", getQuadCountWorldChunks( &gw->chunks ) * 2, Obstacles_size( &gw->obstacles ) * 12 ), 10, 170, 20, BLACK );
+    DrawText( TextFormat( "world chunks: %d (%d remeshing)", gw->chunks.chunkQuantity, getPendingJobsWorldChunks( &gw->chunks ) ), 10, 190, 20, BLACK );
+    DrawText( TextFormat( "culled: %d of %d (chunks %d, enemies %d, power-ups %d)",
+        gw->culledQuantity, gw->culler.count,
+        gw->renderableCount[RENDERABLE_TYPE_WORLD_CHUNK] - countVisibleFrustumCuller( &gw->culler, gw->renderableStart[RENDERABLE_TYPE_WORLD_CHUNK], gw->renderableCount[RENDERABLE_TYPE_WORLD_CHUNK] ),
+        gw->renderableCount[RENDERABLE_TYPE_ENEMY] - countVisibleFrustumCuller( &gw->culler, gw->renderableStart[RENDERABLE_TYPE_ENEMY], gw->renderableCount[RENDERABLE_TYPE_ENEMY] ),
+        gw->renderableCount[RENDERABLE_TYPE_POWER_UP] - countVisibleFrustumCuller( &gw->culler, gw->renderableStart[RENDERABLE_TYPE_POWER_UP], gw->renderableCount[RENDERABLE_TYPE_POWER_UP] ) ),
+        10, 210, 20, BLACK );
+    DrawText( TextFormat( "pvs culled: %d (%s), occlusion culled: %d",
+        gw->pvsCulledQuantity, isReadyPvs( &gw->pvs ) ? "ready" : "rebuilding", gw->occlusionCulledQuantity ), 10, 230, 20, BLACK );
+    DrawText( TextFormat( "lights: %d (max %d per cluster, %d dropped), %s quality",
+        gw->lightClusters.lightQuantity, gw->lightClusters.maxLightsInCluster, gw->lightClusters.droppedIndexes, getLightingTierName( gw->lightingTier ) ), 10, 270, 20, BLACK );
+    DrawText( TextFormat( "spheres: %d in %d draw calls", gw->spheres.instanceCount, gw->spheres.drawCalls ), 10, 250, 20, BLACK );
+    DrawText( TextFormat( "impact decals: %d of %d", getQuantityImpactDecals( &gw->impacts ), IMPACT_DECALS_CAPACITY ), 10, 290, 20, BLACK );
+    DrawText( TextFormat( "particles: %d of %d (%d dropped)", gw->particles.count, PARTICLE_SYSTEM_CAPACITY, gw->particles.droppedParticles ), 10, 310, 20, BLACK );
+    DrawText( TextFormat( "enemies: %d full, %d medium, %d impostors",
+        gw->enemyLodQuantity[ENEMY_LOD_FULL], gw->enemyLodQuantity[ENEMY_LOD_MEDIUM], gw->enemyLodQuantity[ENEMY_LOD_IMPOSTOR] ), 10, 350, 20, BLACK );
+    DrawText( TextFormat( "render queue: %d meshes, %d shader and %d texture changes, depth prepass %s",
+        gw->renderQueue.count, gw->renderQueue.shaderChanges, gw->renderQueue.textureChanges, gw->renderQueue.depthPrepass ? "on" : "off" ), 10, 370, 20, BLACK );
+    DrawText( TextFormat( "stream (%s): %d vertices in %d draw calls, %d KB, %d dropped, %d waits",
+        getStreamBufferModeName( gw->stream.mode ), gw->stream.count, gw->stream.drawCalls, gw->stream.uploadedBytes / 1024,
+        gw->stream.droppedVertices, gw->stream.fenceWaits ), 10, 390, 20, BLACK );
+    DrawText( TextFormat( "reticle: %s", gw->picking.enabled ? TextFormat( "GPU picking, %d meshes", gw->picking.drawCalls ) : "CPU raycast" ), 10, 410, 20, BLACK );
+    DrawText( gw->capture.recording ?
+        TextFormat( "capture: %s, %d frames, %d written, %d dropped", getFrameCaptureFormatName( gw->capture.format ), gw->capture.capturedFrames, getEncodedFramesFrameCapture( &gw->capture ), gw->capture.droppedFrames ) :
+        "capture: off", 10, 430, 20, BLACK );
+    drawGpuTimerInfo( gw, 10, 450 );
+    DrawText( TextFormat( "quality: %s, scene %dx%d, frame %.1f ms (work %.1f ms, gpu %s)%s",
+        getQualityLevelName( gw->governor.level ), gw->scene.width, gw->scene.height,
+        gw->governor.frameTime * 1000.0f, gw->governor.workTime * 1000.0f,
+        gw->governor.gpuTime < 0.0f ? "-" : TextFormat( "%.1f ms", gw->governor.gpuTime * 1000.0f ),
+        gw->governor.enabled ? "" : ", fixed" ), 10, 330, 20, BLACK );
+
+}
+
+void drawGpuTimerInfo( GameWorld *gw, int x, int y ) {
+
+    GpuTimer *gt = &gw->gpuTimer;
+
+    if ( !gt->enabled || gt->resultFrame < 0 ) {
+        DrawText( TextFormat( "gpu: %s", !gt->available ? "timer queries not available" : gt->enabled ? "waiting for the queries" : "off" ), x, y, 20, BLACK );
+        return;
+    }
+
+    // the GPU result is a few frames old, the work time is the current one
+    DrawText( TextFormat( "gpu: %.2f ms, %s bound (work %.2f ms), %d frames old, %d dropped",
+        gt->frameTime * 1000.0f, gt->frameTime > gw->workTime ? "GPU" : "CPU", gw->workTime * 1000.0f,
+        getResultAgeGpuTimer( gt ), gt->droppedFrames ), x, y, 20, BLACK );
+
+    char passes[256] = "passes (ms):";
+    int length = strlen( passes );
+    for ( int i = 0; i < GPU_TIMER_PASS_QUANTITY; i++ ) {
+        length += snprintf( passes + length, sizeof( passes ) - length, " %s %.2f", getGpuTimerPassName( i ), gt->passTimes[i] * 1000.0f );
+    }
+    DrawText( passes, x, y + 20, 20, BLACK );
+
+}
+
+void drawGameoverOverlay( Rectangle viewport ) {
+    DrawRectangleRec( viewport, Fade( BLACK, 0.85f ) );
     int fontSizeDead = 60;
     int fontSizeReset = 20;
     const char *tDead = "YOU DIED!";
     const char *tReset = "Start/<0> to Reset!";
     int wDead = MeasureText( tDead, fontSizeDead );
     int wReset = MeasureText( tReset, fontSizeReset );
-    DrawText( tDead, GetScreenWidth() / 2 - wDead / 2, GetScreenHeight() / 2 - fontSizeDead / 2 - 10, fontSizeDead, RED );
-    DrawText( tReset, GetScreenWidth() / 2 - wReset / 2, GetScreenHeight() / 2 - fontSizeReset / 2 + 30, fontSizeReset, RED );
+    int cx = viewport.x + viewport.width / 2;
+    int cy = viewport.y + viewport.height / 2;
+    DrawText( tDead, cx - wDead / 2, cy - fontSizeDead / 2 - 10, fontSizeDead, RED );
+    DrawText( tReset, cx - wReset / 2, cy - fontSizeReset / 2 + 30, fontSizeReset, RED );
 }
 
 void processMapFile( const char *filePath, GameWorld *gw, float blockSize, Color wallColor, Color obstacleColor, Color enemyColor, Color enemyEyeColor, Color lightColor ) {
 
     char *data = LoadFileText( filePath );
+    unsigned int mapHash = hashFnv1a( (unsigned char*) data, strlen( data ) );
     int line = 0;
     int column = 0;
     int currentY = -1;
@@ -1313,12 +2234,14 @@ void processMapFile( const char *filePath, GameWorld *gw, float blockSize, Color
     int eCounter = 0;
     int pCounter = 0;
     int lCounter = 0;
+    int ignoredMarkers = 0;
 
-    Vector3 obstaclePositions[1000];
-    Vector3 enemyPositions[100];
-    Vector3 powerUpPositions[100];
-    PowerUpType powerUpTypes[100];
-    Vector3 lightPositions[100];
+    Vector3 obstaclePositions[MAP_MAX_OBSTACLES];
+    bool breakableObstacles[MAP_MAX_OBSTACLES];
+    Vector3 enemyPositions[MAP_MAX_ENEMIES];
+    Vector3 powerUpPositions[MAP_MAX_POWER_UPS];
+    PowerUpType powerUpTypes[MAP_MAX_POWER_UPS];
+    Vector3 lightPositions[MAP_MAX_LIGHTS];
 
     while ( *data != '\0' ) {
 
@@ -1360,25 +2283,40 @@ void processMapFile( const char *filePath, GameWorld *gw, float blockSize, Color
                         line = -1;
                         break;
                     case 'O':
-                        obstaclePositions[oCounter++] = (Vector3) { 
-                            column, 
-                            currentY, 
-                            line
-                        };
+                    case 'B':
+                        if ( oCounter < MAP_MAX_OBSTACLES ) {
+                            breakableObstacles[oCounter] = c == 'B';
+                            obstaclePositions[oCounter++] = (Vector3) { 
+                                column, 
+                                currentY, 
+                                line
+                            };
+                        } else {
+                            ignoredMarkers++;
+                        }
                         break;
                     case 'E':
-                        enemyPositions[eCounter++] = (Vector3) { column, currentY, line };
+                        if ( eCounter < MAP_MAX_ENEMIES ) {
+                            enemyPositions[eCounter++] = (Vector3) { column, currentY, line };
+                        } else {
+                            ignoredMarkers++;
+                        }
                         break;
                     case 'H':
-                        powerUpPositions[pCounter] = (Vector3) { column, currentY, line };
-                        powerUpTypes[pCounter++] = POWER_UP_TYPE_HP;
-                        break;
                     case 'A':
-                        powerUpPositions[pCounter] = (Vector3) { column, currentY, line };
-                        powerUpTypes[pCounter++] = POWER_UP_TYPE_AMMO;
+                        if ( pCounter < MAP_MAX_POWER_UPS ) {
+                            powerUpPositions[pCounter] = (Vector3) { column, currentY, line };
+                            powerUpTypes[pCounter++] = c == 'H' ? POWER_UP_TYPE_HP : POWER_UP_TYPE_AMMO;
+                        } else {
+                            ignoredMarkers++;
+                        }
                         break;
                     case 'L':
-                        lightPositions[lCounter++] = (Vector3) { column, currentY, line };
+                        if ( lCounter < MAP_MAX_LIGHTS ) {
+                            lightPositions[lCounter++] = (Vector3) { column, currentY, line };
+                        } else {
+                            ignoredMarkers++;
+                        }
                         break;
                 }
 
@@ -1392,6 +2330,10 @@ void processMapFile( const char *filePath, GameWorld *gw, float blockSize, Color
 
     }
 
+    if ( ignoredMarkers > 0 ) {
+        TraceLog( LOG_WARNING, "MAP: [%s] %d markers over the limits ignored", filePath, ignoredMarkers );
+    }
+
     int groundLines = atoi( parsedData[0] );
     int groundColumns = atoi( parsedData[1] );
     int wallHeight = atoi( parsedData[2] );
@@ -1400,18 +2342,21 @@ void processMapFile( const char *filePath, GameWorld *gw, float blockSize, Color
     gw->ground = createGround( 2.0f, groundLines, groundColumns );
     createWalls( gw, wallColor, groundLines, groundColumns, wallHeight );
 
-    gw->player = createPlayer( (Vector3){
+    gw->playerStartPos = (Vector3){
         .x = (float) playerColumn,
         .y = (float) playerY,
         .z = (float) playerLine
-    });
-    gw->player.currentWeapon = &gw->player.handgun;
-    gw->player.rotationHorizontalAngle = playerStartAngle;
+    };
+    gw->playerStartAngle = playerStartAngle;
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        spawnPlayer( gw, i );
+    }
 
     createLights( gw, lightPositions, lCounter, lightColor );
     createEnemies( gw, enemyPositions, eCounter, enemyColor, enemyEyeColor );
     createPowerUps( gw, powerUpPositions, powerUpTypes, pCounter );
-    createObstacles( gw, obstaclePositions, oCounter, blockSize, obstacleColor );
+    createObstacles( gw, obstaclePositions, breakableObstacles, oCounter, blockSize, obstacleColor, gw->breakableObstacleColor );
+    createPvs( gw, filePath, mapHash );
 
 }
 
@@ -1427,17 +2372,21 @@ void processImageMapFile( const char *filePath, GameWorld *gw, float blockSize,
     int eCounter = 0;
     int pCounter = 0;
     int lCounter = 0;
+    int ignoredMarkers = 0;
 
-    Vector3 obstaclePositions[1000];
-    Vector3 enemyPositions[100];
-    Vector3 powerUpPositions[100];
-    PowerUpType powerUpTypes[100];
-    Vector3 lightPositions[100];
+    Vector3 obstaclePositions[MAP_MAX_OBSTACLES];
+    bool breakableObstacles[MAP_MAX_OBSTACLES];
+    Vector3 enemyPositions[MAP_MAX_ENEMIES];
+    Vector3 powerUpPositions[MAP_MAX_POWER_UPS];
+    PowerUpType powerUpTypes[MAP_MAX_POWER_UPS];
+    Vector3 lightPositions[MAP_MAX_LIGHTS];
 
     Image img = LoadImage( filePath );
+    unsigned int mapHash = hashFnv1a( (unsigned char*) img.data, GetPixelDataSize( img.width, img.height, img.format ) );
 
     Color playerColor = { 0, 0, 255, 255 };
     Color oColor = { 0, 255, 0, 255 };
+    Color bColor = { 0, 128, 0, 255 };
     Color eColor = { 255, 0, 0, 255 };
     Color hpColor = { 255, 255, 0, 255 };
     Color ammoColor = { 0, 255, 255, 255 };
@@ -1452,18 +2401,32 @@ void processImageMapFile( const char *filePath, GameWorld *gw, float blockSize,
                 playerLine = i;
                 playerColumn = j;
                 playerY = currentY;
-            } else if ( colorEqualsIgnoreAlpha( oColor, c ) ) {
-                obstaclePositions[oCounter++] = (Vector3) { j, currentY, i };
+            } else if ( colorEqualsIgnoreAlpha( oColor, c ) || colorEqualsIgnoreAlpha( bColor, c ) ) {
+                if ( oCounter < MAP_MAX_OBSTACLES ) {
+                    breakableObstacles[oCounter] = colorEqualsIgnoreAlpha( bColor, c );
+                    obstaclePositions[oCounter++] = (Vector3) { j, currentY, i };
+                } else {
+                    ignoredMarkers++;
+                }
             } else if ( colorEqualsIgnoreAlpha( eColor, c ) ) {
-                enemyPositions[eCounter++] = (Vector3) { j, currentY, i };
-            } else if ( colorEqualsIgnoreAlpha( hpColor, c ) ) {
-                powerUpPositions[pCounter] = (Vector3) { j, currentY, i };
-                powerUpTypes[pCounter++] = POWER_UP_TYPE_HP;
-            } else if ( colorEqualsIgnoreAlpha( ammoColor, c ) ) {
-                powerUpPositions[pCounter] = (Vector3) { j, currentY, i };
-                powerUpTypes[pCounter++] = POWER_UP_TYPE_AMMO;
+                if ( eCounter < MAP_MAX_ENEMIES ) {
+                    enemyPositions[eCounter++] = (Vector3) { j, currentY, i };
+                } else {
+                    ignoredMarkers++;
+                }
+            } else if ( colorEqualsIgnoreAlpha( hpColor, c ) || colorEqualsIgnoreAlpha( ammoColor, c ) ) {
+                if ( pCounter < MAP_MAX_POWER_UPS ) {
+                    powerUpPositions[pCounter] = (Vector3) { j, currentY, i };
+                    powerUpTypes[pCounter++] = colorEqualsIgnoreAlpha( hpColor, c ) ? POWER_UP_TYPE_HP : POWER_UP_TYPE_AMMO;
+                } else {
+                    ignoredMarkers++;
+                }
             } else if ( colorEqualsIgnoreAlpha( lColor, c ) ) {
-                lightPositions[lCounter++] = (Vector3) { j, currentY, i };
+                if ( lCounter < MAP_MAX_LIGHTS ) {
+                    lightPositions[lCounter++] = (Vector3) { j, currentY, i };
+                } else {
+                    ignoredMarkers++;
+                }
             }
 
         }
@@ -1471,6 +2434,10 @@ void processImageMapFile( const char *filePath, GameWorld *gw, float blockSize,
 
     UnloadImage( img );
 
+    if ( ignoredMarkers > 0 ) {
+        TraceLog( LOG_WARNING, "MAP: [%s] %d markers over the limits ignored", filePath, ignoredMarkers );
+    }
+
     int groundLines = img.height;
     int groundColumns = img.width;
     int wallHeight = 10;//atoi( parsedData[2] );
@@ -1479,24 +2446,27 @@ void processImageMapFile( const char *filePath, GameWorld *gw, float blockSize,
     gw->ground = createGround( 2.0f, groundLines, groundColumns );
     createWalls( gw, wallColor, groundLines, groundColumns, wallHeight );
 
-    gw->player = createPlayer( (Vector3){
+    gw->playerStartPos = (Vector3){
         .x = (float) playerColumn,
         .y = (float) playerY,
         .z = (float) playerLine
-    });
-    gw->player.currentWeapon = &gw->player.handgun;
-    gw->player.rotationHorizontalAngle = playerStartAngle;
+    };
+    gw->playerStartAngle = playerStartAngle;
+    for ( int i = 0; i < gw->playerQuantity; i++ ) {
+        spawnPlayer( gw, i );
+    }
 
     createEnemies( gw, enemyPositions, eCounter, enemyColor, enemyEyeColor );
     createPowerUps( gw, powerUpPositions, powerUpTypes, pCounter );
-    createObstacles( gw, obstaclePositions, oCounter, blockSize, obstacleColor );
     createLights( gw, lightPositions, lCounter, lightColor );
+    createObstacles( gw, obstaclePositions, breakableObstacles, oCounter, blockSize, obstacleColor, gw->breakableObstacleColor );
+    createPvs( gw, filePath, mapHash );
 
 }
 
-void updateShaders( GameWorld *gw ) {
+void updateShaders( GameWorld *gw, Camera3D camera ) {
 
-    float cameraPos[3] = { gw->camera.position.x, gw->camera.position.y, gw->camera.position.z };
+    float cameraPos[3] = { camera.position.x, camera.position.y, camera.position.z };
     SetShaderValue( gw->lightShader, gw->lightShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3 );
 
 }
@@ -1504,8 +2474,8 @@ void updateShaders( GameWorld *gw ) {
 void drawLights( GameWorld *gw ) {
 
     for ( int i = 0; i < gw->activeLights; i++ ) {
-        if ( gw->lights[i].enabled ) {
-            DrawSphereEx( gw->lights[i].position, 1.0f, 20, 20, gw->lights[i].color );
+        if ( gw->lights[i].enabled && isRenderableVisible( gw, RENDERABLE_TYPE_LIGHT, i ) ) {
+            addSphereBatch( &gw->spheres, gw->lights[i].position, 1.0f, gw->lights[i].color, 0.0f, SPHERE_BATCH_FLAG_UNLIT );
         } else {
             //DrawSphereWires( gw->lights[i].position, 1.0f, 20, 20, ColorAlpha( gw->lights[i].color, 0.3f ) );
         }
@@ -1534,6 +2504,13 @@ void drawInputHelp( GameWorld *gw ) {
 
     const char *helpText = "Help:\n"
                            "<F1>: show/hide this help;\n"
+                           "<F2>: on/off adaptive quality;\n"
+                           "<F3>: on/off depth prepass;\n"
+                           "<F4>: on/off GPU picking for the reticle;\n"
+                           "<F5>/<F6>/<F7>: start/stop recording (raw/png/ffmpeg);\n"
+                           "<F8>: on/off GPU pass timers;\n"
+                           "<F9>: switch local players (1 to 4, split screen);\n"
+                           "<F10>: on/off occlusion culling of enemies and power-ups;\n"
                            "<1>: show/hide debug info;\n"
                            "<2>: show/hide walls;\n"
                            "<3>: show/hide collision probes;\n"
@@ -1542,6 +2519,7 @@ void drawInputHelp( GameWorld *gw ) {
                            "<6>: on/off immortal player;\n"
                            "<7>: switch maps (test/stage);\n"
                            "<8>: on/off lights;\n"
+                           "<9>: switch lighting quality (high/medium/low);\n"
                            "<0>: reset game world;\n"
                            "<TAB>: switch input type (gamepad/keyboard+mouse)."
                            ;
@@ -1549,8 +2527,15 @@ void drawInputHelp( GameWorld *gw ) {
     int margin = 10;
     int x = 500;
     int width = GetScreenWidth() - x;
-    DrawRectangle( x - margin, margin, width, 160, Fade( WHITE, 0.7f ) );
-    DrawText( helpText, x, margin + 10, 10, BLACK );
+    DrawRectangle( x - margin, margin, width, 256, Fade( WHITE, 0.7f ) );
+
+    // the text never changes, it is only laid out again if the screen is resized
+    if ( beginHudPanel( &gw->helpPanel, width - margin, 236, NULL, 0 ) ) {
+        DrawText( helpText, 0, 0, 10, BLACK );
+        endHudPanel( &gw->helpPanel );
+    }
+
+    drawHudPanel( &gw->helpPanel, x, margin + 10 );
 
 }
 
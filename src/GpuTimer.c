@@ -0,0 +1,186 @@
+/**
+ * @file GpuTimer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief GpuTimer implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "GpuTimer.h"
+#include "GlFunctions.h"
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+#define TIMESTAMP 0x8E28                    // GL_TIMESTAMP
+#define QUERY_RESULT 0x8866                 // GL_QUERY_RESULT
+#define QUERY_RESULT_AVAILABLE 0x8867       // GL_QUERY_RESULT_AVAILABLE
+
+static void readFrame( GpuTimer *gt, GpuTimerFrame *frame );
+
+void initGpuTimer( GpuTimer *gt ) {
+
+    *gt = (GpuTimer){
+        .initialized = true,
+        .resultFrame = -1
+    };
+
+#ifndef __EMSCRIPTEN__
+    int version = rlGetVersion();
+    gt->available = ( version == RL_OPENGL_33 || version == RL_OPENGL_43 ) &&
+                    glad_glGenQueries != NULL && glad_glQueryCounter != NULL && glad_glGetQueryObjectui64v != NULL;
+#endif
+
+    if ( !gt->available ) {
+        TraceLog( LOG_WARNING, "GPU TIMER: Timer queries not available, the passes won't be measured" );
+        return;
+    }
+
+#ifndef __EMSCRIPTEN__
+    for ( int i = 0; i < GPU_TIMER_FRAMES; i++ ) {
+        glad_glGenQueries( GPU_TIMER_MAX_MARKS, gt->frames[i].queries );
+    }
+#endif
+
+}
+
+void destroyGpuTimer( GpuTimer *gt ) {
+
+    if ( !gt->initialized ) {
+        return;
+    }
+
+#ifndef __EMSCRIPTEN__
+    if ( gt->available ) {
+        for ( int i = 0; i < GPU_TIMER_FRAMES; i++ ) {
+            glad_glDeleteQueries( GPU_TIMER_MAX_MARKS, gt->frames[i].queries );
+        }
+    }
+#endif
+
+    *gt = (GpuTimer){ 0 };
+
+}
+
+void setEnabledGpuTimer( GpuTimer *gt, bool enabled ) {
+
+    gt->enabled = enabled && gt->available;
+
+    // the queries in flight may never be finished
+    for ( int i = 0; i < GPU_TIMER_FRAMES; i++ ) {
+        gt->frames[i].markCount = 0;
+    }
+    gt->resultFrame = -1;
+    gt->droppedFrames = 0;
+
+}
+
+void beginGpuTimer( GpuTimer *gt ) {
+
+    if ( !gt->enabled ) {
+        return;
+    }
+
+    // the queries of this slot were made GPU_TIMER_FRAMES frames ago
+    GpuTimerFrame *frame = &gt->frames[gt->current];
+
+    if ( frame->markCount > 1 ) {
+        readFrame( gt, frame );
+    }
+
+    frame->markCount = 0;
+    frame->number = gt->frameNumber++;
+
+}
+
+void markGpuTimer( GpuTimer *gt, GpuTimerPass pass ) {
+
+    if ( !gt->enabled ) {
+        return;
+    }
+
+    GpuTimerFrame *frame = &gt->frames[gt->current];
+
+    if ( frame->markCount == GPU_TIMER_MAX_MARKS ) {
+        return;
+    }
+
+    // what was batched so far belongs to the previous pass
+    rlDrawRenderBatchActive();
+
+#ifndef __EMSCRIPTEN__
+    glad_glQueryCounter( frame->queries[frame->markCount], TIMESTAMP );
+#endif
+    frame->passes[frame->markCount] = pass;
+    frame->markCount++;
+
+}
+
+void endGpuTimer( GpuTimer *gt ) {
+
+    if ( !gt->enabled ) {
+        return;
+    }
+
+    // closes the last pass, this mark starts nothing
+    markGpuTimer( gt, GPU_TIMER_PASS_QUANTITY );
+    gt->current = ( gt->current + 1 ) % GPU_TIMER_FRAMES;
+
+}
+
+int getResultAgeGpuTimer( GpuTimer *gt ) {
+    return gt->resultFrame < 0 ? -1 : gt->frameNumber - 1 - gt->resultFrame;
+}
+
+const char *getGpuTimerPassName( GpuTimerPass pass ) {
+
+    switch ( pass ) {
+        case GPU_TIMER_PASS_PICKING: return "picking";
+        case GPU_TIMER_PASS_WORLD: return "world";
+        case GPU_TIMER_PASS_LIGHTS: return "lights";
+        case GPU_TIMER_PASS_ENTITIES: return "entities";
+        case GPU_TIMER_PASS_BILLBOARDS: return "billboards";
+        case GPU_TIMER_PASS_HUD: return "hud";
+        case GPU_TIMER_PASS_OVERLAYS: return "overlays";
+        default: return "unknown";
+    }
+
+}
+
+static void readFrame( GpuTimer *gt, GpuTimerFrame *frame ) {
+
+#ifndef __EMSCRIPTEN__
+
+    // the queries finish in order, so the last one is enough
+    int available = 0;
+    glad_glGetQueryObjectiv( frame->queries[frame->markCount - 1], QUERY_RESULT_AVAILABLE, &available );
+
+    if ( !available ) {
+        gt->droppedFrames++;
+        return;
+    }
+
+    uint64_t timestamps[GPU_TIMER_MAX_MARKS];
+    for ( int i = 0; i < frame->markCount; i++ ) {
+        glad_glGetQueryObjectui64v( frame->queries[i], QUERY_RESULT, &timestamps[i] );
+    }
+
+    for ( int i = 0; i < GPU_TIMER_PASS_QUANTITY; i++ ) {
+        gt->passTimes[i] = 0.0f;
+    }
+
+    for ( int i = 0; i < frame->markCount - 1; i++ ) {
+        gt->passTimes[frame->passes[i]] += ( timestamps[i + 1] - timestamps[i] ) / 1e9f;
+    }
+
+    gt->frameTime = ( timestamps[frame->markCount - 1] - timestamps[0] ) / 1e9f;
+    gt->resultFrame = frame->number;
+
+#else
+    ( void ) gt;
+    ( void ) frame;
+#endif
+
+}
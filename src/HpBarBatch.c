@@ -0,0 +1,180 @@
+/**
+ * @file HpBarBatch.c
+ * @author Prof. Dr. David Buzatto
+ * @brief HpBarBatch implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "HpBarBatch.h"
+#include "Frustum.h"
+#include "StreamBuffer.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define HP_BAR_BATCH_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+// size of the bar, in pixels, at one unit of depth
+static const float BAR_WIDTH = 1200.0f;
+static const float BAR_HEIGHT = 200.0f;
+
+// bars closer than this are behind the camera or too big to make sense
+static const float MIN_DEPTH = 0.1f;
+
+static void projectHpBars( HpBarBatch *hb, Matrix m, float halfWidth, float halfHeight );
+
+void destroyHpBarBatch( HpBarBatch *hb ) {
+    free( hb->anchorX );
+    free( hb->anchorY );
+    free( hb->anchorZ );
+    free( hb->fill );
+    free( hb->screenX );
+    free( hb->screenY );
+    free( hb->depth );
+    *hb = (HpBarBatch){ 0 };
+}
+
+void beginHpBarBatch( HpBarBatch *hb ) {
+    hb->count = 0;
+}
+
+void addHpBarBatch( HpBarBatch *hb, Vector3 anchor, float fill ) {
+
+    if ( hb->count == hb->capacity ) {
+
+        // always a multiple of four, so the last group can be loaded whole
+        int capacity = hb->capacity == 0 ? 16 : hb->capacity * 2;
+
+        hb->anchorX = (float*) realloc( hb->anchorX, capacity * sizeof( float ) );
+        hb->anchorY = (float*) realloc( hb->anchorY, capacity * sizeof( float ) );
+        hb->anchorZ = (float*) realloc( hb->anchorZ, capacity * sizeof( float ) );
+        hb->fill = (float*) realloc( hb->fill, capacity * sizeof( float ) );
+        hb->screenX = (float*) realloc( hb->screenX, capacity * sizeof( float ) );
+        hb->screenY = (float*) realloc( hb->screenY, capacity * sizeof( float ) );
+        hb->depth = (float*) realloc( hb->depth, capacity * sizeof( float ) );
+
+        for ( int i = hb->capacity; i < capacity; i++ ) {
+            hb->anchorX[i] = hb->anchorY[i] = hb->anchorZ[i] = 0.0f;
+        }
+
+        hb->capacity = capacity;
+
+    }
+
+    int i = hb->count++;
+
+    hb->anchorX[i] = anchor.x;
+    hb->anchorY[i] = anchor.y;
+    hb->anchorZ[i] = anchor.z;
+    hb->fill[i] = Clamp( fill, 0.0f, 1.0f );
+
+}
+
+void drawHpBarBatch( HpBarBatch *hb, StreamBuffer *sb, Camera3D camera, Rectangle viewport ) {
+
+    hb->drawnQuantity = 0;
+
+    if ( hb->count == 0 ) {
+        return;
+    }
+
+    Matrix m = getViewProjectionFromCamera( camera, viewport.width / viewport.height );
+    projectHpBars( hb, m, viewport.width / 2.0f, viewport.height / 2.0f );
+
+    for ( int i = 0; i < hb->count; i++ ) {
+
+        if ( hb->depth[i] < MIN_DEPTH ) {
+            continue;
+        }
+
+        float width = BAR_WIDTH / hb->depth[i];
+        float height = (int) ( BAR_HEIGHT / hb->depth[i] );
+        float x = (int) ( hb->screenX[i] - width / 2 );
+        float y = (int) ( hb->screenY[i] - height / 2 );
+
+        if ( x + width < 0 || y + height < 0 || x > viewport.width || y > viewport.height ) {
+            continue;
+        }
+
+        x += viewport.x;
+        y += viewport.y;
+
+        // the fill and a one pixel border, as DrawRectangle and DrawRectangleLines
+        addRectangleStreamBuffer( sb, x, y, (int) ( width * hb->fill[i] ), height, RED );
+        addRectangleStreamBuffer( sb, x, y, width, 1, BLACK );
+        addRectangleStreamBuffer( sb, x, y + height - 1, width, 1, BLACK );
+        addRectangleStreamBuffer( sb, x, y + 1, 1, height - 2, BLACK );
+        addRectangleStreamBuffer( sb, x + width - 1, y + 1, 1, height - 2, BLACK );
+
+        hb->drawnQuantity++;
+
+    }
+
+    drawStreamBuffer( sb );
+
+}
+
+// clip = m * ( x, y, z, 1 ), as in GetWorldToScreen; the depth is the w
+// of the clip coordinates, the distance along the view direction
+static void projectHpBars( HpBarBatch *hb, Matrix m, float halfWidth, float halfHeight ) {
+
+#ifdef HP_BAR_BATCH_USE_SSE
+
+    const __m128 m0 = _mm_set1_ps( m.m0 ), m4 = _mm_set1_ps( m.m4 ), m8 = _mm_set1_ps( m.m8 ), m12 = _mm_set1_ps( m.m12 );
+    const __m128 m1 = _mm_set1_ps( m.m1 ), m5 = _mm_set1_ps( m.m5 ), m9 = _mm_set1_ps( m.m9 ), m13 = _mm_set1_ps( m.m13 );
+    const __m128 m3 = _mm_set1_ps( m.m3 ), m7 = _mm_set1_ps( m.m7 ), m11 = _mm_set1_ps( m.m11 ), m15 = _mm_set1_ps( m.m15 );
+    const __m128 hw = _mm_set1_ps( halfWidth );
+    const __m128 hh = _mm_set1_ps( halfHeight );
+    const __m128 minDepth = _mm_set1_ps( MIN_DEPTH );
+
+    for ( int i = 0; i < hb->count; i += 4 ) {
+
+        __m128 x = _mm_loadu_ps( hb->anchorX + i );
+        __m128 y = _mm_loadu_ps( hb->anchorY + i );
+        __m128 z = _mm_loadu_ps( hb->anchorZ + i );
+
+        __m128 cx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m0, x ), _mm_mul_ps( m4, y ) ), _mm_add_ps( _mm_mul_ps( m8, z ), m12 ) );
+        __m128 cy = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m1, x ), _mm_mul_ps( m5, y ) ), _mm_add_ps( _mm_mul_ps( m9, z ), m13 ) );
+        __m128 cw = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m3, x ), _mm_mul_ps( m7, y ) ), _mm_add_ps( _mm_mul_ps( m11, z ), m15 ) );
+
+        // the bars behind the camera are skipped later, only avoid the division by zero
+        __m128 invW = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_max_ps( cw, minDepth ) );
+
+        // screen = ( ndc.x + 1, 1 - ndc.y ) * half size
+        __m128 sx = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( cx, invW ), _mm_set1_ps( 1.0f ) ), hw );
+        __m128 sy = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), _mm_mul_ps( cy, invW ) ), hh );
+
+        // the arrays are multiples of four long, so the last group is stored whole
+        _mm_storeu_ps( hb->screenX + i, sx );
+        _mm_storeu_ps( hb->screenY + i, sy );
+        _mm_storeu_ps( hb->depth + i, cw );
+
+    }
+
+#else
+
+    for ( int i = 0; i < hb->count; i++ ) {
+
+        float x = hb->anchorX[i];
+        float y = hb->anchorY[i];
+        float z = hb->anchorZ[i];
+
+        float cx = m.m0 * x + m.m4 * y + m.m8 * z + m.m12;
+        float cy = m.m1 * x + m.m5 * y + m.m9 * z + m.m13;
+        float cw = m.m3 * x + m.m7 * y + m.m11 * z + m.m15;
+        float invW = 1.0f / ( cw > MIN_DEPTH ? cw : MIN_DEPTH );
+
+        hb->screenX[i] = ( cx * invW + 1.0f ) * halfWidth;
+        hb->screenY[i] = ( 1.0f - cy * invW ) * halfHeight;
+        hb->depth[i] = cw;
+
+    }
+
+#endif
+
+}
@@ -0,0 +1,69 @@
+/**
+ * @file HudPanel.c
+ * @author Prof. Dr. David Buzatto
+ * @brief HudPanel implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdbool.h>
+#include <string.h>
+
+#include "HudPanel.h"
+#include "raylib/raylib.h"
+
+bool beginHudPanel( HudPanel *panel, int width, int height, const int *key, int keyLength ) {
+
+    bool resized = panel->target.id == 0 || panel->target.texture.width != width || panel->target.texture.height != height;
+    bool sameKey = keyLength <= HUD_PANEL_KEY_CAPACITY && keyLength == panel->keyLength &&
+                   ( keyLength == 0 || memcmp( panel->key, key, keyLength * sizeof( int ) ) == 0 );
+
+    if ( panel->valid && !resized && sameKey ) {
+        return false;
+    }
+
+    if ( resized ) {
+        unloadHudPanel( panel );
+        panel->target = LoadRenderTexture( width, height );
+    }
+
+    // a longer key is never matched, the panel is redrawn every frame
+    if ( keyLength > 0 ) {
+        memcpy( panel->key, key, ( keyLength <= HUD_PANEL_KEY_CAPACITY ? keyLength : HUD_PANEL_KEY_CAPACITY ) * sizeof( int ) );
+    }
+    panel->keyLength = keyLength;
+    panel->valid = true;
+    panel->redrawCount++;
+
+    BeginTextureMode( panel->target );
+    ClearBackground( BLANK );
+
+    return true;
+
+}
+
+void endHudPanel( HudPanel *panel ) {
+    EndTextureMode();
+}
+
+void drawHudPanel( HudPanel *panel, int x, int y ) {
+
+    if ( !panel->valid ) {
+        return;
+    }
+
+    // render textures are upside down
+    Texture2D texture = panel->target.texture;
+    DrawTextureRec( texture, (Rectangle){ 0, 0, texture.width, -texture.height }, (Vector2){ x, y }, WHITE );
+
+}
+
+void unloadHudPanel( HudPanel *panel ) {
+
+    if ( panel->target.id != 0 ) {
+        UnloadRenderTexture( panel->target );
+    }
+
+    panel->target = (RenderTexture2D){ 0 };
+    panel->valid = false;
+
+}
@@ -0,0 +1,234 @@
+/**
+ * @file ImpactDecals.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ImpactDecals implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ImpactDecals.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+static Mesh genQuadMesh( void );
+static void markDirtyImpactDecal( ImpactDecals *id, int index );
+static void drawImpactDecalsImmediate( ImpactDecals *id );
+
+void initImpactDecals( ImpactDecals *id, Shader shader ) {
+
+    *id = (ImpactDecals){
+        .initialized = true,
+        .data = (ImpactDecal*) calloc( IMPACT_DECALS_CAPACITY, sizeof( ImpactDecal ) ),
+        .dirtyStart = IMPACT_DECALS_CAPACITY,
+        .dirtyEnd = 0,
+        .shader = shader,
+        .instancing = shader.id != 0 && shader.id != rlGetShaderIdDefault()
+    };
+
+    if ( id->instancing ) {
+        id->timeLoc = GetShaderLocation( shader, "time" );
+        id->fadeLoc = GetShaderLocation( shader, "fade" );
+        id->instancePositionLoc = GetShaderLocationAttrib( shader, "instancePosition" );
+        id->instanceNormalLoc = GetShaderLocationAttrib( shader, "instanceNormal" );
+        id->instanceColorLoc = GetShaderLocationAttrib( shader, "instanceColor" );
+        id->instancing = id->instancePositionLoc >= 0 && id->instanceNormalLoc >= 0 && id->instanceColorLoc >= 0;
+    }
+
+    if ( !id->instancing ) {
+        TraceLog( LOG_WARNING, "DECALS: Instancing shader not available, decals will be drawn one by one" );
+        return;
+    }
+
+    id->quad = genQuadMesh();
+    id->vboId = rlLoadVertexBuffer( id->data, IMPACT_DECALS_CAPACITY * sizeof( ImpactDecal ), true );
+
+    // the instance attributes live in the vertex array of the quad
+    rlEnableVertexArray( id->quad.vaoId );
+    rlEnableVertexBuffer( id->vboId );
+
+    rlSetVertexAttribute( id->instancePositionLoc, 4, RL_FLOAT, false, sizeof( ImpactDecal ), 0 );
+    rlSetVertexAttributeDivisor( id->instancePositionLoc, 1 );
+    rlEnableVertexAttribute( id->instancePositionLoc );
+
+    rlSetVertexAttribute( id->instanceNormalLoc, 4, RL_FLOAT, false, sizeof( ImpactDecal ), 4 * sizeof( float ) );
+    rlSetVertexAttributeDivisor( id->instanceNormalLoc, 1 );
+    rlEnableVertexAttribute( id->instanceNormalLoc );
+
+    rlSetVertexAttribute( id->instanceColorLoc, 4, RL_UNSIGNED_BYTE, true, sizeof( ImpactDecal ), 8 * sizeof( float ) );
+    rlSetVertexAttributeDivisor( id->instanceColorLoc, 1 );
+    rlEnableVertexAttribute( id->instanceColorLoc );
+
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+
+}
+
+void destroyImpactDecals( ImpactDecals *id ) {
+
+    if ( !id->initialized ) {
+        return;
+    }
+
+    if ( id->instancing ) {
+        UnloadMesh( id->quad );
+        rlUnloadVertexBuffer( id->vboId );
+    }
+
+    free( id->data );
+
+    *id = (ImpactDecals){ 0 };
+
+}
+
+void clearImpactDecals( ImpactDecals *id ) {
+
+    memset( id->data, 0, IMPACT_DECALS_CAPACITY * sizeof( ImpactDecal ) );
+    id->count = 0;
+    id->time = 0.0f;
+    id->dirtyStart = 0;
+    id->dirtyEnd = IMPACT_DECALS_CAPACITY;
+
+}
+
+void addImpactDecal( ImpactDecals *id, Vector3 pos, Vector3 normal, float size, Color color ) {
+
+    int index = id->count % IMPACT_DECALS_CAPACITY;
+
+    id->data[index] = (ImpactDecal){
+        .pos = pos,
+        .size = size,
+        .normal = Vector3Normalize( normal ),
+        .time = id->time,
+        .color = color
+    };
+
+    id->count++;
+    markDirtyImpactDecal( id, index );
+
+}
+
+void removeImpactDecalsInBox( ImpactDecals *id, BoundingBox box ) {
+
+    int quantity = getQuantityImpactDecals( id );
+
+    for ( int i = 0; i < quantity; i++ ) {
+        ImpactDecal *decal = &id->data[i];
+        if ( decal->size != 0.0f && CheckCollisionBoxSphere( box, decal->pos, decal->size / 2 ) ) {
+            decal->size = 0.0f;
+            markDirtyImpactDecal( id, i );
+        }
+    }
+
+}
+
+void updateImpactDecals( ImpactDecals *id, float delta ) {
+    id->time += delta;
+}
+
+int getQuantityImpactDecals( ImpactDecals *id ) {
+    return id->count < IMPACT_DECALS_CAPACITY ? id->count : IMPACT_DECALS_CAPACITY;
+}
+
+void drawImpactDecals( ImpactDecals *id ) {
+
+    int quantity = getQuantityImpactDecals( id );
+
+    if ( quantity == 0 ) {
+        return;
+    }
+
+    if ( !id->instancing ) {
+        drawImpactDecalsImmediate( id );
+        return;
+    }
+
+    if ( id->dirtyStart < id->dirtyEnd ) {
+        rlUpdateVertexBuffer( id->vboId, &id->data[id->dirtyStart], ( id->dirtyEnd - id->dirtyStart ) * sizeof( ImpactDecal ), id->dirtyStart * sizeof( ImpactDecal ) );
+        id->dirtyStart = IMPACT_DECALS_CAPACITY;
+        id->dirtyEnd = 0;
+    }
+
+    // anything pending in the immediate mode batch must be drawn first
+    rlDrawRenderBatchActive();
+
+    rlEnableShader( id->shader.id );
+
+    Matrix mvp = MatrixMultiply( rlGetMatrixModelview(), rlGetMatrixProjection() );
+    rlSetUniformMatrix( id->shader.locs[SHADER_LOC_MATRIX_MVP], mvp );
+    rlSetUniform( id->timeLoc, &id->time, RL_SHADER_UNIFORM_FLOAT, 1 );
+    rlSetUniform( id->fadeLoc, (float[2]){ IMPACT_DECALS_LIFETIME, IMPACT_DECALS_FADE_TIME }, RL_SHADER_UNIFORM_VEC2, 1 );
+
+    // the decals are blended over the surfaces and don't hide each other
+    rlDisableDepthMask();
+    rlEnableVertexArray( id->quad.vaoId );
+    rlDrawVertexArrayInstanced( 0, id->quad.vertexCount, quantity );
+    rlDisableVertexArray();
+    rlEnableDepthMask();
+
+    rlDisableShader();
+
+}
+
+// two triangles facing +z, the vertex shader aligns them to the surfaces
+static Mesh genQuadMesh( void ) {
+
+    static const float positions[] = {
+        -0.5f, -0.5f, 0.0f,   0.5f, -0.5f, 0.0f,   0.5f, 0.5f, 0.0f,
+        -0.5f, -0.5f, 0.0f,   0.5f, 0.5f, 0.0f,   -0.5f, 0.5f, 0.0f
+    };
+
+    static const float texcoords[] = {
+        0.0f, 0.0f,   1.0f, 0.0f,   1.0f, 1.0f,
+        0.0f, 0.0f,   1.0f, 1.0f,   0.0f, 1.0f
+    };
+
+    Mesh mesh = {
+        .vertexCount = 6,
+        .triangleCount = 2,
+        .vertices = (float*) MemAlloc( sizeof( positions ) ),
+        .texcoords = (float*) MemAlloc( sizeof( texcoords ) )
+    };
+
+    memcpy( mesh.vertices, positions, sizeof( positions ) );
+    memcpy( mesh.texcoords, texcoords, sizeof( texcoords ) );
+    UploadMesh( &mesh, false );
+
+    return mesh;
+
+}
+
+static void markDirtyImpactDecal( ImpactDecals *id, int index ) {
+
+    if ( index < id->dirtyStart ) {
+        id->dirtyStart = index;
+    }
+
+    if ( index + 1 > id->dirtyEnd ) {
+        id->dirtyEnd = index + 1;
+    }
+
+}
+
+static void drawImpactDecalsImmediate( ImpactDecals *id ) {
+
+    int quantity = getQuantityImpactDecals( id );
+
+    for ( int i = 0; i < quantity; i++ ) {
+
+        ImpactDecal *decal = &id->data[i];
+        float age = id->time - decal->time;
+
+        if ( decal->size == 0.0f || age >= IMPACT_DECALS_LIFETIME ) {
+            continue;
+        }
+
+        float alpha = Clamp( ( IMPACT_DECALS_LIFETIME - age ) / IMPACT_DECALS_FADE_TIME, 0.0f, 1.0f );
+        DrawSphereEx( decal->pos, decal->size / 2, 4, 4, Fade( decal->color, alpha ) );
+
+    }
+
+}
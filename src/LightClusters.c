@@ -0,0 +1,290 @@
+/**
+ * @file LightClusters.c
+ * @author Prof. Dr. David Buzatto
+ * @brief LightClusters implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "LightClusters.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+#define LIGHT_CLUSTERS_INDEX_ROWS ( ( LIGHT_CLUSTERS_QUANTITY * LIGHT_CLUSTERS_MAX_LIGHTS_PER_CLUSTER + LIGHT_CLUSTERS_INDEX_WIDTH - 1 ) / LIGHT_CLUSTERS_INDEX_WIDTH )
+
+// texture units used by the cluster textures, above the ones used by the
+// material maps and by the rlgl batch
+static const int LIGHT_DATA_UNIT = 13;
+static const int CLUSTER_DATA_UNIT = 14;
+static const int LIGHT_INDICES_UNIT = 15;
+
+static void computeClusterBounds( LightClusters *lc, float fovy, float aspect );
+static float getSliceDepth( int slice );
+static int getDepthSlice( float depth );
+
+void initLightClusters( LightClusters *lc, Shader shader ) {
+
+    *lc = (LightClusters){
+        .initialized = true,
+        .lightData = (float*) calloc( LIGHT_CLUSTERS_MAX_LIGHTS * 2 * 4, sizeof( float ) ),
+        .clusterData = (float*) calloc( LIGHT_CLUSTERS_QUANTITY * 4, sizeof( float ) ),
+        .lightIndices = (float*) calloc( LIGHT_CLUSTERS_INDEX_ROWS * LIGHT_CLUSTERS_INDEX_WIDTH, sizeof( float ) ),
+        .binnedLights = (int*) malloc( LIGHT_CLUSTERS_QUANTITY * LIGHT_CLUSTERS_MAX_LIGHTS_PER_CLUSTER * sizeof( int ) ),
+        .binnedCounts = (int*) calloc( LIGHT_CLUSTERS_QUANTITY, sizeof( int ) ),
+        .clusterBounds = (BoundingBox*) malloc( LIGHT_CLUSTERS_QUANTITY * sizeof( BoundingBox ) )
+    };
+
+    lc->lightDataTextureId = rlLoadTexture( lc->lightData, LIGHT_CLUSTERS_MAX_LIGHTS * 2, 1, RL_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1 );
+    lc->clusterDataTextureId = rlLoadTexture( lc->clusterData, LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y, LIGHT_CLUSTERS_Z, RL_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1 );
+    lc->lightIndicesTextureId = rlLoadTexture( lc->lightIndices, LIGHT_CLUSTERS_INDEX_WIDTH, LIGHT_CLUSTERS_INDEX_ROWS, RL_PIXELFORMAT_UNCOMPRESSED_R32, 1 );
+
+    if ( lc->lightDataTextureId == 0 || lc->clusterDataTextureId == 0 || lc->lightIndicesTextureId == 0 ) {
+        TraceLog( LOG_WARNING, "LIGHTS: Float textures not available, clustered lighting disabled" );
+    }
+
+    setShaderLightClusters( lc, shader );
+
+}
+
+void setShaderLightClusters( LightClusters *lc, Shader shader ) {
+
+    lc->shader = shader;
+    lc->lightDataLoc = GetShaderLocation( shader, "lightData" );
+    lc->clusterDataLoc = GetShaderLocation( shader, "clusterData" );
+    lc->lightIndicesLoc = GetShaderLocation( shader, "lightIndices" );
+    lc->clusterGridLoc = GetShaderLocation( shader, "clusterGrid" );
+    lc->clusterDepthLoc = GetShaderLocation( shader, "clusterDepth" );
+    lc->clusterViewportLoc = GetShaderLocation( shader, "clusterViewport" );
+    lc->viewForwardLoc = GetShaderLocation( shader, "viewForward" );
+    lc->lightCountLoc = GetShaderLocation( shader, "lightCount" );
+
+    SetShaderValue( shader, lc->lightDataLoc, &LIGHT_DATA_UNIT, SHADER_UNIFORM_INT );
+    SetShaderValue( shader, lc->clusterDataLoc, &CLUSTER_DATA_UNIT, SHADER_UNIFORM_INT );
+    SetShaderValue( shader, lc->lightIndicesLoc, &LIGHT_INDICES_UNIT, SHADER_UNIFORM_INT );
+
+    float grid[3] = { LIGHT_CLUSTERS_X, LIGHT_CLUSTERS_Y, LIGHT_CLUSTERS_Z };
+    SetShaderValue( shader, lc->clusterGridLoc, grid, SHADER_UNIFORM_VEC3 );
+
+    // slice = log( depth / near ) * slices / log( far / near )
+    float depth[2] = { LIGHT_CLUSTERS_NEAR, LIGHT_CLUSTERS_Z / logf( LIGHT_CLUSTERS_FAR / LIGHT_CLUSTERS_NEAR ) };
+    SetShaderValue( shader, lc->clusterDepthLoc, depth, SHADER_UNIFORM_VEC2 );
+
+}
+
+void destroyLightClusters( LightClusters *lc ) {
+
+    if ( !lc->initialized ) {
+        return;
+    }
+
+    rlUnloadTexture( lc->lightDataTextureId );
+    rlUnloadTexture( lc->clusterDataTextureId );
+    rlUnloadTexture( lc->lightIndicesTextureId );
+
+    free( lc->lightData );
+    free( lc->clusterData );
+    free( lc->lightIndices );
+    free( lc->binnedLights );
+    free( lc->binnedCounts );
+    free( lc->clusterBounds );
+
+    *lc = (LightClusters){ 0 };
+
+}
+
+void updateLightClusters( LightClusters *lc, Camera3D camera, Rectangle viewport, Light *lights, int lightQuantity, float lightRadius ) {
+
+    float aspect = viewport.width / viewport.height;
+
+    if ( camera.fovy != lc->boundsFovy || aspect != lc->boundsAspect ) {
+        computeClusterBounds( lc, camera.fovy, aspect );
+    }
+
+    lc->viewport = viewport;
+
+    Vector3 forward = Vector3Normalize( Vector3Subtract( camera.target, camera.position ) );
+    Vector3 right = Vector3Normalize( Vector3CrossProduct( forward, camera.up ) );
+    Vector3 up = Vector3CrossProduct( right, forward );
+    lc->viewForward = forward;
+
+    for ( int i = 0; i < LIGHT_CLUSTERS_QUANTITY; i++ ) {
+        lc->binnedCounts[i] = 0;
+    }
+
+    lc->lightQuantity = 0;
+    lc->droppedIndexes = 0;
+
+    for ( int i = 0; i < lightQuantity && lc->lightQuantity < LIGHT_CLUSTERS_MAX_LIGHTS; i++ ) {
+
+        Light *light = &lights[i];
+
+        if ( !light->enabled ) {
+            continue;
+        }
+
+        int index = lc->lightQuantity++;
+        float *data = &lc->lightData[index * 8];
+
+        data[0] = light->position.x;
+        data[1] = light->position.y;
+        data[2] = light->position.z;
+        data[3] = lightRadius;
+        data[4] = light->color.r / 255.0f;
+        data[5] = light->color.g / 255.0f;
+        data[6] = light->color.b / 255.0f;
+        data[7] = 1.0f;
+
+        // light center in view space, z growing away from the camera
+        Vector3 v = Vector3Subtract( light->position, camera.position );
+        Vector3 c = { Vector3DotProduct( v, right ), Vector3DotProduct( v, up ), Vector3DotProduct( v, forward ) };
+
+        if ( c.z + lightRadius <= 0.0f ) {
+            continue;
+        }
+
+        int minSlice = getDepthSlice( c.z - lightRadius );
+        int maxSlice = getDepthSlice( c.z + lightRadius );
+        float radiusSqr = lightRadius * lightRadius;
+
+        for ( int z = minSlice; z <= maxSlice; z++ ) {
+            for ( int t = 0; t < LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y; t++ ) {
+
+                int cluster = z * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y + t;
+                BoundingBox *b = &lc->clusterBounds[cluster];
+
+                Vector3 closest = Vector3Clamp( c, b->min, b->max );
+                if ( Vector3DistanceSqr( c, closest ) > radiusSqr ) {
+                    continue;
+                }
+
+                if ( lc->binnedCounts[cluster] == LIGHT_CLUSTERS_MAX_LIGHTS_PER_CLUSTER ) {
+                    lc->droppedIndexes++;
+                    continue;
+                }
+
+                lc->binnedLights[cluster * LIGHT_CLUSTERS_MAX_LIGHTS_PER_CLUSTER + lc->binnedCounts[cluster]++] = index;
+
+            }
+        }
+
+    }
+
+    // packs the lights of each cluster one after the other
+    lc->indexQuantity = 0;
+    lc->maxLightsInCluster = 0;
+
+    for ( int i = 0; i < LIGHT_CLUSTERS_QUANTITY; i++ ) {
+
+        int count = lc->binnedCounts[i];
+
+        lc->clusterData[i * 4] = lc->indexQuantity;
+        lc->clusterData[i * 4 + 1] = count;
+
+        for ( int j = 0; j < count; j++ ) {
+            lc->lightIndices[lc->indexQuantity++] = lc->binnedLights[i * LIGHT_CLUSTERS_MAX_LIGHTS_PER_CLUSTER + j];
+        }
+
+        if ( count > lc->maxLightsInCluster ) {
+            lc->maxLightsInCluster = count;
+        }
+
+    }
+
+    if ( lc->lightQuantity > 0 ) {
+        rlUpdateTexture( lc->lightDataTextureId, 0, 0, lc->lightQuantity * 2, 1, RL_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, lc->lightData );
+    }
+
+    rlUpdateTexture( lc->clusterDataTextureId, 0, 0, LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y, LIGHT_CLUSTERS_Z, RL_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, lc->clusterData );
+
+    if ( lc->indexQuantity > 0 ) {
+        int rows = ( lc->indexQuantity + LIGHT_CLUSTERS_INDEX_WIDTH - 1 ) / LIGHT_CLUSTERS_INDEX_WIDTH;
+        rlUpdateTexture( lc->lightIndicesTextureId, 0, 0, LIGHT_CLUSTERS_INDEX_WIDTH, rows, RL_PIXELFORMAT_UNCOMPRESSED_R32, lc->lightIndices );
+    }
+
+}
+
+void bindLightClusters( LightClusters *lc ) {
+
+    float viewport[4] = { lc->viewport.x, lc->viewport.y, lc->viewport.width, lc->viewport.height };
+    SetShaderValue( lc->shader, lc->clusterViewportLoc, viewport, SHADER_UNIFORM_VEC4 );
+    SetShaderValue( lc->shader, lc->viewForwardLoc, &lc->viewForward, SHADER_UNIFORM_VEC3 );
+    SetShaderValue( lc->shader, lc->lightCountLoc, &lc->lightQuantity, SHADER_UNIFORM_INT );
+
+    rlActiveTextureSlot( LIGHT_DATA_UNIT );
+    rlEnableTexture( lc->lightDataTextureId );
+    rlActiveTextureSlot( CLUSTER_DATA_UNIT );
+    rlEnableTexture( lc->clusterDataTextureId );
+    rlActiveTextureSlot( LIGHT_INDICES_UNIT );
+    rlEnableTexture( lc->lightIndicesTextureId );
+    rlActiveTextureSlot( 0 );
+
+}
+
+// view space bounds of each cluster, for a camera at the origin looking
+// along +z; the tiles are uniform in normalized device coordinates
+static void computeClusterBounds( LightClusters *lc, float fovy, float aspect ) {
+
+    float tanY = tanf( fovy * DEG2RAD / 2.0f );
+    float tanX = tanY * aspect;
+
+    for ( int z = 0; z < LIGHT_CLUSTERS_Z; z++ ) {
+
+        float nearDepth = z == 0 ? 0.0f : getSliceDepth( z );
+        float farDepth = z == LIGHT_CLUSTERS_Z - 1 ? (float) rlGetCullDistanceFar() : getSliceDepth( z + 1 );
+
+        for ( int y = 0; y < LIGHT_CLUSTERS_Y; y++ ) {
+
+            float y0 = -1.0f + 2.0f * y / LIGHT_CLUSTERS_Y;
+            float y1 = -1.0f + 2.0f * ( y + 1 ) / LIGHT_CLUSTERS_Y;
+
+            for ( int x = 0; x < LIGHT_CLUSTERS_X; x++ ) {
+
+                float x0 = -1.0f + 2.0f * x / LIGHT_CLUSTERS_X;
+                float x1 = -1.0f + 2.0f * ( x + 1 ) / LIGHT_CLUSTERS_X;
+
+                // the extremes are at the corners of the near and far faces
+                float xs[4] = { x0 * tanX * nearDepth, x1 * tanX * nearDepth, x0 * tanX * farDepth, x1 * tanX * farDepth };
+                float ys[4] = { y0 * tanY * nearDepth, y1 * tanY * nearDepth, y0 * tanY * farDepth, y1 * tanY * farDepth };
+
+                BoundingBox b = {
+                    .min = { xs[0], ys[0], nearDepth },
+                    .max = { xs[0], ys[0], farDepth }
+                };
+
+                for ( int i = 1; i < 4; i++ ) {
+                    b.min.x = fminf( b.min.x, xs[i] );
+                    b.max.x = fmaxf( b.max.x, xs[i] );
+                    b.min.y = fminf( b.min.y, ys[i] );
+                    b.max.y = fmaxf( b.max.y, ys[i] );
+                }
+
+                lc->clusterBounds[( z * LIGHT_CLUSTERS_Y + y ) * LIGHT_CLUSTERS_X + x] = b;
+
+            }
+        }
+    }
+
+    lc->boundsFovy = fovy;
+    lc->boundsAspect = aspect;
+
+}
+
+static float getSliceDepth( int slice ) {
+    return LIGHT_CLUSTERS_NEAR * powf( LIGHT_CLUSTERS_FAR / LIGHT_CLUSTERS_NEAR, (float) slice / LIGHT_CLUSTERS_Z );
+}
+
+static int getDepthSlice( float depth ) {
+
+    if ( depth <= LIGHT_CLUSTERS_NEAR ) {
+        return 0;
+    }
+
+    int slice = (int) floorf( logf( depth / LIGHT_CLUSTERS_NEAR ) * LIGHT_CLUSTERS_Z / logf( LIGHT_CLUSTERS_FAR / LIGHT_CLUSTERS_NEAR ) );
+
+    return slice < LIGHT_CLUSTERS_Z ? slice : LIGHT_CLUSTERS_Z - 1;
+
+}
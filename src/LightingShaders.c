@@ -0,0 +1,318 @@
+/**
+ * @file LightingShaders.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Lighting shader variants implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "LightingShaders.h"
+#include "LightClusters.h"
+#include "GlFunctions.h"
+#include "utils.h"
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+#define LINK_STATUS 0x8B82                  // GL_LINK_STATUS
+#define PROGRAM_BINARY_LENGTH 0x8741        // GL_PROGRAM_BINARY_LENGTH
+#define VENDOR 0x1F00                       // GL_VENDOR
+#define RENDERER 0x1F01                     // GL_RENDERER
+#define VERSION 0x1F02                      // GL_VERSION
+
+// magic, key, binary format and length
+#define PROGRAM_FILE_MAGIC 0x4E475250       // "PRGN"
+#define PROGRAM_FILE_HEADER_SIZE ( 4 * (int) sizeof( int ) )
+
+static char *injectDefines( const char *source, const char *defines );
+#ifndef __EMSCRIPTEN__
+static bool isProgramCacheAvailable( void );
+static unsigned int hashProgram( const char *vsCode, const char *fsCode );
+static Shader loadProgram( const char *cacheFilePath, unsigned int key );
+static void saveProgram( Shader shader, const char *cacheFilePath, unsigned int key );
+static void setDefaultLocations( Shader *shader );
+#endif
+
+Shader loadShaderVariant( const char *vsFileName, const char *fsFileName, const char *defines ) {
+
+    char *vsText = vsFileName != NULL ? LoadFileText( vsFileName ) : NULL;
+    char *fsText = fsFileName != NULL ? LoadFileText( fsFileName ) : NULL;
+    char *vsCode = vsText != NULL ? injectDefines( vsText, defines ) : NULL;
+    char *fsCode = fsText != NULL ? injectDefines( fsText, defines ) : NULL;
+
+    Shader shader = LoadShaderFromMemory( vsCode, fsCode );
+
+    free( vsCode );
+    free( fsCode );
+    UnloadFileText( vsText );
+    UnloadFileText( fsText );
+
+    return shader;
+
+}
+
+Shader loadCachedShaderVariant( const char *vsFileName, const char *fsFileName, const char *defines, bool *cached ) {
+
+    *cached = false;
+
+#ifndef __EMSCRIPTEN__
+    if ( isProgramCacheAvailable() ) {
+
+        char *vsText = vsFileName != NULL ? LoadFileText( vsFileName ) : NULL;
+        char *fsText = fsFileName != NULL ? LoadFileText( fsFileName ) : NULL;
+        char *vsCode = vsText != NULL ? injectDefines( vsText, defines ) : NULL;
+        char *fsCode = fsText != NULL ? injectDefines( fsText, defines ) : NULL;
+
+        unsigned int key = hashProgram( vsCode, fsCode );
+        const char *cacheFilePath = TextFormat( "%s/%08x.bin", LIGHTING_SHADER_CACHE_DIRECTORY, key );
+        char filePath[256];
+        TextCopy( filePath, cacheFilePath );
+
+        Shader shader = loadProgram( filePath, key );
+
+        if ( shader.id != 0 ) {
+            *cached = true;
+        } else {
+            shader = LoadShaderFromMemory( vsCode, fsCode );
+            saveProgram( shader, filePath, key );
+        }
+
+        free( vsCode );
+        free( fsCode );
+        UnloadFileText( vsText );
+        UnloadFileText( fsText );
+
+        return shader;
+
+    }
+#endif
+
+    return loadShaderVariant( vsFileName, fsFileName, defines );
+
+}
+
+Shader loadLightingShader( LightingTier tier, bool *cached ) {
+
+    int variant = getLightingTierVariant( tier );
+
+    const char *defines = TextFormat(
+        "#define MAX_LIGHTS %d\n"
+        "#define MAX_LIGHTS_PER_CLUSTER %d\n"
+        "%s%s%s",
+        LIGHT_CLUSTERS_MAX_LIGHTS,
+        LIGHT_CLUSTERS_MAX_LIGHTS_PER_CLUSTER,
+        variant & LIGHTING_VARIANT_SPECULAR ? "#define LIGHTING_SPECULAR\n" : "",
+        variant & LIGHTING_VARIANT_GAMMA ? "#define LIGHTING_GAMMA\n" : "",
+        variant & LIGHTING_VARIANT_PER_VERTEX ? "#define LIGHTING_PER_VERTEX\n" : "" );
+
+    Shader shader = loadCachedShaderVariant( "resources/shaders/glsl330/lighting.vs", "resources/shaders/glsl330/lighting.fs", defines, cached );
+    shader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation( shader, "viewPos" );
+
+    return shader;
+
+}
+
+int getLightingTierVariant( LightingTier tier ) {
+
+    switch ( tier ) {
+        case LIGHTING_TIER_HIGH: return LIGHTING_VARIANT_SPECULAR | LIGHTING_VARIANT_GAMMA;
+        case LIGHTING_TIER_MEDIUM: return LIGHTING_VARIANT_GAMMA;
+        case LIGHTING_TIER_LOW: return LIGHTING_VARIANT_GAMMA | LIGHTING_VARIANT_PER_VERTEX;
+        default: return 0;
+    }
+
+}
+
+const char *getLightingTierName( LightingTier tier ) {
+
+    switch ( tier ) {
+        case LIGHTING_TIER_HIGH: return "high";
+        case LIGHTING_TIER_MEDIUM: return "medium";
+        case LIGHTING_TIER_LOW: return "low (per vertex)";
+        default: return "unknown";
+    }
+
+}
+
+// the defines must come after #version, that must be the first statement
+static char *injectDefines( const char *source, const char *defines ) {
+
+    size_t headerLength = 0;
+
+    if ( strncmp( source, "#version", 8 ) == 0 ) {
+        const char *lineEnd = strchr( source, '\n' );
+        headerLength = lineEnd != NULL ? (size_t) ( lineEnd - source ) + 1 : strlen( source );
+    }
+
+    size_t definesLength = strlen( defines );
+    size_t bodyLength = strlen( source + headerLength );
+
+    // one extra byte for the line break of a #version line at the end of the file
+    char *code = (char*) malloc( headerLength + 1 + definesLength + bodyLength + 1 );
+    char *c = code;
+
+    memcpy( c, source, headerLength );
+    c += headerLength;
+    if ( headerLength > 0 && source[headerLength - 1] != '\n' ) {
+        *c++ = '\n';
+    }
+
+    memcpy( c, defines, definesLength );
+    c += definesLength;
+    memcpy( c, source + headerLength, bodyLength + 1 );
+
+    return code;
+
+}
+
+#ifndef __EMSCRIPTEN__
+static bool isProgramCacheAvailable( void ) {
+
+    int version = rlGetVersion();
+
+    return ( version == RL_OPENGL_33 || version == RL_OPENGL_43 ) &&
+           glad_glCreateProgram != NULL && glad_glGetProgramBinary != NULL && glad_glProgramBinary != NULL &&
+           glad_glGetProgramiv != NULL && glad_glGetString != NULL;
+
+}
+
+// a binary only works with the driver that wrote it
+static unsigned int hashProgram( const char *vsCode, const char *fsCode ) {
+
+    const char *parts[5] = {
+        vsCode != NULL ? vsCode : "",
+        fsCode != NULL ? fsCode : "",
+        (const char*) glad_glGetString( VENDOR ),
+        (const char*) glad_glGetString( RENDERER ),
+        (const char*) glad_glGetString( VERSION )
+    };
+
+    // the parts are kept with their terminators, so they can't run into each other
+    int size = 0;
+    for ( int i = 0; i < 5; i++ ) {
+        parts[i] = parts[i] != NULL ? parts[i] : "";
+        size += (int) strlen( parts[i] ) + 1;
+    }
+
+    unsigned char *data = (unsigned char*) malloc( size );
+    unsigned char *d = data;
+
+    for ( int i = 0; i < 5; i++ ) {
+        size_t length = strlen( parts[i] ) + 1;
+        memcpy( d, parts[i], length );
+        d += length;
+    }
+
+    unsigned int hash = hashFnv1a( data, size );
+    free( data );
+
+    return hash;
+
+}
+
+static Shader loadProgram( const char *cacheFilePath, unsigned int key ) {
+
+    Shader shader = { 0 };
+
+    if ( !FileExists( cacheFilePath ) ) {
+        return shader;
+    }
+
+    int size = 0;
+    unsigned char *data = LoadFileData( cacheFilePath, &size );
+
+    if ( data != NULL && size > PROGRAM_FILE_HEADER_SIZE ) {
+
+        int header[4];
+        memcpy( header, data, PROGRAM_FILE_HEADER_SIZE );
+
+        if ( header[0] == PROGRAM_FILE_MAGIC && (unsigned int) header[1] == key &&
+             header[3] == size - PROGRAM_FILE_HEADER_SIZE ) {
+
+            unsigned int program = glad_glCreateProgram();
+            glad_glProgramBinary( program, (unsigned int) header[2], data + PROGRAM_FILE_HEADER_SIZE, header[3] );
+
+            // a driver update may reject the binary even with the same version string
+            int linked = 0;
+            glad_glGetProgramiv( program, LINK_STATUS, &linked );
+
+            if ( linked ) {
+                shader.id = program;
+                setDefaultLocations( &shader );
+            } else {
+                TraceLog( LOG_WARNING, "SHADER: [%s] Program binary rejected by the driver, compiling again", cacheFilePath );
+                rlUnloadShaderProgram( program );
+            }
+
+        }
+
+    }
+
+    UnloadFileData( data );
+
+    return shader;
+
+}
+
+static void saveProgram( Shader shader, const char *cacheFilePath, unsigned int key ) {
+
+    if ( shader.id == 0 || shader.id == rlGetShaderIdDefault() ) {
+        return;
+    }
+
+    // zero when the driver doesn't keep the binary of the program
+    int length = 0;
+    glad_glGetProgramiv( shader.id, PROGRAM_BINARY_LENGTH, &length );
+
+    if ( length <= 0 ) {
+        return;
+    }
+
+    unsigned char *data = (unsigned char*) malloc( PROGRAM_FILE_HEADER_SIZE + length );
+    unsigned int format = 0;
+    int written = 0;
+
+    glad_glGetProgramBinary( shader.id, length, &written, &format, data + PROGRAM_FILE_HEADER_SIZE );
+
+    if ( written > 0 ) {
+        int header[4] = { PROGRAM_FILE_MAGIC, (int) key, (int) format, written };
+        memcpy( data, header, PROGRAM_FILE_HEADER_SIZE );
+        SaveFileData( cacheFilePath, data, PROGRAM_FILE_HEADER_SIZE + written );
+    }
+
+    free( data );
+
+}
+
+// the same locations LoadShaderFromMemory sets, with rlgl's default names;
+// the attributes keep the locations rlgl bound before the program was linked
+static void setDefaultLocations( Shader *shader ) {
+
+    shader->locs = (int*) malloc( RL_MAX_SHADER_LOCATIONS * sizeof( int ) );
+
+    for ( int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++ ) {
+        shader->locs[i] = -1;
+    }
+
+    shader->locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib( shader->id, "vertexPosition" );
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD01] = rlGetLocationAttrib( shader->id, "vertexTexCoord" );
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD02] = rlGetLocationAttrib( shader->id, "vertexTexCoord2" );
+    shader->locs[SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib( shader->id, "vertexNormal" );
+    shader->locs[SHADER_LOC_VERTEX_TANGENT] = rlGetLocationAttrib( shader->id, "vertexTangent" );
+    shader->locs[SHADER_LOC_VERTEX_COLOR] = rlGetLocationAttrib( shader->id, "vertexColor" );
+
+    shader->locs[SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform( shader->id, "mvp" );
+    shader->locs[SHADER_LOC_MATRIX_VIEW] = rlGetLocationUniform( shader->id, "matView" );
+    shader->locs[SHADER_LOC_MATRIX_PROJECTION] = rlGetLocationUniform( shader->id, "matProjection" );
+    shader->locs[SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform( shader->id, "matModel" );
+    shader->locs[SHADER_LOC_MATRIX_NORMAL] = rlGetLocationUniform( shader->id, "matNormal" );
+    shader->locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform( shader->id, "colDiffuse" );
+
+    shader->locs[SHADER_LOC_MAP_DIFFUSE] = rlGetLocationUniform( shader->id, "texture0" );
+    shader->locs[SHADER_LOC_MAP_SPECULAR] = rlGetLocationUniform( shader->id, "texture1" );
+    shader->locs[SHADER_LOC_MAP_NORMAL] = rlGetLocationUniform( shader->id, "texture2" );
+
+}
+#endif
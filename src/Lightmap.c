@@ -0,0 +1,374 @@
+/**
+ * @file Lightmap.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Lightmap baker implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "Lightmap.h"
+#include "WorldMesher.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+#include "raylib/rlights.h"
+
+// region of the lightmap used by one quad, with one texel of border on
+// each side so the bilinear filter doesn't pick the neighbour charts
+typedef struct LightmapChart {
+    Mesh *mesh;
+    int quad;
+    int x;
+    int y;
+    int width;
+    int height;
+} LightmapChart;
+
+typedef struct LightmapBakeJob {
+    LightmapBakeInput *input;
+    LightmapChart *charts;
+    int chartCount;
+    Image *image;
+    int first;
+    int step;
+} LightmapBakeJob;
+
+static int compareChartHeights( const void *c1, const void *c2 );
+static void *runLightmapBakeJob( void *data );
+static void bakeLightmapChart( LightmapBakeInput *input, LightmapChart *chart, Image *image );
+static Vector3 computeTexelLight( LightmapBakeInput *input, Vector3 pos, Vector3 normal );
+static bool isLightOccluded( VoxelGrid *grid, Vector3 from, Vector3 to );
+static Vector3 getMeshVertex( Mesh *mesh, int index );
+
+Image bakeLightmap( LightmapBakeInput *input ) {
+
+    int chartCount = 0;
+    for ( int i = 0; i < input->meshCount; i++ ) {
+        chartCount += input->meshes[i].vertexCount / 4;
+    }
+
+    LightmapChart *charts = (LightmapChart*) malloc( ( chartCount > 0 ? chartCount : 1 ) * sizeof( LightmapChart ) );
+    int c = 0;
+    int area = 0;
+    int maxWidth = 1;
+
+    for ( int i = 0; i < input->meshCount; i++ ) {
+
+        Mesh *mesh = &input->meshes[i];
+
+        for ( int q = 0; q < mesh->vertexCount / 4; q++ ) {
+
+            Vector3 v0 = getMeshVertex( mesh, q * 4 );
+            Vector3 v1 = getMeshVertex( mesh, q * 4 + 1 );
+            Vector3 v3 = getMeshVertex( mesh, q * 4 + 3 );
+
+            LightmapChart *chart = &charts[c++];
+            chart->mesh = mesh;
+            chart->quad = q;
+            chart->width = (int) ceilf( Vector3Distance( v0, v1 ) * LIGHTMAP_TEXELS_PER_UNIT );
+            chart->height = (int) ceilf( Vector3Distance( v0, v3 ) * LIGHTMAP_TEXELS_PER_UNIT );
+            chart->width = chart->width < 1 ? 1 : chart->width;
+            chart->height = chart->height < 1 ? 1 : chart->height;
+
+            area += ( chart->width + 2 ) * ( chart->height + 2 );
+            if ( chart->width + 2 > maxWidth ) {
+                maxWidth = chart->width + 2;
+            }
+
+        }
+
+    }
+
+    // shelf packing, tallest charts first
+    qsort( charts, chartCount, sizeof( LightmapChart ), compareChartHeights );
+
+    int width = 4;
+    while ( width < maxWidth || width * width < area + area / 4 ) {
+        width *= 2;
+    }
+
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+
+    for ( int i = 0; i < chartCount; i++ ) {
+
+        LightmapChart *chart = &charts[i];
+
+        if ( x + chart->width + 2 > width ) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+
+        chart->x = x;
+        chart->y = y;
+        x += chart->width + 2;
+
+        if ( chart->height + 2 > shelfHeight ) {
+            shelfHeight = chart->height + 2;
+        }
+
+    }
+
+    int height = y + shelfHeight;
+    height = height < 4 ? 4 : height;
+
+    // the coordinates of each corner are at the border of its inner texels
+    for ( int i = 0; i < chartCount; i++ ) {
+
+        LightmapChart *chart = &charts[i];
+        Mesh *mesh = chart->mesh;
+
+        if ( mesh->texcoords2 == NULL ) {
+            mesh->texcoords2 = (float*) MemAlloc( mesh->vertexCount * 2 * sizeof( float ) );
+        }
+
+        float u0 = (float) ( chart->x + 1 ) / width;
+        float v0 = (float) ( chart->y + 1 ) / height;
+        float u1 = (float) ( chart->x + 1 + chart->width ) / width;
+        float v1 = (float) ( chart->y + 1 + chart->height ) / height;
+        float *uv = &mesh->texcoords2[chart->quad * 8];
+
+        uv[0] = u0; uv[1] = v0;
+        uv[2] = u1; uv[3] = v0;
+        uv[4] = u1; uv[5] = v1;
+        uv[6] = u0; uv[7] = v1;
+
+    }
+
+    Image image = {
+        .data = MemAlloc( width * height * 4 ),
+        .width = width,
+        .height = height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+    };
+
+    int threadQuantity = input->threadQuantity < 1 ? 1 : input->threadQuantity;
+    pthread_t threads[LIGHTMAP_BAKE_THREADS];
+    LightmapBakeJob jobs[LIGHTMAP_BAKE_THREADS];
+    bool started[LIGHTMAP_BAKE_THREADS] = { 0 };
+
+    threadQuantity = threadQuantity > LIGHTMAP_BAKE_THREADS ? LIGHTMAP_BAKE_THREADS : threadQuantity;
+
+    for ( int i = 0; i < threadQuantity; i++ ) {
+        jobs[i] = (LightmapBakeJob){
+            .input = input,
+            .charts = charts,
+            .chartCount = chartCount,
+            .image = &image,
+            .first = i,
+            .step = threadQuantity
+        };
+    }
+
+    // the first job runs in the calling thread; the charts of a job whose
+    // thread can't be created are baked there too
+    for ( int i = 1; i < threadQuantity; i++ ) {
+        started[i] = pthread_create( &threads[i], NULL, runLightmapBakeJob, &jobs[i] ) == 0;
+    }
+
+    runLightmapBakeJob( &jobs[0] );
+
+    for ( int i = 1; i < threadQuantity; i++ ) {
+        if ( started[i] ) {
+            pthread_join( threads[i], NULL );
+        } else {
+            runLightmapBakeJob( &jobs[i] );
+        }
+    }
+
+    free( charts );
+
+    return image;
+
+}
+
+void uploadLightmapCoordinates( Mesh *mesh ) {
+
+    int size = mesh->vertexCount * 2 * sizeof( float );
+
+    // not uploaded yet, UploadMesh takes care of the coordinates
+    if ( mesh->vaoId == 0 || mesh->texcoords2 == NULL ) {
+        return;
+    }
+
+    if ( mesh->vboId[RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2] != 0 ) {
+        rlUpdateVertexBuffer( mesh->vboId[RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2], mesh->texcoords2, size, 0 );
+        return;
+    }
+
+    rlEnableVertexArray( mesh->vaoId );
+    mesh->vboId[RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2] = rlLoadVertexBuffer( mesh->texcoords2, size, false );
+    rlSetVertexAttribute( RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2, 2, RL_FLOAT, false, 0, 0 );
+    rlEnableVertexAttribute( RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2 );
+    rlDisableVertexArray();
+
+}
+
+Texture2D loadLightmapTexture( Image *lightmap ) {
+
+    Texture2D texture = LoadTextureFromImage( *lightmap );
+    SetTextureFilter( texture, TEXTURE_FILTER_BILINEAR );
+    SetTextureWrap( texture, TEXTURE_WRAP_CLAMP );
+    UnloadImage( *lightmap );
+    *lightmap = (Image){ 0 };
+
+    return texture;
+
+}
+
+static int compareChartHeights( const void *c1, const void *c2 ) {
+    const LightmapChart *chart1 = (const LightmapChart*) c1;
+    const LightmapChart *chart2 = (const LightmapChart*) c2;
+    return chart2->height - chart1->height;
+}
+
+static void *runLightmapBakeJob( void *data ) {
+
+    LightmapBakeJob *job = (LightmapBakeJob*) data;
+
+    for ( int i = job->first; i < job->chartCount; i += job->step ) {
+        bakeLightmapChart( job->input, &job->charts[i], job->image );
+    }
+
+    return NULL;
+
+}
+
+static void bakeLightmapChart( LightmapBakeInput *input, LightmapChart *chart, Image *image ) {
+
+    Mesh *mesh = chart->mesh;
+    int first = chart->quad * 4;
+
+    Vector3 v0 = Vector3Add( getMeshVertex( mesh, first ), input->offset );
+    Vector3 e1 = Vector3Subtract( getMeshVertex( mesh, first + 1 ), getMeshVertex( mesh, first ) );
+    Vector3 e3 = Vector3Subtract( getMeshVertex( mesh, first + 3 ), getMeshVertex( mesh, first ) );
+    Vector3 normal = { mesh->normals[first * 3], mesh->normals[first * 3 + 1], mesh->normals[first * 3 + 2] };
+
+    unsigned char *pixels = (unsigned char*) image->data;
+
+    // the border texels repeat the texels of the edges
+    for ( int ty = -1; ty <= chart->height; ty++ ) {
+
+        float t = ( Clamp( ty, 0, chart->height - 1 ) + 0.5f ) / chart->height;
+
+        for ( int tx = -1; tx <= chart->width; tx++ ) {
+
+            float s = ( Clamp( tx, 0, chart->width - 1 ) + 0.5f ) / chart->width;
+            Vector3 pos = Vector3Add( v0, Vector3Add( Vector3Scale( e1, s ), Vector3Scale( e3, t ) ) );
+            Vector3 light = computeTexelLight( input, pos, normal );
+
+            unsigned char *p = &pixels[( ( chart->y + 1 + ty ) * image->width + chart->x + 1 + tx ) * 4];
+            p[0] = (unsigned char) ( Clamp( light.x / LIGHTMAP_RANGE, 0.0f, 1.0f ) * 255.0f );
+            p[1] = (unsigned char) ( Clamp( light.y / LIGHTMAP_RANGE, 0.0f, 1.0f ) * 255.0f );
+            p[2] = (unsigned char) ( Clamp( light.z / LIGHTMAP_RANGE, 0.0f, 1.0f ) * 255.0f );
+            p[3] = 255;
+
+        }
+
+    }
+
+}
+
+// same diffuse term and falloff of the light shader
+static Vector3 computeTexelLight( LightmapBakeInput *input, Vector3 pos, Vector3 normal ) {
+
+    Vector3 total = { 0 };
+    float radiusSqr = input->lightRadius * input->lightRadius;
+    Vector3 start = Vector3Add( pos, Vector3Scale( normal, 0.01f ) );
+
+    for ( int i = 0; i < input->lightQuantity; i++ ) {
+
+        const Light *light = &input->lights[i];
+        Vector3 toLight = Vector3Subtract( light->position, pos );
+        float distSqr = Vector3LengthSqr( toLight );
+
+        if ( distSqr >= radiusSqr ) {
+            continue;
+        }
+
+        float dist = sqrtf( distSqr );
+        float nDotL = dist > 0.0001f ? Vector3DotProduct( normal, Vector3Scale( toLight, 1.0f / dist ) ) : 1.0f;
+
+        if ( nDotL <= 0.0f ) {
+            continue;
+        }
+
+        if ( input->occluders != NULL && isLightOccluded( input->occluders, start, light->position ) ) {
+            continue;
+        }
+
+        float attenuation = 1.0f - distSqr / radiusSqr;
+        attenuation *= attenuation * nDotL;
+
+        total.x += light->color.r / 255.0f * attenuation;
+        total.y += light->color.g / 255.0f * attenuation;
+        total.z += light->color.b / 255.0f * attenuation;
+
+    }
+
+    return total;
+
+}
+
+// walks the voxels crossed by the segment (Amanatides and Woo)
+static bool isLightOccluded( VoxelGrid *grid, Vector3 from, Vector3 to ) {
+
+    float s = grid->voxelSize;
+    Vector3 a = Vector3Scale( Vector3Subtract( from, grid->origin ), 1.0f / s );
+    Vector3 b = Vector3Scale( Vector3Subtract( to, grid->origin ), 1.0f / s );
+    Vector3 d = Vector3Subtract( b, a );
+
+    int x = (int) floorf( a.x );
+    int y = (int) floorf( a.y );
+    int z = (int) floorf( a.z );
+    int endX = (int) floorf( b.x );
+    int endY = (int) floorf( b.y );
+    int endZ = (int) floorf( b.z );
+
+    int stepX = d.x > 0 ? 1 : -1;
+    int stepY = d.y > 0 ? 1 : -1;
+    int stepZ = d.z > 0 ? 1 : -1;
+
+    float deltaX = d.x != 0.0f ? fabsf( 1.0f / d.x ) : INFINITY;
+    float deltaY = d.y != 0.0f ? fabsf( 1.0f / d.y ) : INFINITY;
+    float deltaZ = d.z != 0.0f ? fabsf( 1.0f / d.z ) : INFINITY;
+
+    float maxX = d.x != 0.0f ? ( d.x > 0 ? x + 1 - a.x : a.x - x ) * deltaX : INFINITY;
+    float maxY = d.y != 0.0f ? ( d.y > 0 ? y + 1 - a.y : a.y - y ) * deltaY : INFINITY;
+    float maxZ = d.z != 0.0f ? ( d.z > 0 ? z + 1 - a.z : a.z - z ) * deltaZ : INFINITY;
+
+    int steps = abs( endX - x ) + abs( endY - y ) + abs( endZ - z );
+
+    for ( int i = 0; i <= steps; i++ ) {
+
+        if ( isVoxelGridSolid( grid, x, y, z ) && !( x == endX && y == endY && z == endZ ) ) {
+            return true;
+        }
+
+        if ( maxX < maxY && maxX < maxZ ) {
+            x += stepX;
+            maxX += deltaX;
+        } else if ( maxY < maxZ ) {
+            y += stepY;
+            maxY += deltaY;
+        } else {
+            z += stepZ;
+            maxZ += deltaZ;
+        }
+
+    }
+
+    return false;
+
+}
+
+static Vector3 getMeshVertex( Mesh *mesh, int index ) {
+    return (Vector3){ mesh->vertices[index * 3], mesh->vertices[index * 3 + 1], mesh->vertices[index * 3 + 2] };
+}
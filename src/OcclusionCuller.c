@@ -0,0 +1,310 @@
+/**
+ * @file OcclusionCuller.c
+ * @author Prof. Dr. David Buzatto
+ * @brief OcclusionCuller implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "OcclusionCuller.h"
+#include "GlFunctions.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+#define ANY_SAMPLES_PASSED 0x8C2F           // GL_ANY_SAMPLES_PASSED
+#define QUERY_RESULT 0x8866                 // GL_QUERY_RESULT
+#define QUERY_RESULT_AVAILABLE 0x8867       // GL_QUERY_RESULT_AVAILABLE
+
+static void resize( OcclusionCuller *oc, int capacity );
+static void releaseQueries( OcclusionCuller *oc );
+#ifndef __EMSCRIPTEN__
+static void readFrame( OcclusionCullerView *view, OcclusionCullerFrame *frame );
+#endif
+static float getDistanceToBox( Vector3 p, BoundingBox box );
+
+void initOcclusionCuller( OcclusionCuller *oc ) {
+
+    *oc = (OcclusionCuller){
+        .initialized = true
+    };
+
+#ifndef __EMSCRIPTEN__
+    int version = rlGetVersion();
+    oc->available = ( version == RL_OPENGL_33 || version == RL_OPENGL_43 ) &&
+                    glad_glGenQueries != NULL && glad_glBeginQuery != NULL && glad_glGetQueryObjectuiv != NULL;
+#endif
+
+    if ( !oc->available ) {
+        TraceLog( LOG_WARNING, "OCCLUSION CULLER: Occlusion queries not available, the entities won't be culled by occlusion" );
+    }
+
+    oc->enabled = oc->available;
+    setEnabledOcclusionCuller( oc, oc->enabled );
+
+}
+
+void destroyOcclusionCuller( OcclusionCuller *oc ) {
+
+    if ( !oc->initialized ) {
+        return;
+    }
+
+    releaseQueries( oc );
+    free( oc->boxes );
+    free( oc->indexes );
+
+    *oc = (OcclusionCuller){ 0 };
+
+}
+
+void setEnabledOcclusionCuller( OcclusionCuller *oc, bool enabled ) {
+
+    oc->enabled = enabled && oc->available;
+
+    for ( int i = 0; i < OCCLUSION_CULLER_VIEWS; i++ ) {
+        OcclusionCullerView *view = &oc->views[i];
+        for ( int j = 0; j < OCCLUSION_CULLER_FRAMES; j++ ) {
+            view->frames[j].number = -1;
+        }
+        view->resultAge = -1;
+    }
+
+    oc->pendingCount = 0;
+    oc->occludedQuantity = 0;
+    oc->queryQuantity = 0;
+
+}
+
+void advanceOcclusionCuller( OcclusionCuller *oc ) {
+    oc->frameNumber++;
+}
+
+void beginOcclusionCuller( OcclusionCuller *oc, int view, int count ) {
+
+    oc->view = view;
+    oc->count = count;
+    oc->pendingCount = 0;
+    oc->occludedQuantity = 0;
+
+    if ( !oc->enabled ) {
+        return;
+    }
+
+    // the frames drawn with less entities are discarded
+    if ( count > oc->capacity ) {
+        resize( oc, count > oc->capacity * 2 ? count : oc->capacity * 2 );
+    }
+
+    OcclusionCullerView *v = &oc->views[view];
+    v->resultAge = -1;
+
+    for ( int i = 0; i < count; i++ ) {
+        v->occluded[i] = false;
+    }
+
+    // the newest frame with results, the ones not finished are left for the next frame
+    for ( int age = 1; age < OCCLUSION_CULLER_FRAMES; age++ ) {
+
+        int number = oc->frameNumber - age;
+        OcclusionCullerFrame *frame = &v->frames[number % OCCLUSION_CULLER_FRAMES];
+
+        if ( frame->number != number || frame->count != count ) {
+            continue;
+        }
+
+        if ( frame->testedCount == 0 ) {
+            v->resultAge = age;
+            break;
+        }
+
+#ifndef __EMSCRIPTEN__
+        // the queries finish in order, the last one tells if all of them did
+        unsigned int available = 0;
+        for ( int i = count - 1; i >= 0; i-- ) {
+            if ( frame->tested[i] ) {
+                glad_glGetQueryObjectuiv( frame->queries[i], QUERY_RESULT_AVAILABLE, &available );
+                break;
+            }
+        }
+
+        if ( available ) {
+            readFrame( v, frame );
+            v->resultAge = age;
+            break;
+        }
+#endif
+
+    }
+
+}
+
+bool testOcclusionCuller( OcclusionCuller *oc, int index, BoundingBox box, Vector3 viewPosition ) {
+
+    if ( !oc->enabled ) {
+        return true;
+    }
+
+    // the box may cross the near plane and the query would be wrong
+    if ( getDistanceToBox( viewPosition, box ) < OCCLUSION_CULLER_NEAR_DISTANCE ) {
+        return true;
+    }
+
+    oc->boxes[oc->pendingCount] = (BoundingBox){
+        Vector3SubtractValue( box.min, OCCLUSION_CULLER_MARGIN ),
+        Vector3AddValue( box.max, OCCLUSION_CULLER_MARGIN )
+    };
+    oc->indexes[oc->pendingCount] = index;
+    oc->pendingCount++;
+
+    bool occluded = oc->views[oc->view].occluded[index];
+
+    if ( occluded ) {
+        oc->occludedQuantity++;
+    }
+
+    return !occluded;
+
+}
+
+void drawProxiesOcclusionCuller( OcclusionCuller *oc ) {
+
+    if ( !oc->enabled ) {
+        return;
+    }
+
+    OcclusionCullerFrame *frame = &oc->views[oc->view].frames[oc->frameNumber % OCCLUSION_CULLER_FRAMES];
+    frame->number = oc->frameNumber;
+    frame->count = oc->count;
+    frame->testedCount = oc->pendingCount;
+
+    for ( int i = 0; i < oc->count; i++ ) {
+        frame->tested[i] = false;
+    }
+
+    oc->queryQuantity = oc->pendingCount;
+
+    if ( oc->pendingCount == 0 ) {
+        return;
+    }
+
+    // what was batched so far is an occluder
+    rlDrawRenderBatchActive();
+
+    rlColorMask( false, false, false, false );
+    rlDisableDepthMask();
+    rlDisableBackfaceCulling();
+
+    for ( int i = 0; i < oc->pendingCount; i++ ) {
+
+        BoundingBox box = oc->boxes[i];
+        int index = oc->indexes[i];
+
+#ifndef __EMSCRIPTEN__
+        glad_glBeginQuery( ANY_SAMPLES_PASSED, frame->queries[index] );
+#endif
+        DrawCubeV( Vector3Scale( Vector3Add( box.min, box.max ), 0.5f ), Vector3Subtract( box.max, box.min ), WHITE );
+        rlDrawRenderBatchActive();
+#ifndef __EMSCRIPTEN__
+        glad_glEndQuery( ANY_SAMPLES_PASSED );
+#endif
+
+        frame->tested[index] = true;
+
+    }
+
+    rlEnableBackfaceCulling();
+    rlEnableDepthMask();
+    rlColorMask( true, true, true, true );
+
+    oc->pendingCount = 0;
+
+}
+
+// the queries are created again for the new capacity and the frames in flight are lost
+static void resize( OcclusionCuller *oc, int capacity ) {
+
+    releaseQueries( oc );
+
+    oc->capacity = capacity;
+    oc->boxes = (BoundingBox*) realloc( oc->boxes, capacity * sizeof( BoundingBox ) );
+    oc->indexes = (int*) realloc( oc->indexes, capacity * sizeof( int ) );
+
+    for ( int i = 0; i < OCCLUSION_CULLER_VIEWS; i++ ) {
+
+        OcclusionCullerView *view = &oc->views[i];
+        view->occluded = (bool*) calloc( capacity, sizeof( bool ) );
+        view->resultAge = -1;
+
+        for ( int j = 0; j < OCCLUSION_CULLER_FRAMES; j++ ) {
+            OcclusionCullerFrame *frame = &view->frames[j];
+            frame->queries = (unsigned int*) calloc( capacity, sizeof( unsigned int ) );
+            frame->tested = (bool*) calloc( capacity, sizeof( bool ) );
+            frame->number = -1;
+#ifndef __EMSCRIPTEN__
+            glad_glGenQueries( capacity, frame->queries );
+#endif
+        }
+
+    }
+
+}
+
+static void releaseQueries( OcclusionCuller *oc ) {
+
+    for ( int i = 0; i < OCCLUSION_CULLER_VIEWS; i++ ) {
+
+        OcclusionCullerView *view = &oc->views[i];
+        free( view->occluded );
+        view->occluded = NULL;
+
+        for ( int j = 0; j < OCCLUSION_CULLER_FRAMES; j++ ) {
+            OcclusionCullerFrame *frame = &view->frames[j];
+#ifndef __EMSCRIPTEN__
+            if ( frame->queries != NULL ) {
+                glad_glDeleteQueries( oc->capacity, frame->queries );
+            }
+#endif
+            free( frame->queries );
+            free( frame->tested );
+            frame->queries = NULL;
+            frame->tested = NULL;
+        }
+
+    }
+
+    oc->capacity = 0;
+
+}
+
+#ifndef __EMSCRIPTEN__
+static void readFrame( OcclusionCullerView *view, OcclusionCullerFrame *frame ) {
+
+    for ( int i = 0; i < frame->count; i++ ) {
+
+        if ( !frame->tested[i] ) {
+            continue;
+        }
+
+        // a query not finished yet counts as visible
+        unsigned int available = 0;
+        glad_glGetQueryObjectuiv( frame->queries[i], QUERY_RESULT_AVAILABLE, &available );
+
+        if ( available ) {
+            unsigned int samplesPassed = 0;
+            glad_glGetQueryObjectuiv( frame->queries[i], QUERY_RESULT, &samplesPassed );
+            view->occluded[i] = samplesPassed == 0;
+        }
+
+    }
+
+}
+#endif
+
+static float getDistanceToBox( Vector3 p, BoundingBox box ) {
+    Vector3 closest = Vector3Clamp( p, box.min, box.max );
+    return Vector3Distance( p, closest );
+}
@@ -0,0 +1,241 @@
+/**
+ * @file ParticleSystem.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ParticleSystem implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "ParticleSystem.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+// transparent pixels between the sprites, so the filtering doesn't bleed
+static const int ATLAS_PADDING = 2;
+
+static const int EXPLOSION_DROPS = 12;
+
+static int compareParticleDepths( const void *p1, const void *p2 );
+
+Texture2D loadParticleAtlas( const char **fileNames, int fileQuantity, Rectangle *frames ) {
+
+    Image *images = (Image*) malloc( fileQuantity * sizeof( Image ) );
+    int width = 0;
+    int height = 0;
+
+    for ( int i = 0; i < fileQuantity; i++ ) {
+        images[i] = LoadImage( fileNames[i] );
+        ImageFormat( &images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 );
+        width += images[i].width + ( i > 0 ? ATLAS_PADDING : 0 );
+        height = images[i].height > height ? images[i].height : height;
+    }
+
+    Image atlasImage = GenImageColor( width, height, BLANK );
+    int x = 0;
+
+    for ( int i = 0; i < fileQuantity; i++ ) {
+        frames[i] = (Rectangle){ x, 0, images[i].width, images[i].height };
+        ImageDraw( &atlasImage, images[i], (Rectangle){ 0, 0, images[i].width, images[i].height }, frames[i], WHITE );
+        x += images[i].width + ATLAS_PADDING;
+        UnloadImage( images[i] );
+    }
+
+    Texture2D atlas = LoadTextureFromImage( atlasImage );
+    SetTextureFilter( atlas, TEXTURE_FILTER_BILINEAR );
+
+    UnloadImage( atlasImage );
+    free( images );
+
+    return atlas;
+
+}
+
+void initParticleSystem( ParticleSystem *ps, Texture2D atlas, const Rectangle *frames ) {
+
+    *ps = (ParticleSystem){
+        .initialized = true,
+        .particles = (Particle*) malloc( PARTICLE_SYSTEM_CAPACITY * sizeof( Particle ) ),
+        .atlas = atlas,
+        .density = 1.0f
+    };
+
+    for ( int i = 0; i < PARTICLE_FRAME_QUANTITY; i++ ) {
+        ps->frames[i] = frames[i];
+    }
+
+}
+
+void destroyParticleSystem( ParticleSystem *ps ) {
+
+    if ( !ps->initialized ) {
+        return;
+    }
+
+    free( ps->particles );
+
+    *ps = (ParticleSystem){ 0 };
+
+}
+
+void clearParticleSystem( ParticleSystem *ps ) {
+    ps->count = 0;
+    ps->droppedParticles = 0;
+}
+
+bool emitParticle( ParticleSystem *ps, Particle particle ) {
+
+    if ( ps->count == PARTICLE_SYSTEM_CAPACITY ) {
+        ps->droppedParticles++;
+        return false;
+    }
+
+    ps->particles[ps->count++] = particle;
+    return true;
+
+}
+
+void emitExplosionParticles( ParticleSystem *ps, Vector3 pos ) {
+
+    emitParticle( ps, (Particle){
+        .pos = pos,
+        .size = 5.0f,
+        .color = WHITE,
+        .firstFrame = PARTICLE_FRAME_BLOOD0,
+        .frameCount = 3,
+        .frameTime = PARTICLE_EXPLOSION_FRAME_TIME,
+        .lifetime = PARTICLE_EXPLOSION_DURATION
+    });
+
+    int drops = (int) ( EXPLOSION_DROPS * ps->density );
+
+    for ( int i = 0; i < drops; i++ ) {
+
+        float angle = GetRandomValue( 0, 359 ) * DEG2RAD;
+        float speed = GetRandomValue( 20, 60 ) / 10.0f;
+
+        emitParticle( ps, (Particle){
+            .pos = pos,
+            .vel = {
+                .x = cosf( angle ) * speed,
+                .y = GetRandomValue( 40, 90 ) / 10.0f,
+                .z = sinf( angle ) * speed
+            },
+            .gravity = 20.0f,
+            .size = GetRandomValue( 3, 7 ) / 10.0f,
+            .color = WHITE,
+            .firstFrame = PARTICLE_FRAME_BLOOD2,
+            .frameCount = 1,
+            .frameTime = 1.0f,
+            .lifetime = 0.8f,
+            .fadeTime = 0.3f
+        });
+
+    }
+
+}
+
+void updateParticleSystem( ParticleSystem *ps, float delta ) {
+
+    for ( int i = 0; i < ps->count; i++ ) {
+
+        Particle *p = &ps->particles[i];
+        p->age += delta;
+
+        // the last particle takes the place of the dead one
+        if ( p->age >= p->lifetime ) {
+            *p = ps->particles[--ps->count];
+            i--;
+            continue;
+        }
+
+        p->vel.y -= p->gravity * delta;
+        p->pos = Vector3Add( p->pos, Vector3Scale( p->vel, delta ) );
+
+    }
+
+}
+
+void drawParticleSystem( ParticleSystem *ps, Camera3D camera ) {
+
+    if ( ps->count == 0 ) {
+        return;
+    }
+
+    for ( int i = 0; i < ps->count; i++ ) {
+        ps->particles[i].depth = Vector3DistanceSqr( ps->particles[i].pos, camera.position );
+    }
+
+    qsort( ps->particles, ps->count, sizeof( Particle ), compareParticleDepths );
+
+    // the axes of the camera, as in DrawBillboardPro
+    Matrix view = MatrixLookAt( camera.position, camera.target, camera.up );
+    Vector3 right = { view.m0, view.m4, view.m8 };
+    Vector3 up = { view.m1, view.m5, view.m9 };
+
+    float atlasWidth = ps->atlas.width;
+    float atlasHeight = ps->atlas.height;
+
+    // whatever is in the batch keeps its depth writes
+    rlDrawRenderBatchActive();
+    rlDisableDepthMask();
+
+    rlSetTexture( ps->atlas.id );
+    rlBegin( RL_QUADS );
+
+    for ( int i = 0; i < ps->count; i++ ) {
+
+        Particle *p = &ps->particles[i];
+
+        int frame = p->firstFrame + (int) ( p->age / p->frameTime );
+        frame = frame < p->firstFrame + p->frameCount ? frame : p->firstFrame + p->frameCount - 1;
+        Rectangle source = ps->frames[frame];
+
+        float alpha = 1.0f;
+        if ( p->fadeTime > 0.0f ) {
+            alpha = Clamp( ( p->lifetime - p->age ) / p->fadeTime, 0.0f, 1.0f );
+        }
+
+        Vector3 halfRight = Vector3Scale( right, p->size * source.width / source.height / 2 );
+        Vector3 halfUp = Vector3Scale( up, p->size / 2 );
+
+        Vector3 bottomLeft = Vector3Subtract( Vector3Subtract( p->pos, halfRight ), halfUp );
+        Vector3 bottomRight = Vector3Subtract( Vector3Add( p->pos, halfRight ), halfUp );
+        Vector3 topRight = Vector3Add( Vector3Add( p->pos, halfRight ), halfUp );
+        Vector3 topLeft = Vector3Add( Vector3Subtract( p->pos, halfRight ), halfUp );
+
+        float u0 = source.x / atlasWidth;
+        float u1 = ( source.x + source.width ) / atlasWidth;
+        float v0 = source.y / atlasHeight;
+        float v1 = ( source.y + source.height ) / atlasHeight;
+
+        rlColor4ub( p->color.r, p->color.g, p->color.b, (unsigned char) ( p->color.a * alpha ) );
+
+        rlTexCoord2f( u0, v1 );
+        rlVertex3f( bottomLeft.x, bottomLeft.y, bottomLeft.z );
+        rlTexCoord2f( u1, v1 );
+        rlVertex3f( bottomRight.x, bottomRight.y, bottomRight.z );
+        rlTexCoord2f( u1, v0 );
+        rlVertex3f( topRight.x, topRight.y, topRight.z );
+        rlTexCoord2f( u0, v0 );
+        rlVertex3f( topLeft.x, topLeft.y, topLeft.z );
+
+    }
+
+    rlEnd();
+    rlSetTexture( 0 );
+
+    rlDrawRenderBatchActive();
+    rlEnableDepthMask();
+
+}
+
+// farthest first
+static int compareParticleDepths( const void *p1, const void *p2 ) {
+    float d1 = ( (const Particle*) p1 )->depth;
+    float d2 = ( (const Particle*) p2 )->depth;
+    return ( d1 < d2 ) - ( d1 > d2 );
+}
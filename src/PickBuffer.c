@@ -0,0 +1,300 @@
+/**
+ * @file PickBuffer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief PickBuffer implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdbool.h>
+#include <math.h>
+
+#include "PickBuffer.h"
+#include "EntitySupport.h"
+#include "Frustum.h"
+#include "GlFunctions.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+#define PIXEL_PACK_BUFFER 0x88EB            // GL_PIXEL_PACK_BUFFER
+#define STREAM_READ 0x88E1                  // GL_STREAM_READ
+#define MAP_READ_BIT 0x0001                 // GL_MAP_READ_BIT
+#define RGBA 0x1908                         // GL_RGBA
+#define FLOAT 0x1406                        // GL_FLOAT
+#define SYNC_GPU_COMMANDS_COMPLETE 0x9117   // GL_SYNC_GPU_COMMANDS_COMPLETE
+#define SYNC_FLUSH_COMMANDS_BIT 0x0001      // GL_SYNC_FLUSH_COMMANDS_BIT
+#define ALREADY_SIGNALED 0x911A             // GL_ALREADY_SIGNALED
+#define CONDITION_SATISFIED 0x911C          // GL_CONDITION_SATISFIED
+
+// the entity is packed as type << 22 | id in 24 bits, exact in a float
+#define ENTITY_TYPE_SHIFT 22
+#define ENTITY_ID_MASK 0x3FFFFF
+
+static bool loadTarget( PickBuffer *pb );
+#ifndef __EMSCRIPTEN__
+static bool isSignaled( void *fence );
+static void releaseFence( PickBuffer *pb, int index );
+static void readHit( PickBuffer *pb, int index );
+#endif
+
+void initPickBuffer( PickBuffer *pb, Shader shader ) {
+
+    *pb = (PickBuffer){
+        .initialized = true,
+        .available = shader.id != 0 && shader.id != rlGetShaderIdDefault(),
+        .shader = shader
+    };
+
+    if ( !pb->available ) {
+        TraceLog( LOG_WARNING, "PICKING: Picking shader not available, the reticle will use the CPU raycast" );
+        return;
+    }
+
+    pb->available = loadTarget( pb );
+
+    if ( !pb->available ) {
+        TraceLog( LOG_WARNING, "PICKING: Asynchronous readback not available, the reticle will use the CPU raycast" );
+        return;
+    }
+
+    pb->entityLoc = GetShaderLocation( shader, "entity" );
+    pb->clipPlanesLoc = GetShaderLocation( shader, "clipPlanes" );
+
+}
+
+void destroyPickBuffer( PickBuffer *pb ) {
+
+    if ( !pb->initialized ) {
+        return;
+    }
+
+#ifndef __EMSCRIPTEN__
+    if ( pb->available ) {
+        for ( int i = 0; i < PICK_BUFFER_FRAMES; i++ ) {
+            releaseFence( pb, i );
+        }
+        glad_glDeleteBuffers( PICK_BUFFER_FRAMES, pb->pixelBuffers );
+        UnloadRenderTexture( pb->target );
+    }
+#endif
+
+    *pb = (PickBuffer){ 0 };
+
+}
+
+void setEnabledPickBuffer( PickBuffer *pb, bool enabled ) {
+
+    pb->enabled = enabled && pb->available;
+
+    // the readbacks in flight are out of date
+#ifndef __EMSCRIPTEN__
+    if ( pb->available ) {
+        for ( int i = 0; i < PICK_BUFFER_FRAMES; i++ ) {
+            releaseFence( pb, i );
+        }
+    }
+#endif
+    pb->hit = (IdentifiedRayCollision){ 0 };
+
+}
+
+void beginPickBuffer( PickBuffer *pb, Ray ray ) {
+
+#ifndef __EMSCRIPTEN__
+    // the newest readback the GPU has finished, the older ones are discarded;
+    // while none is finished the last hit is kept
+    for ( int age = 1; age < PICK_BUFFER_FRAMES; age++ ) {
+
+        int index = ( pb->current + PICK_BUFFER_FRAMES - age ) % PICK_BUFFER_FRAMES;
+
+        if ( pb->fences[index] != NULL && isSignaled( pb->fences[index] ) ) {
+            readHit( pb, index );
+            for ( int i = age; i < PICK_BUFFER_FRAMES; i++ ) {
+                releaseFence( pb, ( pb->current + PICK_BUFFER_FRAMES - i ) % PICK_BUFFER_FRAMES );
+            }
+            break;
+        }
+
+    }
+#endif
+
+    Vector3 direction = Vector3Normalize( ray.direction );
+
+    pb->rays[pb->current] = (Ray){ ray.position, direction };
+    pb->drawCalls = 0;
+
+    pb->camera = (Camera3D){
+        .position = ray.position,
+        .target = Vector3Add( ray.position, direction ),
+        .up = fabsf( direction.y ) > 0.99f ? (Vector3){ 0.0f, 0.0f, 1.0f } : (Vector3){ 0.0f, 1.0f, 0.0f },
+        .fovy = PICK_BUFFER_FOVY,
+        .projection = CAMERA_PERSPECTIVE
+    };
+    pb->frustum = createFrustumFromCamera( pb->camera, 2.0f );
+
+    float clipPlanes[2] = { rlGetCullDistanceNear(), rlGetCullDistanceFar() };
+    SetShaderValue( pb->shader, pb->clipPlanesLoc, clipPlanes, SHADER_UNIFORM_VEC2 );
+
+    BeginTextureMode( pb->target );
+    ClearBackground( BLANK );
+    BeginMode3D( pb->camera );
+
+}
+
+void addMeshPickBuffer( PickBuffer *pb, Mesh *mesh, Material *material, Matrix transform, BoundingBox bounds, EntityType type, int id ) {
+
+    if ( !isBoxInsideFrustum( &pb->frustum, bounds ) ) {
+        return;
+    }
+
+    int entity = ( (int) type << ENTITY_TYPE_SHIFT ) | ( id & ENTITY_ID_MASK );
+    SetShaderValue( pb->shader, pb->entityLoc, &entity, SHADER_UNIFORM_INT );
+
+    // the material keeps its textures, only the shader changes
+    Material pickMaterial = *material;
+    pickMaterial.shader = pb->shader;
+    DrawMesh( *mesh, pickMaterial, transform );
+
+    pb->drawCalls++;
+
+}
+
+void endPickBuffer( PickBuffer *pb ) {
+
+    EndMode3D();
+
+#ifndef __EMSCRIPTEN__
+    // a readback still in flight is too old, the copy just replaces it
+    releaseFence( pb, pb->current );
+
+    // the copy goes to the buffer on the GPU, nothing waits here
+    rlDrawRenderBatchActive();
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, pb->pixelBuffers[pb->current] );
+    glad_glReadPixels( 0, 0, 1, 1, RGBA, FLOAT, NULL );
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, 0 );
+    pb->fences[pb->current] = glad_glFenceSync( SYNC_GPU_COMMANDS_COMPLETE, 0 );
+#endif
+
+    EndTextureMode();
+
+    pb->current = ( pb->current + 1 ) % PICK_BUFFER_FRAMES;
+
+}
+
+IdentifiedRayCollision getHitPickBuffer( PickBuffer *pb ) {
+    return pb->hit;
+}
+
+// a float color target with a depth renderbuffer, like LoadRenderTexture
+static bool loadTarget( PickBuffer *pb ) {
+
+#ifndef __EMSCRIPTEN__
+    int version = rlGetVersion();
+    bool available = ( version == RL_OPENGL_33 || version == RL_OPENGL_43 ) &&
+                     glad_glGenBuffers != NULL && glad_glBindBuffer != NULL && glad_glBufferData != NULL &&
+                     glad_glMapBufferRange != NULL && glad_glUnmapBuffer != NULL && glad_glReadPixels != NULL &&
+                     glad_glFenceSync != NULL && glad_glClientWaitSync != NULL && glad_glDeleteSync != NULL;
+
+    if ( !available ) {
+        return false;
+    }
+
+    RenderTexture2D target = {
+        .id = rlLoadFramebuffer(),
+        .texture = {
+            .width = 1,
+            .height = 1,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R32G32B32A32
+        },
+        .depth = {
+            .width = 1,
+            .height = 1,
+            .mipmaps = 1,
+            .format = 19    // DEPTH_COMPONENT_24BIT, as in LoadRenderTexture
+        }
+    };
+
+    if ( target.id == 0 ) {
+        return false;
+    }
+
+    rlEnableFramebuffer( target.id );
+    target.texture.id = rlLoadTexture( NULL, 1, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1 );
+    target.depth.id = rlLoadTextureDepth( 1, 1, true );
+    rlFramebufferAttach( target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0 );
+    rlFramebufferAttach( target.id, target.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0 );
+
+    bool complete = rlFramebufferComplete( target.id );
+    rlDisableFramebuffer();
+
+    if ( !complete ) {
+        UnloadRenderTexture( target );
+        return false;
+    }
+
+    pb->target = target;
+
+    glad_glGenBuffers( PICK_BUFFER_FRAMES, pb->pixelBuffers );
+    for ( int i = 0; i < PICK_BUFFER_FRAMES; i++ ) {
+        glad_glBindBuffer( PIXEL_PACK_BUFFER, pb->pixelBuffers[i] );
+        glad_glBufferData( PIXEL_PACK_BUFFER, 4 * sizeof( float ), NULL, STREAM_READ );
+    }
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, 0 );
+
+    return true;
+#else
+    (void) pb;
+    return false;
+#endif
+
+}
+
+#ifndef __EMSCRIPTEN__
+static bool isSignaled( void *fence ) {
+    unsigned int result = glad_glClientWaitSync( fence, SYNC_FLUSH_COMMANDS_BIT, 0 );
+    return result == ALREADY_SIGNALED || result == CONDITION_SATISFIED;
+}
+
+static void releaseFence( PickBuffer *pb, int index ) {
+
+    if ( pb->fences[index] != NULL ) {
+        glad_glDeleteSync( pb->fences[index] );
+        pb->fences[index] = NULL;
+    }
+
+}
+
+static void readHit( PickBuffer *pb, int index ) {
+
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, pb->pixelBuffers[index] );
+    float *pixel = (float*) glad_glMapBufferRange( PIXEL_PACK_BUFFER, 0, 4 * sizeof( float ), MAP_READ_BIT );
+
+    if ( pixel != NULL ) {
+
+        unsigned int entity = (unsigned int) pixel[0];
+        float distance = pixel[1];
+        Ray r = pb->rays[index];
+
+        pb->hit = (IdentifiedRayCollision){ 0 };
+
+        if ( entity != 0 ) {
+            pb->hit = (IdentifiedRayCollision){
+                .entityId = entity & ENTITY_ID_MASK,
+                .entityType = (EntityType) ( entity >> ENTITY_TYPE_SHIFT ),
+                .collision = {
+                    .hit = true,
+                    .distance = distance,
+                    .point = Vector3Add( r.position, Vector3Scale( r.direction, distance ) )
+                }
+            };
+        }
+
+        glad_glUnmapBuffer( PIXEL_PACK_BUFFER );
+
+    }
+
+    glad_glBindBuffer( PIXEL_PACK_BUFFER, 0 );
+
+}
+#endif
@@ -138,7 +138,7 @@ Player createPlayer( Vector3 pos ) {
 
 }
 
-void drawPlayer( Player *player ) {
+void drawPlayer( Player *player, RenderQueue *rq ) {
     
     if ( player->showCollisionProbes ) {
         drawBlock( &player->cpLeft );
@@ -150,29 +150,45 @@ void drawPlayer( Player *player ) {
     }
 
     if ( !player->showWiresOnly ) {
-        DrawModelEx( player->model, player->pos, player->rotationAxis, player->rotationHorizontalAngle, player->scale, WHITE );
+        Matrix transform = getRenderTransform( player->pos, player->rotationAxis, player->rotationHorizontalAngle, player->scale );
+        addModelRenderQueue( rq, &player->model, transform, player->pos, WHITE, (Texture2D){ 0 }, true );
     }
 
-    DrawModelWiresEx( player->model, player->pos, player->rotationAxis, player->rotationHorizontalAngle, player->scale, BLACK );
+    if ( player->showWiresOnly || !shaderOutlines ) {
+        DrawModelWiresEx( player->model, player->pos, player->rotationAxis, player->rotationHorizontalAngle, player->scale, BLACK );
+    }
 
 }
 
-void drawPlayerHud( Player *player ) {
+void drawPlayerHud( Player *player, HudPanel *panel, Rectangle viewport ) {
 
-    int h = GetScreenHeight();
     int xMargin = 10;
     int yMargin = 10;
-    float t = (float) player->currentHp / player->maxHp;
-    int hpBarWidth = 140;
+    int width = 320;
+    int height = 50;
+
+    // redrawn only when something shown changes
+    int key[] = { player->currentHp, player->maxHp, player->immortal, player->currentWeapon->type, player->currentWeapon->ammo };
+
+    if ( beginHudPanel( panel, width, height, key, sizeof( key ) / sizeof( key[0] ) ) ) {
+
+        float t = (float) player->currentHp / player->maxHp;
+        int hpBarWidth = 140;
+
+        DrawRectangle( xMargin, 3, (int) ( hpBarWidth * t ), 20, interpolate3Color( RED, ORANGE, LIME, t ) );
+        DrawRectangleLines( xMargin, 3, hpBarWidth, 20, BLACK );
+
+        if ( player->immortal ) {
+            DrawText( "* immortal *", xMargin * 2, 4, 20, BLACK );
+        }
 
-    DrawRectangle( xMargin, h - yMargin - 47, (int) ( hpBarWidth * t ), 20, interpolate3Color( RED, ORANGE, LIME, t ) );
-    DrawRectangleLines( xMargin, h - yMargin - 47, hpBarWidth, 20, BLACK );
+        DrawText( TextFormat( "%s: %d", player->currentWeapon->name, player->currentWeapon->ammo ), xMargin, 30, 20, player->currentWeapon->ammo > 0 ? BLACK : MAROON );
+
+        endHudPanel( panel );
 
-    if ( player->immortal ) {
-        DrawText( "* immortal *", xMargin * 2, h - yMargin - 46, 20, BLACK );
     }
 
-    DrawText( TextFormat( "%s: %d", player->currentWeapon->name, player->currentWeapon->ammo ), xMargin, h - yMargin - 20, 20, player->currentWeapon->ammo > 0 ? BLACK : MAROON );
+    drawHudPanel( panel, viewport.x, viewport.y + viewport.height - yMargin - height );
 
 }
 
@@ -402,19 +418,19 @@ void playerShot( GameWorld *gw, Player *player, bool useGamepad, int gamepadId )
         switch ( player->currentWeapon->type ) {
             case WEAPON_TYPE_HANDGUN:
                 if ( IsGamepadButtonPressed( gamepadId, GAMEPAD_BUTTON_RIGHT_TRIGGER_2 ) ) {
-                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw );
+                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw, player );
                     playerShotHandgun( gw, player, &currentHit );
                 }
                 break;
             case WEAPON_TYPE_SUBMACHINEGUN:
                 if ( IsGamepadButtonDown( gamepadId, GAMEPAD_BUTTON_RIGHT_TRIGGER_2 ) ) {
-                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw );
+                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw, player );
                     playerShotMachinegun( gw, player, &currentHit );
                 }
                 break;
             case WEAPON_TYPE_SHOTGUN:
                 if ( IsGamepadButtonPressed( gamepadId, GAMEPAD_BUTTON_RIGHT_TRIGGER_2 ) ) {
-                    MultipleIdentifiedRayCollision currentMultipleHit = resolveMultipleHitsWorld( gw );
+                    MultipleIdentifiedRayCollision currentMultipleHit = resolveMultipleHitsWorld( gw, player );
                     playerShotShotgun( gw, player, &currentMultipleHit );
                 }
                 break;
@@ -423,19 +439,19 @@ void playerShot( GameWorld *gw, Player *player, bool useGamepad, int gamepadId )
         switch ( player->currentWeapon->type ) {
             case WEAPON_TYPE_HANDGUN:
                 if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
-                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw );
+                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw, player );
                     playerShotHandgun( gw, player, &currentHit );
                 }
                 break;
             case WEAPON_TYPE_SUBMACHINEGUN:
                 if ( IsMouseButtonDown( MOUSE_BUTTON_LEFT ) ) {
-                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw );
+                    IdentifiedRayCollision currentHit = resolveHitsWorld( gw, player );
                     playerShotMachinegun( gw, player, &currentHit );
                 }
                 break;
             case WEAPON_TYPE_SHOTGUN:
                 if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
-                    MultipleIdentifiedRayCollision currentMultipleHit = resolveMultipleHitsWorld( gw );
+                    MultipleIdentifiedRayCollision currentMultipleHit = resolveMultipleHitsWorld( gw, player );
                     playerShotShotgun( gw, player, &currentMultipleHit );
                 }
                 break;
@@ -485,13 +501,16 @@ void playerShotHandgun( GameWorld *gw, Player *player, IdentifiedRayCollision *i
 
         }
 
+        if ( irc->entityType == ENTITY_TYPE_OBSTACLE && damageObstacle( gw, irc->entityId, bulletDamage ) ) {
+            createBulletWorld = false;
+        }
+
         if ( irc->entityType != ENTITY_TYPE_NONE ) {
 
             if ( enemyShot != NULL ) {
                 addBulletToEnemy( enemyShot, irc->collision.point, bulletColor, bulletRadius );
             } else if ( createBulletWorld && irc->entityType != ENTITY_TYPE_ENEMY ) {
-                gw->collidedBullets[gw->collidedBulletCount%gw->maxCollidedBullets] = createBullet( irc->collision.point, bulletColor, bulletRadius );
-                gw->collidedBulletCount++;
+                addImpactDecal( &gw->impacts, irc->collision.point, irc->collision.normal, bulletRadius * 2.0f, bulletColor );
             }
 
         }
@@ -548,13 +567,16 @@ void playerShotMachinegun( GameWorld *gw, Player *player, IdentifiedRayCollision
 
             }
 
+            if ( irc->entityType == ENTITY_TYPE_OBSTACLE && damageObstacle( gw, irc->entityId, bulletDamage ) ) {
+                createBulletWorld = false;
+            }
+
             if ( irc->entityType != ENTITY_TYPE_NONE ) {
 
                 if ( enemyShot != NULL ) {
                     addBulletToEnemy( enemyShot, irc->collision.point, bulletColor, bulletRadius );
                 } else if ( createBulletWorld && irc->entityType != ENTITY_TYPE_ENEMY ) {
-                    gw->collidedBullets[gw->collidedBulletCount%gw->maxCollidedBullets] = createBullet( irc->collision.point, bulletColor, bulletRadius );
-                    gw->collidedBulletCount++;
+                    addImpactDecal( &gw->impacts, irc->collision.point, irc->collision.normal, bulletRadius * 2.0f, bulletColor );
                 }
 
             }
@@ -613,13 +635,16 @@ void playerShotShotgun( GameWorld *gw, Player *player, MultipleIdentifiedRayColl
 
             }
 
+            if ( irc->entityType == ENTITY_TYPE_OBSTACLE && damageObstacle( gw, irc->entityId, bulletDamage ) ) {
+                createBulletWorld = false;
+            }
+
             if ( irc->entityType != ENTITY_TYPE_NONE ) {
 
                 if ( enemyShot != NULL ) {
                     addBulletToEnemy( enemyShot, irc->collision.point, bulletColor, bulletRadius );
                 } else if ( createBulletWorld && irc->entityType != ENTITY_TYPE_ENEMY ) {
-                    gw->collidedBullets[gw->collidedBulletCount%gw->maxCollidedBullets] = createBullet( irc->collision.point, bulletColor, bulletRadius );
-                    gw->collidedBulletCount++;
+                    addImpactDecal( &gw->impacts, irc->collision.point, irc->collision.normal, bulletRadius * 2.0f, bulletColor );
                 }
 
             }
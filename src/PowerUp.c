@@ -7,6 +7,7 @@
 #include "PowerUp.h"
 #include "Block.h"
 #include "ResourceManager.h"
+#include "SphereBatch.h"
 #include "raylib/raylib.h"
 
 PowerUp createPowerUp( Vector3 pos, PowerUpType powerUpType ) {
@@ -47,23 +48,24 @@ PowerUp createPowerUp( Vector3 pos, PowerUpType powerUpType ) {
 
 }
 
-void drawPowerUp( PowerUp *powerUp ) {
+void drawPowerUp( PowerUp *powerUp, SphereBatch *sb ) {
 
-    if ( !powerUp->showWiresOnly ) {
-
-        Color color;
-
-        switch ( powerUp->type ) {
-            case POWER_UP_TYPE_HP: color = powerUp->hpColor; break;
-            case POWER_UP_TYPE_AMMO: color = powerUp->ammoColor; break;
-            default: color = BLACK; break;
-        }
-
-        DrawModelEx( powerUp->model, powerUp->pos, powerUp->rotationAxis, powerUp->rotationHorizontalAngle, powerUp->scale, color );
+    Color color;
 
+    switch ( powerUp->type ) {
+        case POWER_UP_TYPE_HP: color = powerUp->hpColor; break;
+        case POWER_UP_TYPE_AMMO: color = powerUp->ammoColor; break;
+        default: color = BLACK; break;
     }
 
-    DrawModelWiresEx( powerUp->model, powerUp->pos, powerUp->rotationAxis, powerUp->rotationHorizontalAngle, powerUp->scale, BLACK );
+    addSphereBatch( 
+        sb, 
+        powerUp->pos, 
+        powerUp->radius * powerUp->scale.x, 
+        color, 
+        powerUp->rotationHorizontalAngle, 
+        powerUp->showWiresOnly ? SPHERE_BATCH_FLAG_WIRES_ONLY : SPHERE_BATCH_FLAG_CHECKERED | SPHERE_BATCH_FLAG_WIRES
+    );
 
 }
 
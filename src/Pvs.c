@@ -0,0 +1,442 @@
+/**
+ * @file Pvs.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Potentially visible set (Pvs) implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include "Pvs.h"
+#include "WorldMesher.h"
+#include "raylib/raylib.h"
+
+#define PVS_FILE_MAGIC 0x33535650
+#define PVS_FILE_HEADER_SIZE ( 5 * (int) sizeof( int ) )
+
+// the camera is at the center of the player, that can jump four units high
+const float PVS_EYE_HEIGHT = 5.0f;
+
+// enemies and power-ups standing on top of the obstacles, also jumping
+const float PVS_TARGET_HEIGHT = 6.0f;
+
+static void computeHeightsPvs( Pvs *pvs, VoxelGrid *grid );
+static void computePairPvs( Pvs *pvs, unsigned char *bits, int cell, int other );
+static bool isCellPairVisible( Pvs *pvs, int a, int b );
+static void getCellExtentsPvs( Pvs *pvs, int cell, bool alongX, int extents[4] );
+static bool isWallBetween( Pvs *pvs, const int first[4], const int second[4], bool alongX, float height );
+static int getColumnCellPvs( Pvs *pvs, int x, int z );
+static bool loadPvs( Pvs *pvs, const char *cacheFilePath, unsigned int mapHash );
+static void savePvs( Pvs *pvs, const char *cacheFilePath, unsigned int mapHash );
+
+void initPvs( Pvs *pvs, VoxelGrid *grid, const char *cacheFilePath, unsigned int mapHash ) {
+
+    *pvs = (Pvs){
+        .initialized = true,
+        .cellsX = ( grid->width + PVS_CELL_SIZE - 1 ) / PVS_CELL_SIZE,
+        .cellsZ = ( grid->depth + PVS_CELL_SIZE - 1 ) / PVS_CELL_SIZE,
+        .voxelSize = grid->voxelSize,
+        .origin = grid->origin,
+        .groundLevel = grid->groundLevel,
+        .columnsX = grid->width,
+        .columnsZ = grid->depth,
+        .rebuildCell = -1,
+        .rebuildOther = -1
+    };
+
+    pvs->cellQuantity = pvs->cellsX * pvs->cellsZ;
+    pvs->rowBytes = ( pvs->cellQuantity + 7 ) / 8;
+
+    int bytes = pvs->rowBytes * pvs->cellQuantity;
+    pvs->visible = (unsigned char*) calloc( bytes > 0 ? bytes : 1, sizeof( unsigned char ) );
+    pvs->rebuilding = (unsigned char*) calloc( bytes > 0 ? bytes : 1, sizeof( unsigned char ) );
+
+    int columns = pvs->columnsX * pvs->columnsZ;
+    pvs->occluderHeights = (unsigned char*) calloc( columns > 0 ? columns : 1, sizeof( unsigned char ) );
+    pvs->topHeights = (unsigned char*) calloc( columns > 0 ? columns : 1, sizeof( unsigned char ) );
+    pvs->eyeHeights = (float*) calloc( pvs->cellQuantity > 0 ? pvs->cellQuantity : 1, sizeof( float ) );
+    pvs->targetHeights = (float*) calloc( pvs->cellQuantity > 0 ? pvs->cellQuantity : 1, sizeof( float ) );
+
+    computeHeightsPvs( pvs, grid );
+
+    if ( !loadPvs( pvs, cacheFilePath, mapHash ) ) {
+
+        double start = GetTime();
+
+        for ( int i = 0; i < pvs->cellQuantity; i++ ) {
+            for ( int j = i; j < pvs->cellQuantity; j++ ) {
+                computePairPvs( pvs, pvs->visible, i, j );
+            }
+        }
+
+        TraceLog( LOG_INFO, "PVS: [%s] %d cells computed in %.2f ms", cacheFilePath, pvs->cellQuantity, ( GetTime() - start ) * 1000.0 );
+        savePvs( pvs, cacheFilePath, mapHash );
+
+    }
+
+}
+
+void destroyPvs( Pvs *pvs ) {
+
+    if ( !pvs->initialized ) {
+        return;
+    }
+
+    free( pvs->visible );
+    free( pvs->rebuilding );
+    free( pvs->occluderHeights );
+    free( pvs->topHeights );
+    free( pvs->eyeHeights );
+    free( pvs->targetHeights );
+
+    *pvs = (Pvs){ 0 };
+
+}
+
+void invalidatePvs( Pvs *pvs, VoxelGrid *grid ) {
+
+    if ( !pvs->initialized ) {
+        return;
+    }
+
+    computeHeightsPvs( pvs, grid );
+    memset( pvs->rebuilding, 0, pvs->rowBytes * pvs->cellQuantity );
+    pvs->rebuildCell = 0;
+    pvs->rebuildOther = 0;
+
+}
+
+void updatePvs( Pvs *pvs, double budget ) {
+
+    if ( !pvs->initialized || pvs->rebuildCell < 0 ) {
+        return;
+    }
+
+    double start = GetTime();
+
+    // a row of a large map can take longer than the budget, so the time is
+    // checked after each pair and the next call resumes from it
+    while ( pvs->rebuildCell < pvs->cellQuantity && GetTime() - start < budget ) {
+
+        computePairPvs( pvs, pvs->rebuilding, pvs->rebuildCell, pvs->rebuildOther );
+
+        if ( ++pvs->rebuildOther == pvs->cellQuantity ) {
+            pvs->rebuildCell++;
+            pvs->rebuildOther = pvs->rebuildCell;
+        }
+
+    }
+
+    if ( pvs->rebuildCell == pvs->cellQuantity ) {
+        unsigned char *bits = pvs->visible;
+        pvs->visible = pvs->rebuilding;
+        pvs->rebuilding = bits;
+        pvs->rebuildCell = -1;
+        pvs->rebuildOther = -1;
+    }
+
+}
+
+bool isReadyPvs( Pvs *pvs ) {
+    return pvs->initialized && pvs->rebuildCell < 0;
+}
+
+int getCellPvs( Pvs *pvs, Vector3 pos ) {
+
+    if ( !pvs->initialized ) {
+        return -1;
+    }
+
+    int x = (int) floorf( ( pos.x - pvs->origin.x ) / pvs->voxelSize );
+    int z = (int) floorf( ( pos.z - pvs->origin.z ) / pvs->voxelSize );
+
+    if ( x < 0 || z < 0 || x >= pvs->columnsX || z >= pvs->columnsZ ) {
+        return -1;
+    }
+
+    return getColumnCellPvs( pvs, x, z );
+
+}
+
+int getViewerCellPvs( Pvs *pvs, Vector3 cameraPos ) {
+
+    int cell = getCellPvs( pvs, cameraPos );
+
+    if ( cell < 0 ) {
+        return -1;
+    }
+
+    float height = ( cameraPos.y - pvs->origin.y ) / pvs->voxelSize - pvs->groundLevel;
+
+    if ( height > pvs->eyeHeights[cell] ) {
+        return -1;
+    }
+
+    return cell;
+
+}
+
+bool isCellVisiblePvs( Pvs *pvs, int fromCell, int toCell ) {
+
+    if ( fromCell < 0 || toCell < 0 || !isReadyPvs( pvs ) ) {
+        return true;
+    }
+
+    return ( pvs->visible[fromCell * pvs->rowBytes + toCell / 8] & ( 1 << ( toCell % 8 ) ) ) != 0;
+
+}
+
+bool isPositionVisiblePvs( Pvs *pvs, int fromCell, Vector3 pos ) {
+
+    int cell = getCellPvs( pvs, pos );
+
+    if ( fromCell < 0 || cell < 0 || !isReadyPvs( pvs ) ) {
+        return true;
+    }
+
+    // an entity centered in a cell may reach into the next ones
+    int cellX = cell % pvs->cellsX;
+    int cellZ = cell / pvs->cellsX;
+
+    for ( int z = cellZ - 1; z <= cellZ + 1; z++ ) {
+        for ( int x = cellX - 1; x <= cellX + 1; x++ ) {
+            if ( x >= 0 && z >= 0 && x < pvs->cellsX && z < pvs->cellsZ && isCellVisiblePvs( pvs, fromCell, z * pvs->cellsX + x ) ) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+
+}
+
+bool isRegionVisiblePvs( Pvs *pvs, int fromCell, int minX, int minZ, int maxX, int maxZ ) {
+
+    if ( fromCell < 0 || !isReadyPvs( pvs ) ) {
+        return true;
+    }
+
+    for ( int z = minZ / PVS_CELL_SIZE; z <= ( maxZ - 1 ) / PVS_CELL_SIZE && z < pvs->cellsZ; z++ ) {
+        for ( int x = minX / PVS_CELL_SIZE; x <= ( maxX - 1 ) / PVS_CELL_SIZE && x < pvs->cellsX; x++ ) {
+            if ( isCellVisiblePvs( pvs, fromCell, z * pvs->cellsX + x ) ) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+
+}
+
+// occluders only count the obstacles stacked from the ground, since sight
+// lines can pass below the floating ones
+static void computeHeightsPvs( Pvs *pvs, VoxelGrid *grid ) {
+
+    for ( int z = 0; z < pvs->columnsZ; z++ ) {
+        for ( int x = 0; x < pvs->columnsX; x++ ) {
+
+            int occluder = 0;
+            int top = 0;
+            bool stacked = true;
+
+            for ( int y = grid->groundLevel; y < grid->height; y++ ) {
+                if ( getVoxelGridMaterial( grid, x, y, z ) != 0 ) {
+                    top = y - grid->groundLevel + 1;
+                    if ( stacked ) {
+                        occluder = top;
+                    }
+                } else {
+                    stacked = false;
+                }
+            }
+
+            pvs->occluderHeights[z * pvs->columnsX + x] = occluder < 255 ? occluder : 255;
+            pvs->topHeights[z * pvs->columnsX + x] = top < 255 ? top : 255;
+
+        }
+    }
+
+    // the player may stand on an obstacle of the neighbour column while
+    // its center is still inside the cell
+    for ( int i = 0; i < pvs->cellQuantity; i++ ) {
+
+        int cx = i % pvs->cellsX * PVS_CELL_SIZE;
+        int cz = i / pvs->cellsX * PVS_CELL_SIZE;
+        int top = 0;
+
+        for ( int z = cz - 1; z <= cz + PVS_CELL_SIZE; z++ ) {
+            for ( int x = cx - 1; x <= cx + PVS_CELL_SIZE; x++ ) {
+                if ( x >= 0 && z >= 0 && x < pvs->columnsX && z < pvs->columnsZ && pvs->topHeights[z * pvs->columnsX + x] > top ) {
+                    top = pvs->topHeights[z * pvs->columnsX + x];
+                }
+            }
+        }
+
+        pvs->eyeHeights[i] = top + PVS_EYE_HEIGHT / pvs->voxelSize;
+        pvs->targetHeights[i] = top + PVS_TARGET_HEIGHT / pvs->voxelSize;
+
+    }
+
+}
+
+// visibility is symmetric, so only the pairs from the diagonal onwards are
+// computed and each one sets both bits
+static void computePairPvs( Pvs *pvs, unsigned char *bits, int cell, int other ) {
+
+    if ( other == cell || isCellPairVisible( pvs, cell, other ) ) {
+        bits[cell * pvs->rowBytes + other / 8] |= 1 << ( other % 8 );
+        bits[other * pvs->rowBytes + cell / 8] |= 1 << ( cell % 8 );
+    }
+
+}
+
+// the cells are hidden from each other only if a wall, one voxel column
+// thick, crosses every sight line between them; the lines go from any point
+// of one cell to any point of the other and no higher than the highest eye
+// or target position of both cells, so a column taller than that blocks
+// any line that enters it. Walls that hide the cells only together (like
+// the two sides of a corner) are not found and the cells stay visible
+static bool isCellPairVisible( Pvs *pvs, int a, int b ) {
+
+    float height = fmaxf( fmaxf( pvs->eyeHeights[a], pvs->targetHeights[a] ),
+                          fmaxf( pvs->eyeHeights[b], pvs->targetHeights[b] ) );
+
+    for ( int axis = 0; axis < 2; axis++ ) {
+
+        bool alongX = axis == 0;
+        int ea[4];
+        int eb[4];
+
+        getCellExtentsPvs( pvs, a, alongX, ea );
+        getCellExtentsPvs( pvs, b, alongX, eb );
+
+        if ( ea[1] <= eb[0] && isWallBetween( pvs, ea, eb, alongX, height ) ) {
+            return false;
+        }
+
+        if ( eb[1] <= ea[0] && isWallBetween( pvs, eb, ea, alongX, height ) ) {
+            return false;
+        }
+
+    }
+
+    return true;
+
+}
+
+// voxel extents of a cell: [0, 1) along the axis being tested and [2, 3)
+// along the other one
+static void getCellExtentsPvs( Pvs *pvs, int cell, bool alongX, int extents[4] ) {
+
+    int x0 = cell % pvs->cellsX * PVS_CELL_SIZE;
+    int z0 = cell / pvs->cellsX * PVS_CELL_SIZE;
+    int x1 = x0 + PVS_CELL_SIZE < pvs->columnsX ? x0 + PVS_CELL_SIZE : pvs->columnsX;
+    int z1 = z0 + PVS_CELL_SIZE < pvs->columnsZ ? z0 + PVS_CELL_SIZE : pvs->columnsZ;
+
+    extents[0] = alongX ? x0 : z0;
+    extents[1] = alongX ? x1 : z1;
+    extents[2] = alongX ? z0 : x0;
+    extents[3] = alongX ? z1 : x1;
+
+}
+
+// tests each slab of columns between the cells, where first ends before
+// second begins along the axis. At coordinate u a line is at
+// v0 + ( v1 - v0 ) * t, with t between the values of the lines joining the
+// low borders and the high borders of both cells, so the lines cross the
+// slab within the range given by those extremes
+static bool isWallBetween( Pvs *pvs, const int first[4], const int second[4], bool alongX, float height ) {
+
+    int vMax = alongX ? pvs->columnsZ - 1 : pvs->columnsX - 1;
+
+    for ( int u = first[1]; u < second[0]; u++ ) {
+
+        float lo = FLT_MAX;
+        float hi = -FLT_MAX;
+
+        for ( int side = 0; side < 2; side++ ) {
+
+            float t[2] = {
+                ( u + side - first[1] ) / (float) ( second[1] - first[1] ),
+                ( u + side - first[0] ) / (float) ( second[0] - first[0] )
+            };
+
+            for ( int i = 0; i < 2; i++ ) {
+                lo = fminf( lo, first[2] + ( second[2] - first[2] ) * t[i] );
+                hi = fmaxf( hi, first[3] + ( second[3] - first[3] ) * t[i] );
+            }
+
+        }
+
+        // a line along a border between columns touches both of them
+        int v0 = (int) ceilf( lo ) - 1;
+        int v1 = (int) floorf( hi );
+        bool blocked = true;
+
+        for ( int v = v0 > 0 ? v0 : 0; v <= v1 && v <= vMax && blocked; v++ ) {
+            int x = alongX ? u : v;
+            int z = alongX ? v : u;
+            blocked = pvs->occluderHeights[z * pvs->columnsX + x] > height;
+        }
+
+        if ( blocked ) {
+            return true;
+        }
+
+    }
+
+    return false;
+
+}
+
+static int getColumnCellPvs( Pvs *pvs, int x, int z ) {
+    return ( z / PVS_CELL_SIZE ) * pvs->cellsX + x / PVS_CELL_SIZE;
+}
+
+static bool loadPvs( Pvs *pvs, const char *cacheFilePath, unsigned int mapHash ) {
+
+    if ( !FileExists( cacheFilePath ) ) {
+        return false;
+    }
+
+    int size = 0;
+    unsigned char *data = LoadFileData( cacheFilePath, &size );
+    int bytes = pvs->rowBytes * pvs->cellQuantity;
+    bool loaded = false;
+
+    if ( data != NULL && size == PVS_FILE_HEADER_SIZE + bytes ) {
+
+        int header[5];
+        memcpy( header, data, PVS_FILE_HEADER_SIZE );
+
+        if ( header[0] == PVS_FILE_MAGIC && (unsigned int) header[1] == mapHash &&
+             header[2] == pvs->cellsX && header[3] == pvs->cellsZ && header[4] == PVS_CELL_SIZE ) {
+            memcpy( pvs->visible, data + PVS_FILE_HEADER_SIZE, bytes );
+            loaded = true;
+        }
+
+    }
+
+    UnloadFileData( data );
+
+    return loaded;
+
+}
+
+static void savePvs( Pvs *pvs, const char *cacheFilePath, unsigned int mapHash ) {
+
+    int bytes = pvs->rowBytes * pvs->cellQuantity;
+    unsigned char *data = (unsigned char*) malloc( PVS_FILE_HEADER_SIZE + bytes );
+
+    int header[5] = { PVS_FILE_MAGIC, (int) mapHash, pvs->cellsX, pvs->cellsZ, PVS_CELL_SIZE };
+    memcpy( data, header, PVS_FILE_HEADER_SIZE );
+    memcpy( data + PVS_FILE_HEADER_SIZE, pvs->visible, bytes );
+
+    SaveFileData( cacheFilePath, data, PVS_FILE_HEADER_SIZE + bytes );
+    free( data );
+
+}
@@ -0,0 +1,133 @@
+/**
+ * @file QualityGovernor.c
+ * @author Prof. Dr. David Buzatto
+ * @brief QualityGovernor implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdbool.h>
+
+#include "QualityGovernor.h"
+#include "SceneTarget.h"
+
+// weight of the last frame in the averages
+static const float SMOOTHING = 0.1f;
+
+// fractions of the budget; the frame time must fall well below the budget
+// to raise the quality, so a frame just under it doesn't undo the last
+// reduction
+static const float OVER_BUDGET = 1.1f;
+static const float HEADROOM = 0.85f;
+static const float WORK_OVER_BUDGET = 0.9f;
+static const float WORK_HEADROOM = 0.5f;
+
+static const float SCALE_STEP_DOWN = 0.1f;
+static const float SCALE_STEP_UP = 0.05f;
+
+// seconds between changes
+static const float COOLDOWN_DOWN = 0.5f;
+static const float COOLDOWN_UP = 2.0f;
+
+void initQualityGovernor( QualityGovernor *qg, float budget ) {
+
+    *qg = (QualityGovernor){
+        .enabled = true,
+        .budget = budget,
+        .frameTime = budget,
+        .gpuTime = -1.0f,
+        .resolutionScale = 1.0f,
+        .level = QUALITY_LEVEL_FULL,
+        .cooldown = COOLDOWN_UP
+    };
+
+}
+
+void updateQualityGovernor( QualityGovernor *qg, float frameTime, float workTime, float gpuTime ) {
+
+    qg->changed = false;
+
+    qg->frameTime += ( frameTime - qg->frameTime ) * SMOOTHING;
+    qg->workTime += ( workTime - qg->workTime ) * SMOOTHING;
+
+    if ( gpuTime < 0.0f ) {
+        qg->gpuTime = -1.0f;
+    } else if ( qg->gpuTime < 0.0f ) {
+        qg->gpuTime = gpuTime;
+    } else {
+        qg->gpuTime += ( gpuTime - qg->gpuTime ) * SMOOTHING;
+    }
+
+    if ( !qg->enabled ) {
+        return;
+    }
+
+    qg->cooldown -= frameTime;
+
+    if ( qg->cooldown > 0.0f ) {
+        return;
+    }
+
+    // the GPU works on the frame while the CPU waits in EndDrawing, so its
+    // time is held like the work time
+    bool gpuMeasured = qg->gpuTime >= 0.0f;
+    bool overBudget = qg->frameTime > qg->budget * OVER_BUDGET || qg->workTime > qg->budget * WORK_OVER_BUDGET ||
+                      ( gpuMeasured && qg->gpuTime > qg->budget * WORK_OVER_BUDGET );
+    bool headroom = qg->frameTime < qg->budget * HEADROOM && qg->workTime < qg->budget * WORK_HEADROOM &&
+                    ( !gpuMeasured || qg->gpuTime < qg->budget * WORK_HEADROOM );
+
+    if ( overBudget ) {
+
+        if ( qg->resolutionScale > SCENE_TARGET_MIN_SCALE ) {
+            qg->resolutionScale -= SCALE_STEP_DOWN;
+            if ( qg->resolutionScale < SCENE_TARGET_MIN_SCALE ) {
+                qg->resolutionScale = SCENE_TARGET_MIN_SCALE;
+            }
+            qg->cooldown = COOLDOWN_DOWN;
+        } else if ( qg->level < QUALITY_LEVEL_QUANTITY - 1 ) {
+            qg->level++;
+            qg->changed = true;
+            qg->cooldown = COOLDOWN_DOWN;
+        }
+
+    } else if ( headroom ) {
+
+        // the features are cheaper to give back than the resolution
+        if ( qg->level > QUALITY_LEVEL_FULL ) {
+            qg->level--;
+            qg->changed = true;
+            qg->cooldown = COOLDOWN_UP;
+        } else if ( qg->resolutionScale < 1.0f ) {
+            qg->resolutionScale += SCALE_STEP_UP;
+            if ( qg->resolutionScale > 0.999f ) {
+                qg->resolutionScale = 1.0f;
+            }
+            qg->cooldown = COOLDOWN_UP;
+        }
+
+    }
+
+}
+
+void setEnabledQualityGovernor( QualityGovernor *qg, bool enabled ) {
+
+    qg->enabled = enabled;
+    qg->level = QUALITY_LEVEL_FULL;
+    qg->resolutionScale = 1.0f;
+    qg->cooldown = COOLDOWN_UP;
+
+}
+
+const char *getQualityLevelName( QualityLevel level ) {
+
+    switch ( level ) {
+        case QUALITY_LEVEL_FULL: return "full";
+        case QUALITY_LEVEL_FEWER_PARTICLES: return "fewer particles";
+        case QUALITY_LEVEL_NO_DECALS: return "no decals";
+        case QUALITY_LEVEL_NO_OUTLINES: return "no outlines";
+        case QUALITY_LEVEL_MEDIUM_LIGHTING: return "medium lighting";
+        case QUALITY_LEVEL_LOW_LIGHTING: return "low lighting";
+        case QUALITY_LEVEL_SHORT_DYNAMIC_LIGHTS: return "short dynamic lights";
+        default: return "unknown";
+    }
+
+}
@@ -0,0 +1,198 @@
+/**
+ * @file RenderQueue.c
+ * @author Prof. Dr. David Buzatto
+ * @brief RenderQueue implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "RenderQueue.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+// bits of each field of the sort key, from the most significant:
+// shader (12), outline off (1), diffuse texture (12), depth (24)
+#define KEY_SHADER_SHIFT 37
+#define KEY_OUTLINE_SHIFT 36
+#define KEY_TEXTURE_SHIFT 24
+#define KEY_ID_MASK 0xFFFu
+#define KEY_DEPTH_MAX 0xFFFFFFu
+
+// farthest distance told apart by the depth of the key
+static const float MAX_DEPTH = 500.0f;
+
+static int compareRenderItems( const void *p1, const void *p2 );
+
+void initRenderQueue( RenderQueue *rq, Shader depthShader ) {
+
+    *rq = (RenderQueue){
+        .initialized = true,
+        .capacity = 256,
+        .depthShader = depthShader,
+        .depthPrepass = true,
+        .outlineWidth = 1.0f
+    };
+
+    rq->items = (RenderItem*) malloc( rq->capacity * sizeof( RenderItem ) );
+
+}
+
+void destroyRenderQueue( RenderQueue *rq ) {
+
+    if ( !rq->initialized ) {
+        return;
+    }
+
+    free( rq->items );
+
+    *rq = (RenderQueue){ 0 };
+
+}
+
+void beginRenderQueue( RenderQueue *rq, Camera3D camera ) {
+    rq->count = 0;
+    rq->viewPosition = camera.position;
+    rq->viewForward = Vector3Normalize( Vector3Subtract( camera.target, camera.position ) );
+}
+
+void addRenderQueue( RenderQueue *rq, Mesh *mesh, Material *material, Matrix transform, Vector3 center, Color tint, Texture2D lightmap, bool outline ) {
+
+    if ( rq->count == rq->capacity ) {
+        rq->capacity *= 2;
+        rq->items = (RenderItem*) realloc( rq->items, rq->capacity * sizeof( RenderItem ) );
+    }
+
+    float depth = Clamp( Vector3DotProduct( Vector3Subtract( center, rq->viewPosition ), rq->viewForward ) / MAX_DEPTH, 0.0f, 1.0f );
+
+    unsigned long long key = 
+        ( (unsigned long long) ( material->shader.id & KEY_ID_MASK ) << KEY_SHADER_SHIFT ) |
+        ( (unsigned long long) !outline << KEY_OUTLINE_SHIFT ) |
+        ( (unsigned long long) ( material->maps[MATERIAL_MAP_DIFFUSE].texture.id & KEY_ID_MASK ) << KEY_TEXTURE_SHIFT ) |
+        (unsigned long long) ( depth * KEY_DEPTH_MAX );
+
+    rq->items[rq->count++] = (RenderItem){
+        .key = key,
+        .mesh = mesh,
+        .material = material,
+        .transform = transform,
+        .tint = tint,
+        .lightmap = lightmap,
+        .outline = outline
+    };
+
+}
+
+void addModelRenderQueue( RenderQueue *rq, Model *model, Matrix transform, Vector3 center, Color tint, Texture2D lightmap, bool outline ) {
+
+    transform = MatrixMultiply( model->transform, transform );
+
+    for ( int i = 0; i < model->meshCount; i++ ) {
+        addRenderQueue( rq, &model->meshes[i], &model->materials[model->meshMaterial[i]], transform, center, tint, lightmap, outline );
+    }
+
+}
+
+void drawRenderQueue( RenderQueue *rq ) {
+
+    rq->shaderChanges = 0;
+    rq->textureChanges = 0;
+    rq->drawCalls = 0;
+    rq->triangleCount = 0;
+
+    if ( rq->count == 0 ) {
+        return;
+    }
+
+    qsort( rq->items, rq->count, sizeof( RenderItem ), compareRenderItems );
+
+    // the lines and quads batched so far keep their own state
+    rlDrawRenderBatchActive();
+
+    if ( rq->depthPrepass ) {
+
+        rlColorMask( false, false, false, false );
+
+        for ( int i = 0; i < rq->count; i++ ) {
+            RenderItem *item = &rq->items[i];
+            Material material = *item->material;
+            material.shader = rq->depthShader;
+            DrawMesh( *item->mesh, material, item->transform );
+            rq->drawCalls++;
+            rq->triangleCount += item->mesh->triangleCount;
+        }
+
+        rlColorMask( true, true, true, true );
+
+    }
+
+    unsigned int shaderId = 0;
+    unsigned int textureId = 0;
+    bool outline = true;
+
+    for ( int i = 0; i < rq->count; i++ ) {
+
+        RenderItem *item = &rq->items[i];
+        Material *material = item->material;
+        MaterialMap *diffuse = &material->maps[MATERIAL_MAP_DIFFUSE];
+
+        if ( material->shader.id != shaderId || item->outline != outline ) {
+            if ( material->shader.id != shaderId ) {
+                rq->shaderChanges++;
+            }
+            shaderId = material->shader.id;
+            outline = item->outline;
+            SetShaderValue( material->shader, GetShaderLocation( material->shader, "outlineWidth" ), (float[1]){ outline ? rq->outlineWidth : 0.0f }, SHADER_UNIFORM_FLOAT );
+        }
+
+        if ( diffuse->texture.id != textureId ) {
+            rq->textureChanges++;
+            textureId = diffuse->texture.id;
+        }
+
+        if ( item->lightmap.id != 0 ) {
+            material->maps[MATERIAL_MAP_METALNESS].texture = item->lightmap;
+        }
+
+        // as DrawModelEx, the tint multiplies the diffuse color
+        Color color = diffuse->color;
+        diffuse->color = (Color){
+            (unsigned char) ( ( color.r * item->tint.r ) / 255 ),
+            (unsigned char) ( ( color.g * item->tint.g ) / 255 ),
+            (unsigned char) ( ( color.b * item->tint.b ) / 255 ),
+            (unsigned char) ( ( color.a * item->tint.a ) / 255 )
+        };
+
+        DrawMesh( *item->mesh, *material, item->transform );
+        rq->drawCalls++;
+        rq->triangleCount += item->mesh->triangleCount;
+
+        diffuse->color = color;
+
+        // the next shader may be the same, but with the outline on
+        if ( !outline && ( i == rq->count - 1 || rq->items[i + 1].material->shader.id != shaderId ) ) {
+            SetShaderValue( material->shader, GetShaderLocation( material->shader, "outlineWidth" ), &rq->outlineWidth, SHADER_UNIFORM_FLOAT );
+            outline = true;
+        }
+
+    }
+
+}
+
+Matrix getRenderTransform( Vector3 position, Vector3 rotationAxis, float rotationAngle, Vector3 scale ) {
+
+    Matrix matScale = MatrixScale( scale.x, scale.y, scale.z );
+    Matrix matRotation = MatrixRotate( rotationAxis, rotationAngle * DEG2RAD );
+    Matrix matTranslation = MatrixTranslate( position.x, position.y, position.z );
+
+    return MatrixMultiply( MatrixMultiply( matScale, matRotation ), matTranslation );
+
+}
+
+static int compareRenderItems( const void *p1, const void *p2 ) {
+    unsigned long long k1 = ( (const RenderItem*) p1 )->key;
+    unsigned long long k2 = ( (const RenderItem*) p2 )->key;
+    return ( k1 > k2 ) - ( k1 < k2 );
+}
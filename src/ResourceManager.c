@@ -15,12 +15,20 @@ ResourceManager rm = { 0 };
 
 void loadResourcesResourceManager( void ) {
 
-    rm.explosion0 = LoadTexture( "resources/images/blood0.png" );
-    rm.explosion1 = LoadTexture( "resources/images/blood1.png" );
-    rm.explosion2 = LoadTexture( "resources/images/blood2.png" );
-
-    rm.lightShader = LoadShader( "resources/shaders/glsl330/lighting.vs", "resources/shaders/glsl330/lighting.fs" );
-    rm.lightShader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation( rm.lightShader, "viewPos" );
+    const char *particleFiles[PARTICLE_FRAME_QUANTITY] = {
+        "resources/images/blood0.png",
+        "resources/images/blood1.png",
+        "resources/images/blood2.png"
+    };
+    rm.particleAtlas = loadParticleAtlas( particleFiles, PARTICLE_FRAME_QUANTITY, rm.particleFrames );
+
+    rm.sphereShader = LoadShader( "resources/shaders/glsl330/sphere.vs", "resources/shaders/glsl330/sphere.fs" );
+    rm.lightmapShader = LoadShader( "resources/shaders/glsl330/lightmap.vs", "resources/shaders/glsl330/lightmap.fs" );
+    rm.checkerShader = loadShaderVariant( "resources/shaders/glsl330/lightmap.vs", "resources/shaders/glsl330/lightmap.fs", "#define PROCEDURAL_CHECKER\n" );
+    rm.decalShader = LoadShader( "resources/shaders/glsl330/decal.vs", "resources/shaders/glsl330/decal.fs" );
+    rm.impostorShader = LoadShader( NULL, "resources/shaders/glsl330/impostor.fs" );
+    rm.depthShader = LoadShader( NULL, "resources/shaders/glsl330/depth.fs" );
+    rm.pickShader = LoadShader( NULL, "resources/shaders/glsl330/pick.fs" );
 
     rm.handgunSound = LoadSound( "resources/sfx/handgun.wav" );
     rm.submachinegunSound = LoadSound( "resources/sfx/submachinegun.wav" );
@@ -40,13 +48,37 @@ void loadResourcesResourceManager( void ) {
 
 }
 
+Shader getLightShaderResourceManager( LightingTier tier ) {
+
+    if ( rm.lightShaders[tier].id == 0 ) {
+        double startTime = GetTime();
+        bool cached = false;
+        rm.lightShaders[tier] = loadLightingShader( tier, &cached );
+        TraceLog( LOG_INFO, "SHADER: Light shader (%s) %s in %.1f ms", getLightingTierName( tier ),
+                  cached ? "loaded from the binary cache" : "compiled", ( GetTime() - startTime ) * 1000.0 );
+    }
+
+    return rm.lightShaders[tier];
+
+}
+
 void unloadResourcesResourceManager( void ) {
 
-    UnloadTexture( rm.explosion0 );
-    UnloadTexture( rm.explosion1 );
-    UnloadTexture( rm.explosion2 );
+    UnloadTexture( rm.particleAtlas );
 
-    UnloadShader( rm.lightShader );
+    for ( int i = 0; i < LIGHTING_TIER_QUANTITY; i++ ) {
+        if ( rm.lightShaders[i].id != 0 ) {
+            UnloadShader( rm.lightShaders[i] );
+            rm.lightShaders[i] = (Shader){ 0 };
+        }
+    }
+    UnloadShader( rm.sphereShader );
+    UnloadShader( rm.lightmapShader );
+    UnloadShader( rm.checkerShader );
+    UnloadShader( rm.decalShader );
+    UnloadShader( rm.impostorShader );
+    UnloadShader( rm.depthShader );
+    UnloadShader( rm.pickShader );
 
     UnloadSound( rm.handgunSound );
     UnloadSound( rm.submachinegunSound );
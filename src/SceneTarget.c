@@ -0,0 +1,112 @@
+/**
+ * @file SceneTarget.c
+ * @author Prof. Dr. David Buzatto
+ * @brief SceneTarget implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdbool.h>
+
+#include "SceneTarget.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+void beginSceneTarget( SceneTarget *st, float scale, Rectangle viewport, Color background ) {
+
+    int renderWidth = GetRenderWidth();
+    int renderHeight = GetRenderHeight();
+
+    // screen coordinates to framebuffer pixels, they differ with high DPI
+    float sx = (float) renderWidth / GetScreenWidth();
+    float sy = (float) renderHeight / GetScreenHeight();
+
+    st->viewport = viewport;
+    st->offscreen = scale < 1.0f;
+
+    // what the previous view left in the batch uses the previous viewport
+    rlDrawRenderBatchActive();
+
+    if ( !st->offscreen ) {
+
+        // the rows of the framebuffer go up
+        st->x = (int) ( viewport.x * sx );
+        st->y = (int) ( ( GetScreenHeight() - viewport.y - viewport.height ) * sy );
+        st->width = (int) ( viewport.width * sx );
+        st->height = (int) ( viewport.height * sy );
+
+    } else {
+
+        if ( st->target.id == 0 || st->target.texture.width != renderWidth || st->target.texture.height != renderHeight ) {
+            unloadSceneTarget( st );
+            st->target = LoadRenderTexture( renderWidth, renderHeight );
+            SetTextureFilter( st->target.texture, TEXTURE_FILTER_BILINEAR );
+        }
+
+        st->x = 0;
+        st->y = 0;
+        st->width = (int) ( viewport.width * sx * scale );
+        st->height = (int) ( viewport.height * sy * scale );
+
+        BeginTextureMode( st->target );
+
+    }
+
+    st->width = st->width < 1 ? 1 : st->width;
+    st->height = st->height < 1 ? 1 : st->height;
+
+    rlViewport( st->x, st->y, st->width, st->height );
+
+    // the other views may already be in the window
+    rlEnableScissorTest();
+    rlScissor( st->x, st->y, st->width, st->height );
+    ClearBackground( background );
+    rlDisableScissorTest();
+
+}
+
+void beginSceneMode3D( SceneTarget *st, Camera3D camera ) {
+
+    BeginMode3D( camera );
+
+    if ( camera.projection == CAMERA_PERSPECTIVE ) {
+        rlSetMatrixProjection( MatrixPerspective( camera.fovy * DEG2RAD, (double) st->width / st->height, rlGetCullDistanceNear(), rlGetCullDistanceFar() ) );
+    }
+
+}
+
+void endSceneTarget( SceneTarget *st ) {
+
+    if ( !st->offscreen ) {
+        rlDrawRenderBatchActive();
+        rlViewport( 0, 0, GetRenderWidth(), GetRenderHeight() );
+        return;
+    }
+
+    EndTextureMode();
+
+    // the alpha of the target is whatever the blending left there, so the
+    // scene replaces the window instead of being blended over it
+    rlDisableColorBlend();
+
+    // render textures are upside down and the region starts at the first row
+    DrawTexturePro(
+        st->target.texture,
+        (Rectangle){ 0, 0, st->width, -st->height },
+        st->viewport,
+        (Vector2){ 0 }, 0.0f, WHITE );
+
+    rlDrawRenderBatchActive();
+    rlEnableColorBlend();
+
+}
+
+void unloadSceneTarget( SceneTarget *st ) {
+
+    if ( st->target.id != 0 ) {
+        UnloadRenderTexture( st->target );
+    }
+
+    st->target = (RenderTexture2D){ 0 };
+
+}
@@ -0,0 +1,236 @@
+/**
+ * @file SphereBatch.c
+ * @author Prof. Dr. David Buzatto
+ * @brief SphereBatch implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "SphereBatch.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+// rings and slices of each level of detail
+static const int LOD_RINGS[SPHERE_BATCH_LOD_QUANTITY] = { 16, 8, 5 };
+static const int LOD_SLICES[SPHERE_BATCH_LOD_QUANTITY] = { 16, 12, 8 };
+
+// minimum radius on the screen, in pixels, to use each level of detail
+static const float LOD_MIN_PIXELS[SPHERE_BATCH_LOD_QUANTITY] = { 32.0f, 8.0f, 0.0f };
+
+static void pushSphereInstance( SphereInstanceList *list, SphereInstance instance );
+static void drawSphereInstanceList( SphereBatch *sb, Mesh *mesh, SphereInstanceList *list );
+static void drawSphereInstanceListImmediate( SphereInstanceList *list, int lod, bool wires );
+
+void initSphereBatch( SphereBatch *sb, Shader shader ) {
+
+    *sb = (SphereBatch){
+        .initialized = true,
+        .shader = shader,
+        .instancing = shader.id != 0 && shader.id != rlGetShaderIdDefault()
+    };
+
+    if ( sb->instancing ) {
+        sb->viewPosLoc = GetShaderLocation( shader, "viewPos" );
+        sb->gridSizeLoc = GetShaderLocation( shader, "gridSize" );
+        sb->instancePositionLoc = GetShaderLocationAttrib( shader, "instancePosition" );
+        sb->instanceColorLoc = GetShaderLocationAttrib( shader, "instanceColor" );
+        sb->instanceParamsLoc = GetShaderLocationAttrib( shader, "instanceParams" );
+        sb->instancing = sb->instancePositionLoc >= 0 && sb->instanceColorLoc >= 0 && sb->instanceParamsLoc >= 0;
+    }
+
+    if ( !sb->instancing ) {
+        TraceLog( LOG_WARNING, "SPHERES: Instancing shader not available, spheres will be drawn one by one" );
+    }
+
+    for ( int i = 0; i < SPHERE_BATCH_LOD_QUANTITY; i++ ) {
+        sb->lods[i] = GenMeshSphere( 1.0f, LOD_RINGS[i], LOD_SLICES[i] );
+    }
+
+}
+
+void destroySphereBatch( SphereBatch *sb ) {
+
+    if ( !sb->initialized ) {
+        return;
+    }
+
+    for ( int i = 0; i < SPHERE_BATCH_LOD_QUANTITY; i++ ) {
+        UnloadMesh( sb->lods[i] );
+        free( sb->solids[i].data );
+        free( sb->wires[i].data );
+        if ( sb->solids[i].vboId != 0 ) {
+            rlUnloadVertexBuffer( sb->solids[i].vboId );
+        }
+        if ( sb->wires[i].vboId != 0 ) {
+            rlUnloadVertexBuffer( sb->wires[i].vboId );
+        }
+    }
+
+    *sb = (SphereBatch){ 0 };
+
+}
+
+void beginSphereBatch( SphereBatch *sb, Camera3D camera, int screenHeight ) {
+
+    sb->camera = camera;
+
+    // radius on the screen = radius * pixelsPerUnit / distance
+    if ( camera.projection == CAMERA_PERSPECTIVE ) {
+        sb->pixelsPerUnit = ( screenHeight / 2.0f ) / tanf( camera.fovy * DEG2RAD / 2.0f );
+    } else {
+        sb->pixelsPerUnit = screenHeight / camera.fovy;
+    }
+
+    for ( int i = 0; i < SPHERE_BATCH_LOD_QUANTITY; i++ ) {
+        sb->solids[i].count = 0;
+        sb->wires[i].count = 0;
+    }
+
+}
+
+void addSphereBatch( SphereBatch *sb, Vector3 pos, float radius, Color color, float angle, int flags ) {
+
+    float pixels = radius * sb->pixelsPerUnit;
+
+    if ( sb->camera.projection == CAMERA_PERSPECTIVE ) {
+        float distance = Vector3Distance( pos, sb->camera.position );
+        pixels = distance > radius ? pixels / distance : LOD_MIN_PIXELS[0];
+    }
+
+    int lod = 0;
+    while ( lod < SPHERE_BATCH_LOD_QUANTITY - 1 && pixels < LOD_MIN_PIXELS[lod] ) {
+        lod++;
+    }
+
+    SphereInstance instance = {
+        .pos = pos,
+        .radius = radius,
+        .color = color,
+        .angle = angle,
+        .flags = flags
+    };
+
+    if ( sb->instancing ) {
+        pushSphereInstance( &sb->solids[lod], instance );
+        return;
+    }
+
+    if ( !( flags & SPHERE_BATCH_FLAG_WIRES_ONLY ) ) {
+        pushSphereInstance( &sb->solids[lod], instance );
+    }
+
+    if ( flags & ( SPHERE_BATCH_FLAG_WIRES | SPHERE_BATCH_FLAG_WIRES_ONLY ) ) {
+        instance.color = BLACK;
+        instance.flags = SPHERE_BATCH_FLAG_UNLIT;
+        pushSphereInstance( &sb->wires[lod], instance );
+    }
+
+}
+
+void drawSphereBatch( SphereBatch *sb ) {
+
+    sb->drawCalls = 0;
+    sb->instanceCount = 0;
+    sb->triangleCount = 0;
+
+    for ( int i = 0; i < SPHERE_BATCH_LOD_QUANTITY; i++ ) {
+        sb->instanceCount += sb->solids[i].count + sb->wires[i].count;
+        sb->triangleCount += ( sb->solids[i].count + sb->wires[i].count ) * sb->lods[i].triangleCount;
+    }
+
+    if ( !sb->instancing ) {
+        for ( int i = 0; i < SPHERE_BATCH_LOD_QUANTITY; i++ ) {
+            drawSphereInstanceListImmediate( &sb->solids[i], i, false );
+            drawSphereInstanceListImmediate( &sb->wires[i], i, true );
+        }
+        sb->drawCalls = sb->instanceCount;
+        return;
+    }
+
+    // anything pending in the immediate mode batch must be drawn first
+    rlDrawRenderBatchActive();
+
+    rlEnableShader( sb->shader.id );
+
+    Matrix mvp = MatrixMultiply( rlGetMatrixModelview(), rlGetMatrixProjection() );
+    rlSetUniformMatrix( sb->shader.locs[SHADER_LOC_MATRIX_MVP], mvp );
+    rlSetUniform( sb->viewPosLoc, &sb->camera.position, RL_SHADER_UNIFORM_VEC3, 1 );
+
+    for ( int i = 0; i < SPHERE_BATCH_LOD_QUANTITY; i++ ) {
+        Vector2 gridSize = { LOD_RINGS[i], LOD_SLICES[i] };
+        rlSetUniform( sb->gridSizeLoc, &gridSize, RL_SHADER_UNIFORM_VEC2, 1 );
+        drawSphereInstanceList( sb, &sb->lods[i], &sb->solids[i] );
+    }
+
+    rlDisableShader();
+
+}
+
+static void pushSphereInstance( SphereInstanceList *list, SphereInstance instance ) {
+
+    if ( list->count == list->capacity ) {
+        list->capacity = list->capacity == 0 ? 64 : list->capacity * 2;
+        list->data = (SphereInstance*) realloc( list->data, list->capacity * sizeof( SphereInstance ) );
+    }
+
+    list->data[list->count++] = instance;
+
+}
+
+static void drawSphereInstanceList( SphereBatch *sb, Mesh *mesh, SphereInstanceList *list ) {
+
+    if ( list->count == 0 ) {
+        return;
+    }
+
+    if ( list->vboCapacity < list->count ) {
+        if ( list->vboId != 0 ) {
+            rlUnloadVertexBuffer( list->vboId );
+        }
+        list->vboCapacity = list->capacity;
+        list->vboId = rlLoadVertexBuffer( NULL, list->vboCapacity * sizeof( SphereInstance ), true );
+    }
+
+    rlUpdateVertexBuffer( list->vboId, list->data, list->count * sizeof( SphereInstance ), 0 );
+
+    // the instance attributes are pointed to the buffer before each draw
+    rlEnableVertexArray( mesh->vaoId );
+    rlEnableVertexBuffer( list->vboId );
+
+    rlSetVertexAttribute( sb->instancePositionLoc, 4, RL_FLOAT, false, sizeof( SphereInstance ), 0 );
+    rlSetVertexAttributeDivisor( sb->instancePositionLoc, 1 );
+    rlEnableVertexAttribute( sb->instancePositionLoc );
+
+    rlSetVertexAttribute( sb->instanceColorLoc, 4, RL_UNSIGNED_BYTE, true, sizeof( SphereInstance ), 4 * sizeof( float ) );
+    rlSetVertexAttributeDivisor( sb->instanceColorLoc, 1 );
+    rlEnableVertexAttribute( sb->instanceColorLoc );
+
+    rlSetVertexAttribute( sb->instanceParamsLoc, 2, RL_FLOAT, false, sizeof( SphereInstance ), 4 * sizeof( float ) + sizeof( Color ) );
+    rlSetVertexAttributeDivisor( sb->instanceParamsLoc, 1 );
+    rlEnableVertexAttribute( sb->instanceParamsLoc );
+
+    rlDrawVertexArrayInstanced( 0, mesh->vertexCount, list->count );
+
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+
+    sb->drawCalls++;
+
+}
+
+static void drawSphereInstanceListImmediate( SphereInstanceList *list, int lod, bool wires ) {
+
+    for ( int i = 0; i < list->count; i++ ) {
+        SphereInstance *s = &list->data[i];
+        if ( wires ) {
+            DrawSphereWires( s->pos, s->radius, LOD_RINGS[lod], LOD_SLICES[lod], s->color );
+        } else {
+            DrawSphereEx( s->pos, s->radius, LOD_RINGS[lod], LOD_SLICES[lod], s->color );
+        }
+    }
+
+}
@@ -0,0 +1,441 @@
+/**
+ * @file StreamBuffer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief StreamBuffer implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "StreamBuffer.h"
+#include "GlFunctions.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+#define ARRAY_BUFFER 0x8892                 // GL_ARRAY_BUFFER
+#define MAP_WRITE_BIT 0x0002                // GL_MAP_WRITE_BIT
+#define MAP_INVALIDATE_RANGE_BIT 0x0004     // GL_MAP_INVALIDATE_RANGE_BIT
+#define MAP_UNSYNCHRONIZED_BIT 0x0020       // GL_MAP_UNSYNCHRONIZED_BIT
+#define MAP_PERSISTENT_BIT 0x0040           // GL_MAP_PERSISTENT_BIT
+#define MAP_COHERENT_BIT 0x0080             // GL_MAP_COHERENT_BIT
+#define SYNC_GPU_COMMANDS_COMPLETE 0x9117   // GL_SYNC_GPU_COMMANDS_COMPLETE
+#define SYNC_FLUSH_COMMANDS_BIT 0x0001      // GL_SYNC_FLUSH_COMMANDS_BIT
+#define ALREADY_SIGNALED 0x911A             // GL_ALREADY_SIGNALED
+#define WAIT_FAILED 0x911D                  // GL_WAIT_FAILED
+
+// how long to wait for the GPU to release a segment, in nanoseconds
+#define FENCE_TIMEOUT 1000000000ull
+
+// width of the lines, in pixels; the 3D ones are a bit wider so the
+// thin quads far away don't break in gaps
+static const float LINE_WIDTH_2D = 1.0f;
+static const float LINE_WIDTH_3D = 1.5f;
+
+static const int CIRCLE_SEGMENTS = 36;
+
+static StreamVertex *reserveVertices( StreamBuffer *sb, int quantity );
+static void pushQuad( StreamVertex *v, Vector3 p1, Vector3 p2, Vector3 p3, Vector3 p4, Color color );
+static void enableAttributes( StreamBuffer *sb );
+static void loadBuffer( StreamBuffer *sb );
+static void writeVertices( StreamBuffer *sb, int first, int size );
+
+void initStreamBuffer( StreamBuffer *sb ) {
+
+    *sb = (StreamBuffer){
+        .initialized = true,
+        .mode = STREAM_BUFFER_MODE_SUB_DATA
+    };
+
+    sb->vaoId = rlLoadVertexArray();
+    rlEnableVertexArray( sb->vaoId );
+
+    // the whole ring in one buffer, the segments are written with offsets
+    loadBuffer( sb );
+
+    if ( sb->mode != STREAM_BUFFER_MODE_PERSISTENT ) {
+        sb->memory = (StreamVertex*) malloc( STREAM_BUFFER_FRAME_VERTICES * sizeof( StreamVertex ) );
+        sb->vertices = sb->memory;
+    } else {
+        sb->vertices = sb->mapped;
+    }
+
+    // without vertex arrays the attributes are set before each draw
+    if ( sb->vaoId != 0 ) {
+        enableAttributes( sb );
+    }
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+
+}
+
+void destroyStreamBuffer( StreamBuffer *sb ) {
+
+    if ( !sb->initialized ) {
+        return;
+    }
+
+#ifndef __EMSCRIPTEN__
+    if ( sb->mode != STREAM_BUFFER_MODE_SUB_DATA ) {
+        for ( int i = 0; i < STREAM_BUFFER_FRAMES; i++ ) {
+            if ( sb->fences[i] != NULL ) {
+                glad_glDeleteSync( sb->fences[i] );
+            }
+        }
+    }
+
+    if ( sb->mode == STREAM_BUFFER_MODE_PERSISTENT ) {
+        glad_glBindBuffer( ARRAY_BUFFER, sb->vboId );
+        glad_glUnmapBuffer( ARRAY_BUFFER );
+        glad_glBindBuffer( ARRAY_BUFFER, 0 );
+    }
+#endif
+
+    rlUnloadVertexArray( sb->vaoId );
+    rlUnloadVertexBuffer( sb->vboId );
+    free( sb->memory );
+
+    *sb = (StreamBuffer){ 0 };
+
+}
+
+void beginStreamBuffer( StreamBuffer *sb ) {
+
+    sb->fenceWaits = 0;
+
+#ifndef __EMSCRIPTEN__
+    if ( sb->mode != STREAM_BUFFER_MODE_SUB_DATA ) {
+
+        // the draws of the last frame are the last ones to read its segment
+        if ( sb->drawCalls > 0 ) {
+            sb->fences[sb->segment] = glad_glFenceSync( SYNC_GPU_COMMANDS_COMPLETE, 0 );
+        }
+
+        int next = ( sb->segment + 1 ) % STREAM_BUFFER_FRAMES;
+
+        if ( sb->fences[next] != NULL ) {
+            unsigned int result = glad_glClientWaitSync( sb->fences[next], SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT );
+            if ( result == WAIT_FAILED ) {
+                TraceLog( LOG_WARNING, "STREAM BUFFER: Failed to wait for segment %d", next );
+            } else if ( result != ALREADY_SIGNALED ) {
+                sb->fenceWaits++;
+            }
+            glad_glDeleteSync( sb->fences[next] );
+            sb->fences[next] = NULL;
+        }
+
+    }
+#endif
+
+    sb->segment = ( sb->segment + 1 ) % STREAM_BUFFER_FRAMES;
+    sb->count = 0;
+    sb->drawnCount = 0;
+
+    // the persistent mapping is written in place, at the segment
+    if ( sb->mode == STREAM_BUFFER_MODE_PERSISTENT ) {
+        sb->vertices = sb->mapped + sb->segment * STREAM_BUFFER_FRAME_VERTICES;
+    }
+
+    sb->drawCalls = 0;
+    sb->uploadedBytes = 0;
+    sb->droppedVertices = 0;
+
+}
+
+void setCameraStreamBuffer( StreamBuffer *sb, Camera3D camera, int viewportHeight ) {
+
+    // world units covered by one pixel at one unit of distance
+    sb->viewPosition = camera.position;
+    sb->pixelSize = 2.0f * tanf( camera.fovy * 0.5f * DEG2RAD ) / viewportHeight;
+
+}
+
+void addTriangleStreamBuffer( StreamBuffer *sb, Vector3 v1, Vector3 v2, Vector3 v3, Color color ) {
+
+    StreamVertex *v = reserveVertices( sb, 3 );
+
+    if ( v != NULL ) {
+        v[0] = (StreamVertex){ v1, color };
+        v[1] = (StreamVertex){ v2, color };
+        v[2] = (StreamVertex){ v3, color };
+    }
+
+}
+
+void addLine3DStreamBuffer( StreamBuffer *sb, Vector3 startPos, Vector3 endPos, Color color ) {
+
+    // the quad is widened across the line and the direction to the camera
+    Vector3 middle = Vector3Scale( Vector3Add( startPos, endPos ), 0.5f );
+    Vector3 side = Vector3CrossProduct( Vector3Subtract( endPos, startPos ), Vector3Subtract( middle, sb->viewPosition ) );
+
+    // a line pointing to the camera is a point on the screen
+    if ( Vector3LengthSqr( side ) < 0.000001f ) {
+        return;
+    }
+
+    StreamVertex *v = reserveVertices( sb, 6 );
+
+    if ( v != NULL ) {
+
+        side = Vector3Normalize( side );
+
+        float halfWidth = LINE_WIDTH_3D * 0.5f * sb->pixelSize;
+        Vector3 startSide = Vector3Scale( side, halfWidth * Vector3Distance( startPos, sb->viewPosition ) );
+        Vector3 endSide = Vector3Scale( side, halfWidth * Vector3Distance( endPos, sb->viewPosition ) );
+
+        pushQuad( v,
+                  Vector3Subtract( startPos, startSide ), Vector3Add( startPos, startSide ),
+                  Vector3Add( endPos, endSide ), Vector3Subtract( endPos, endSide ),
+                  color );
+
+    }
+
+}
+
+void addCubeWiresStreamBuffer( StreamBuffer *sb, Vector3 pos, Vector3 dim, Color color ) {
+
+    float x1 = pos.x - dim.x / 2;
+    float y1 = pos.y - dim.y / 2;
+    float z1 = pos.z - dim.z / 2;
+    float x2 = pos.x + dim.x / 2;
+    float y2 = pos.y + dim.y / 2;
+    float z2 = pos.z + dim.z / 2;
+
+    Vector3 c[8] = {
+        { x1, y1, z1 }, { x2, y1, z1 }, { x2, y1, z2 }, { x1, y1, z2 },
+        { x1, y2, z1 }, { x2, y2, z1 }, { x2, y2, z2 }, { x1, y2, z2 }
+    };
+
+    // bottom, top and vertical edges
+    for ( int i = 0; i < 4; i++ ) {
+        addLine3DStreamBuffer( sb, c[i], c[(i+1)%4], color );
+        addLine3DStreamBuffer( sb, c[i+4], c[(i+1)%4+4], color );
+        addLine3DStreamBuffer( sb, c[i], c[i+4], color );
+    }
+
+}
+
+void addRectangleStreamBuffer( StreamBuffer *sb, float x, float y, float width, float height, Color color ) {
+
+    StreamVertex *v = reserveVertices( sb, 6 );
+
+    if ( v != NULL ) {
+        pushQuad( v,
+                  (Vector3){ x, y, 0.0f }, (Vector3){ x, y + height, 0.0f },
+                  (Vector3){ x + width, y + height, 0.0f }, (Vector3){ x + width, y, 0.0f },
+                  color );
+    }
+
+}
+
+void addLine2DStreamBuffer( StreamBuffer *sb, Vector2 startPos, Vector2 endPos, Color color ) {
+
+    Vector2 d = Vector2Subtract( endPos, startPos );
+    float length = Vector2Length( d );
+
+    if ( length == 0.0f ) {
+        return;
+    }
+
+    StreamVertex *v = reserveVertices( sb, 6 );
+
+    if ( v != NULL ) {
+
+        float s = LINE_WIDTH_2D * 0.5f / length;
+        Vector3 side = { -d.y * s, d.x * s, 0.0f };
+        Vector3 start = { startPos.x, startPos.y, 0.0f };
+        Vector3 end = { endPos.x, endPos.y, 0.0f };
+
+        pushQuad( v,
+                  Vector3Subtract( start, side ), Vector3Add( start, side ),
+                  Vector3Add( end, side ), Vector3Subtract( end, side ),
+                  color );
+
+    }
+
+}
+
+void addCircleLinesStreamBuffer( StreamBuffer *sb, Vector2 center, float radius, Color color ) {
+
+    Vector2 previous = { center.x + radius, center.y };
+
+    for ( int i = 1; i <= CIRCLE_SEGMENTS; i++ ) {
+        float angle = 2.0f * PI * i / CIRCLE_SEGMENTS;
+        Vector2 current = { center.x + cosf( angle ) * radius, center.y + sinf( angle ) * radius };
+        addLine2DStreamBuffer( sb, previous, current, color );
+        previous = current;
+    }
+
+}
+
+void drawStreamBuffer( StreamBuffer *sb ) {
+
+    int quantity = sb->count - sb->drawnCount;
+
+    if ( quantity == 0 ) {
+        return;
+    }
+
+    // what rlgl has batched so far is drawn first, to keep the order
+    rlDrawRenderBatchActive();
+
+    int first = sb->segment * STREAM_BUFFER_FRAME_VERTICES + sb->drawnCount;
+    int size = quantity * sizeof( StreamVertex );
+
+    writeVertices( sb, first, size );
+
+    int *locs = rlGetShaderLocsDefault();
+    float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    rlEnableShader( rlGetShaderIdDefault() );
+    rlSetUniformMatrix( locs[RL_SHADER_LOC_MATRIX_MVP], MatrixMultiply( rlGetMatrixModelview(), rlGetMatrixProjection() ) );
+    rlSetUniform( locs[RL_SHADER_LOC_COLOR_DIFFUSE], white, RL_SHADER_UNIFORM_VEC4, 1 );
+
+    // the default shader samples the white texture when there's no texcoord
+    rlActiveTextureSlot( 0 );
+    rlEnableTexture( rlGetTextureIdDefault() );
+
+    // the quads of the lines face either side
+    rlDisableBackfaceCulling();
+
+    if ( !rlEnableVertexArray( sb->vaoId ) ) {
+        enableAttributes( sb );
+    }
+
+    rlDrawVertexArray( first, quantity );
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlEnableBackfaceCulling();
+    rlDisableTexture();
+    rlDisableShader();
+
+    sb->drawnCount = sb->count;
+    sb->drawCalls++;
+    sb->uploadedBytes += size;
+
+}
+
+const char *getStreamBufferModeName( StreamBufferMode mode ) {
+
+    switch ( mode ) {
+        case STREAM_BUFFER_MODE_PERSISTENT: return "persistent";
+        case STREAM_BUFFER_MODE_MAPPED: return "mapped";
+        case STREAM_BUFFER_MODE_SUB_DATA: return "sub data";
+        default: return "unknown";
+    }
+
+}
+
+static StreamVertex *reserveVertices( StreamBuffer *sb, int quantity ) {
+
+    if ( sb->count + quantity > STREAM_BUFFER_FRAME_VERTICES ) {
+        sb->droppedVertices += quantity;
+        return NULL;
+    }
+
+    StreamVertex *v = &sb->vertices[sb->count];
+    sb->count += quantity;
+
+    return v;
+
+}
+
+// two triangles, 1-2-3 and 1-3-4
+static void pushQuad( StreamVertex *v, Vector3 p1, Vector3 p2, Vector3 p3, Vector3 p4, Color color ) {
+    v[0] = (StreamVertex){ p1, color };
+    v[1] = (StreamVertex){ p2, color };
+    v[2] = (StreamVertex){ p3, color };
+    v[3] = (StreamVertex){ p1, color };
+    v[4] = (StreamVertex){ p3, color };
+    v[5] = (StreamVertex){ p4, color };
+}
+
+static void enableAttributes( StreamBuffer *sb ) {
+
+    rlEnableVertexBuffer( sb->vboId );
+
+    rlSetVertexAttribute( RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false, sizeof( StreamVertex ), 0 );
+    rlEnableVertexAttribute( RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION );
+
+    rlSetVertexAttribute( RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, sizeof( StreamVertex ), sizeof( Vector3 ) );
+    rlEnableVertexAttribute( RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR );
+
+    // the texcoords keep the default value
+    rlDisableVertexAttribute( RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD );
+
+}
+
+static void loadBuffer( StreamBuffer *sb ) {
+
+    int size = STREAM_BUFFER_FRAMES * STREAM_BUFFER_FRAME_VERTICES * sizeof( StreamVertex );
+
+#ifndef __EMSCRIPTEN__
+    int version = rlGetVersion();
+    bool fences = ( version == RL_OPENGL_33 || version == RL_OPENGL_43 ) &&
+                  glad_glFenceSync != NULL && glad_glClientWaitSync != NULL && glad_glDeleteSync != NULL &&
+                  glad_glMapBufferRange != NULL && glad_glUnmapBuffer != NULL;
+
+    // the storage is immutable, so the buffer isn't created by rlgl
+    if ( fences && glad_glBufferStorage != NULL ) {
+
+        unsigned int flags = MAP_WRITE_BIT | MAP_PERSISTENT_BIT | MAP_COHERENT_BIT;
+
+        glad_glGenBuffers( 1, &sb->vboId );
+        glad_glBindBuffer( ARRAY_BUFFER, sb->vboId );
+        glad_glBufferStorage( ARRAY_BUFFER, size, NULL, flags );
+        sb->mapped = (StreamVertex*) glad_glMapBufferRange( ARRAY_BUFFER, 0, size, flags );
+
+        if ( sb->mapped != NULL ) {
+            sb->mode = STREAM_BUFFER_MODE_PERSISTENT;
+            return;
+        }
+
+        glad_glBindBuffer( ARRAY_BUFFER, 0 );
+        glad_glDeleteBuffers( 1, &sb->vboId );
+        TraceLog( LOG_WARNING, "STREAM BUFFER: Failed to map the buffer persistently" );
+
+    }
+
+    if ( fences ) {
+        sb->mode = STREAM_BUFFER_MODE_MAPPED;
+    }
+#endif
+
+    sb->vboId = rlLoadVertexBuffer( NULL, size, true );
+
+}
+
+// the fences keep the GPU out of the segment, so the driver doesn't have to
+static void writeVertices( StreamBuffer *sb, int first, int size ) {
+
+    if ( sb->mode == STREAM_BUFFER_MODE_PERSISTENT ) {
+        return;
+    }
+
+#ifndef __EMSCRIPTEN__
+    if ( sb->mode == STREAM_BUFFER_MODE_MAPPED ) {
+
+        glad_glBindBuffer( ARRAY_BUFFER, sb->vboId );
+        void *data = glad_glMapBufferRange( ARRAY_BUFFER, first * sizeof( StreamVertex ), size,
+                                            MAP_WRITE_BIT | MAP_INVALIDATE_RANGE_BIT | MAP_UNSYNCHRONIZED_BIT );
+
+        if ( data != NULL ) {
+            memcpy( data, &sb->vertices[sb->drawnCount], size );
+            glad_glUnmapBuffer( ARRAY_BUFFER );
+            glad_glBindBuffer( ARRAY_BUFFER, 0 );
+            return;
+        }
+
+        glad_glBindBuffer( ARRAY_BUFFER, 0 );
+
+    }
+#endif
+
+    rlUpdateVertexBuffer( sb->vboId, &sb->vertices[sb->drawnCount], size, first * sizeof( StreamVertex ) );
+
+}
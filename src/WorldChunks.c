@@ -0,0 +1,579 @@
+/**
+ * @file WorldChunks.c
+ * @author Prof. Dr. David Buzatto
+ * @brief WorldChunks implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "WorldChunks.h"
+#include "EntitySupport.h"
+#include "WorldMesher.h"
+#include "Lightmap.h"
+#include "Block.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+#include "raylib/rlgl.h"
+
+static void *runWorldChunksWorker( void *data );
+static void meshWorldChunk( WorldChunks *wc, WorldChunkJob *job );
+static void bakeWorldChunk( WorldChunks *wc, WorldChunkJob *job, VoxelGrid *occluders, int threadQuantity );
+static WorldChunkOccluders *acquireOccluders( WorldChunks *wc );
+static void releaseOccluders( WorldChunks *wc, WorldChunkOccluders *occluders );
+static void uploadWorldChunk( WorldChunks *wc, WorldChunkJob *job );
+static void submitWorldChunk( WorldChunks *wc, int chunkIndex );
+static void invalidateWorldChunks( WorldChunks *wc, BoundingBox box );
+static int getChunkIndexWorldChunks( WorldChunks *wc, Vector3 pos );
+static unsigned char getBlockMaterial( Block *block );
+
+void initWorldChunks( WorldChunks *wc, Obstacles *obstacles, BoundingBox worldBounds, float blockSize, Color obstacleColor, Color breakableObstacleColor, const Light *lights, int lightQuantity, float lightRadius ) {
+
+    *wc = (WorldChunks){
+        .initialized = true,
+        .obstacles = obstacles,
+        .blockSize = blockSize,
+        .shader = {
+            .id = rlGetShaderIdDefault(),
+            .locs = rlGetShaderLocsDefault()
+        },
+        .palette = { BLANK, obstacleColor, breakableObstacleColor },
+        .lights = (Light*) malloc( ( lightQuantity > 0 ? lightQuantity : 1 ) * sizeof( Light ) ),
+        .lightQuantity = lightQuantity,
+        .lightRadius = lightRadius
+    };
+
+    for ( int i = 0; i < lightQuantity; i++ ) {
+        wc->lights[i] = lights[i];
+    }
+
+    for ( int i = 0; i < Obstacles_size( obstacles ); i++ ) {
+        BoundingBox bb = getBlockBoundingBox( &obstacles->data[i] );
+        worldBounds.min = Vector3Min( worldBounds.min, bb.min );
+        worldBounds.max = Vector3Max( worldBounds.max, bb.max );
+    }
+
+    // voxels of 1 unit, since obstacles are placed one unit apart
+    wc->grid = createVoxelGrid( worldBounds, 1.0f );
+    wc->chunkCountX = ( wc->grid.width + WORLD_CHUNK_SIZE - 1 ) / WORLD_CHUNK_SIZE;
+    wc->chunkCountZ = ( wc->grid.depth + WORLD_CHUNK_SIZE - 1 ) / WORLD_CHUNK_SIZE;
+    wc->chunkQuantity = wc->chunkCountX * wc->chunkCountZ;
+    wc->chunks = (WorldChunk*) calloc( wc->chunkQuantity > 0 ? wc->chunkQuantity : 1, sizeof( WorldChunk ) );
+    wc->jobs = (WorldChunkJob*) calloc( wc->chunkQuantity > 0 ? wc->chunkQuantity : 1, sizeof( WorldChunkJob ) );
+    wc->results = (WorldChunkJob*) calloc( wc->chunkQuantity > 0 ? wc->chunkQuantity : 1, sizeof( WorldChunkJob ) );
+
+    float s = wc->grid.voxelSize;
+    float border = blockSize / 2;
+
+    for ( int z = 0; z < wc->chunkCountZ; z++ ) {
+        for ( int x = 0; x < wc->chunkCountX; x++ ) {
+
+            WorldChunk *chunk = &wc->chunks[z * wc->chunkCountX + x];
+
+            chunk->minX = x * WORLD_CHUNK_SIZE;
+            chunk->minZ = z * WORLD_CHUNK_SIZE;
+            chunk->maxX = chunk->minX + WORLD_CHUNK_SIZE < wc->grid.width ? chunk->minX + WORLD_CHUNK_SIZE : wc->grid.width;
+            chunk->maxZ = chunk->minZ + WORLD_CHUNK_SIZE < wc->grid.depth ? chunk->minZ + WORLD_CHUNK_SIZE : wc->grid.depth;
+
+            chunk->bounds = (BoundingBox){
+                .min = {
+                    wc->grid.origin.x + chunk->minX * s - border,
+                    wc->grid.origin.y,
+                    wc->grid.origin.z + chunk->minZ * s - border
+                },
+                .max = {
+                    wc->grid.origin.x + chunk->maxX * s + border,
+                    wc->grid.origin.y + wc->grid.height * s,
+                    wc->grid.origin.z + chunk->maxZ * s + border
+                }
+            };
+
+        }
+    }
+
+    for ( int i = 0; i < Obstacles_size( obstacles ); i++ ) {
+        Block *block = &obstacles->data[i];
+        setVoxelGridBlock( &wc->grid, block, getBlockMaterial( block ) );
+        BlockIndexes_push( &wc->chunks[getChunkIndexWorldChunks( wc, block->pos )].blocks, i );
+    }
+
+    Image img = GenImageChecked( 2, 2, 1, 1, WHITE, LIGHTGRAY );
+    wc->texture = LoadTextureFromImage( img );
+    UnloadImage( img );
+
+    // the first meshing is done right away, while the map is loading
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+        WorldChunkJob job = {
+            .chunk = i,
+            .version = 0,
+            .grid = wc->grid
+        };
+        WorldChunk *chunk = &wc->chunks[i];
+        job.data = buildGreedyMeshData( &wc->grid, chunk->minX, 0, chunk->minZ, chunk->maxX, wc->grid.height, chunk->maxZ, wc->blockSize, wc->palette );
+        bakeWorldChunk( wc, &job, &wc->grid, LIGHTMAP_BAKE_THREADS );
+        uploadWorldChunk( wc, &job );
+    }
+
+    pthread_mutex_init( &wc->mutex, NULL );
+    pthread_cond_init( &wc->jobAvailable, NULL );
+
+    // without threads (e.g. web builds) the jobs run in updateWorldChunks
+    wc->workerRunning = true;
+    if ( pthread_create( &wc->worker, NULL, runWorldChunksWorker, wc ) != 0 ) {
+        wc->workerRunning = false;
+        TraceLog( LOG_WARNING, "WORLD: Worker thread not available, chunks will be meshed in the main thread" );
+    }
+
+}
+
+void destroyWorldChunks( WorldChunks *wc ) {
+
+    if ( !wc->initialized ) {
+        return;
+    }
+
+    if ( wc->workerRunning ) {
+        pthread_mutex_lock( &wc->mutex );
+        wc->workerRunning = false;
+        pthread_cond_broadcast( &wc->jobAvailable );
+        pthread_mutex_unlock( &wc->mutex );
+        pthread_join( wc->worker, NULL );
+    }
+
+    for ( int i = 0; i < wc->jobCount; i++ ) {
+        destroyVoxelGrid( &wc->jobs[( wc->jobStart + i ) % wc->chunkQuantity].grid );
+        releaseOccluders( wc, wc->jobs[( wc->jobStart + i ) % wc->chunkQuantity].occluders );
+    }
+
+    if ( wc->occluders != NULL ) {
+        releaseOccluders( wc, wc->occluders );
+        wc->occluders = NULL;
+    }
+
+    pthread_mutex_destroy( &wc->mutex );
+    pthread_cond_destroy( &wc->jobAvailable );
+
+    for ( int i = 0; i < wc->resultCount; i++ ) {
+        unloadGreedyMeshData( &wc->results[( wc->resultStart + i ) % wc->chunkQuantity].data );
+        UnloadImage( wc->results[( wc->resultStart + i ) % wc->chunkQuantity].lightmap );
+    }
+
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+        if ( wc->chunks[i].modelLoaded ) {
+            UnloadModel( wc->chunks[i].model );
+            UnloadTexture( wc->chunks[i].lightmap );
+        }
+        BlockIndexes_drop( &wc->chunks[i].blocks );
+    }
+
+    UnloadTexture( wc->texture );
+    destroyVoxelGrid( &wc->grid );
+    free( wc->lights );
+    free( wc->chunks );
+    free( wc->jobs );
+    free( wc->results );
+
+    *wc = (WorldChunks){ 0 };
+
+}
+
+void setShaderWorldChunks( WorldChunks *wc, Shader shader ) {
+
+    wc->shader = shader;
+
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+        if ( wc->chunks[i].modelLoaded ) {
+            wc->chunks[i].model.materials[0].shader = shader;
+        }
+    }
+
+}
+
+void updateWorldChunks( WorldChunks *wc ) {
+
+    if ( !wc->initialized ) {
+        return;
+    }
+
+    // meshes that are ready
+    while ( true ) {
+
+        WorldChunkJob result;
+        bool hasResult = false;
+
+        pthread_mutex_lock( &wc->mutex );
+        if ( wc->resultCount > 0 ) {
+            result = wc->results[wc->resultStart];
+            wc->resultStart = ( wc->resultStart + 1 ) % wc->chunkQuantity;
+            wc->resultCount--;
+            hasResult = true;
+        }
+        pthread_mutex_unlock( &wc->mutex );
+
+        if ( !hasResult ) {
+            break;
+        }
+
+        // even if the chunk changed again the result is newer than the current mesh
+        wc->chunks[result.chunk].jobPending = false;
+        uploadWorldChunk( wc, &result );
+
+    }
+
+    // changed chunks
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+        WorldChunk *chunk = &wc->chunks[i];
+        if ( chunk->version != chunk->meshedVersion && !chunk->jobPending ) {
+            submitWorldChunk( wc, i );
+        }
+    }
+
+}
+
+void drawWorldChunks( WorldChunks *wc, RenderQueue *rq, StreamBuffer *sb, bool renderTouchColor, const bool *visibleChunks ) {
+
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+
+        WorldChunk *chunk = &wc->chunks[i];
+
+        if ( visibleChunks != NULL && !visibleChunks[i] ) {
+            continue;
+        }
+
+        // the merged mesh can't show the touch color of each obstacle
+        if ( renderTouchColor ) {
+            c_foreach ( it, BlockIndexes, chunk->blocks ) {
+                drawBlock( &wc->obstacles->data[*it.ref] );
+            }
+        } else {
+            if ( chunk->modelLoaded ) {
+                Vector3 center = Vector3Scale( Vector3Add( chunk->bounds.min, chunk->bounds.max ), 0.5f );
+                addModelRenderQueue( rq, &chunk->model, MatrixIdentity(), center, WHITE, (Texture2D){ 0 }, true );
+            }
+            if ( !shaderOutlines ) {
+                c_foreach ( it, BlockIndexes, chunk->blocks ) {
+                    Block *block = &wc->obstacles->data[*it.ref];
+                    addCubeWiresStreamBuffer( sb, block->pos, block->dim, BLACK );
+                }
+            }
+        }
+
+    }
+
+}
+
+void addBlockWorldChunks( WorldChunks *wc, Block block ) {
+
+    Obstacles_push( wc->obstacles, block );
+    int index = Obstacles_size( wc->obstacles ) - 1;
+
+    BlockIndexes_push( &wc->chunks[getChunkIndexWorldChunks( wc, block.pos )].blocks, index );
+    setVoxelGridBlock( &wc->grid, &block, getBlockMaterial( &block ) );
+    invalidateWorldChunks( wc, getBlockBoundingBox( &block ) );
+
+}
+
+void removeBlockWorldChunks( WorldChunks *wc, int index ) {
+
+    Block block = wc->obstacles->data[index];
+    BlockIndexes *blocks = &wc->chunks[getChunkIndexWorldChunks( wc, block.pos )].blocks;
+
+    for ( int i = 0; i < BlockIndexes_size( blocks ); i++ ) {
+        if ( blocks->data[i] == index ) {
+            blocks->data[i] = *BlockIndexes_back( blocks );
+            BlockIndexes_pop( blocks );
+            break;
+        }
+    }
+
+    // the last obstacle takes the place of the removed one
+    int last = Obstacles_size( wc->obstacles ) - 1;
+
+    if ( index != last ) {
+
+        Block *moved = &wc->obstacles->data[last];
+        BlockIndexes *movedBlocks = &wc->chunks[getChunkIndexWorldChunks( wc, moved->pos )].blocks;
+
+        for ( int i = 0; i < BlockIndexes_size( movedBlocks ); i++ ) {
+            if ( movedBlocks->data[i] == last ) {
+                movedBlocks->data[i] = index;
+                break;
+            }
+        }
+
+        wc->obstacles->data[index] = *moved;
+
+    }
+
+    Obstacles_pop( wc->obstacles );
+
+    // neighbours may share voxels with the removed obstacle
+    BoundingBox bb = getBlockBoundingBox( &block );
+    int neighbours[64];
+    int neighbourCount = queryBoxWorldChunks( wc, bb, neighbours, 64 );
+
+    setVoxelGridBlock( &wc->grid, &block, WORLD_CHUNK_MATERIAL_NONE );
+    for ( int i = 0; i < neighbourCount; i++ ) {
+        Block *neighbour = &wc->obstacles->data[neighbours[i]];
+        setVoxelGridBlock( &wc->grid, neighbour, getBlockMaterial( neighbour ) );
+    }
+
+    invalidateWorldChunks( wc, bb );
+
+}
+
+int queryBoxWorldChunks( WorldChunks *wc, BoundingBox box, int *indexes, int maxIndexes ) {
+
+    if ( !wc->initialized || wc->chunkQuantity == 0 ) {
+        return 0;
+    }
+
+    float s = wc->grid.voxelSize * WORLD_CHUNK_SIZE;
+    float border = wc->blockSize / 2;
+
+    int x0 = (int) floorf( ( box.min.x - border - wc->grid.origin.x ) / s );
+    int z0 = (int) floorf( ( box.min.z - border - wc->grid.origin.z ) / s );
+    int x1 = (int) floorf( ( box.max.x + border - wc->grid.origin.x ) / s );
+    int z1 = (int) floorf( ( box.max.z + border - wc->grid.origin.z ) / s );
+
+    x0 = x0 < 0 ? 0 : x0;
+    z0 = z0 < 0 ? 0 : z0;
+    x1 = x1 >= wc->chunkCountX ? wc->chunkCountX - 1 : x1;
+    z1 = z1 >= wc->chunkCountZ ? wc->chunkCountZ - 1 : z1;
+
+    int count = 0;
+
+    for ( int z = z0; z <= z1; z++ ) {
+        for ( int x = x0; x <= x1; x++ ) {
+            c_foreach ( it, BlockIndexes, wc->chunks[z * wc->chunkCountX + x].blocks ) {
+                if ( count < maxIndexes && CheckCollisionBoxes( box, getBlockBoundingBox( &wc->obstacles->data[*it.ref] ) ) ) {
+                    indexes[count++] = *it.ref;
+                }
+            }
+        }
+    }
+
+    return count;
+
+}
+
+int getQuadCountWorldChunks( WorldChunks *wc ) {
+
+    int quadCount = 0;
+
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+        quadCount += wc->chunks[i].quadCount;
+    }
+
+    return quadCount;
+
+}
+
+int getPendingJobsWorldChunks( WorldChunks *wc ) {
+
+    int pending = 0;
+
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+        if ( wc->chunks[i].jobPending ) {
+            pending++;
+        }
+    }
+
+    return pending;
+
+}
+
+static void *runWorldChunksWorker( void *data ) {
+
+    WorldChunks *wc = (WorldChunks*) data;
+
+    pthread_mutex_lock( &wc->mutex );
+
+    while ( true ) {
+
+        while ( wc->workerRunning && wc->jobCount == 0 ) {
+            pthread_cond_wait( &wc->jobAvailable, &wc->mutex );
+        }
+
+        if ( !wc->workerRunning ) {
+            break;
+        }
+
+        WorldChunkJob job = wc->jobs[wc->jobStart];
+        wc->jobStart = ( wc->jobStart + 1 ) % wc->chunkQuantity;
+        wc->jobCount--;
+
+        pthread_mutex_unlock( &wc->mutex );
+        meshWorldChunk( wc, &job );
+        releaseOccluders( wc, job.occluders );
+        pthread_mutex_lock( &wc->mutex );
+
+        wc->results[( wc->resultStart + wc->resultCount ) % wc->chunkQuantity] = job;
+        wc->resultCount++;
+
+    }
+
+    pthread_mutex_unlock( &wc->mutex );
+
+    return NULL;
+
+}
+
+// runs in the worker thread, using only the copies of the grid held by the
+// job; the lightmap is baked in the same thread, the worker is already off
+// the main thread
+static void meshWorldChunk( WorldChunks *wc, WorldChunkJob *job ) {
+    VoxelGrid *grid = &job->grid;
+    job->data = buildGreedyMeshData( grid, 1, 1, 1, grid->width - 1, grid->height - 1, grid->depth - 1, wc->blockSize, wc->palette );
+    bakeWorldChunk( wc, job, &job->occluders->grid, 1 );
+    destroyVoxelGrid( grid );
+}
+
+static void bakeWorldChunk( WorldChunks *wc, WorldChunkJob *job, VoxelGrid *occluders, int threadQuantity ) {
+
+    LightmapBakeInput input = {
+        .meshes = job->data.meshes,
+        .meshCount = job->data.meshCount,
+        .occluders = occluders,
+        .lights = wc->lights,
+        .lightQuantity = wc->lightQuantity,
+        .lightRadius = wc->lightRadius,
+        .threadQuantity = threadQuantity
+    };
+
+    job->lightmap = bakeLightmap( &input );
+
+}
+
+static void uploadWorldChunk( WorldChunks *wc, WorldChunkJob *job ) {
+
+    WorldChunk *chunk = &wc->chunks[job->chunk];
+
+    if ( chunk->modelLoaded ) {
+        UnloadModel( chunk->model );
+        UnloadTexture( chunk->lightmap );
+    }
+
+    chunk->quadCount = job->data.quadCount;
+    chunk->model = loadModelFromGreedyMeshData( &job->data );
+    chunk->lightmap = loadLightmapTexture( &job->lightmap );
+    chunk->model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = wc->texture;
+    chunk->model.materials[0].maps[MATERIAL_MAP_METALNESS].texture = chunk->lightmap;
+    chunk->model.materials[0].shader = wc->shader;
+    chunk->modelLoaded = true;
+    chunk->meshedVersion = job->version;
+
+}
+
+static void submitWorldChunk( WorldChunks *wc, int chunkIndex ) {
+
+    WorldChunk *chunk = &wc->chunks[chunkIndex];
+
+    // one voxel of border, so faces against the neighbour chunks are dropped
+    WorldChunkJob job = {
+        .chunk = chunkIndex,
+        .version = chunk->version,
+        .grid = copyVoxelGridRegion( &wc->grid, chunk->minX - 1, -1, chunk->minZ - 1, chunk->maxX + 1, wc->grid.height + 1, chunk->maxZ + 1 ),
+        .occluders = acquireOccluders( wc )
+    };
+
+    chunk->jobPending = true;
+
+    if ( wc->workerRunning ) {
+        pthread_mutex_lock( &wc->mutex );
+        wc->jobs[( wc->jobStart + wc->jobCount ) % wc->chunkQuantity] = job;
+        wc->jobCount++;
+        pthread_cond_signal( &wc->jobAvailable );
+        pthread_mutex_unlock( &wc->mutex );
+    } else {
+        meshWorldChunk( wc, &job );
+        releaseOccluders( wc, job.occluders );
+        chunk->jobPending = false;
+        uploadWorldChunk( wc, &job );
+    }
+
+}
+
+// the copy of the world is made once for all the chunks changed by the
+// same edits, instead of once for each job
+static WorldChunkOccluders *acquireOccluders( WorldChunks *wc ) {
+
+    if ( wc->occluders == NULL || wc->occluders->version != wc->editVersion ) {
+
+        if ( wc->occluders != NULL ) {
+            releaseOccluders( wc, wc->occluders );
+        }
+
+        wc->occluders = (WorldChunkOccluders*) malloc( sizeof( WorldChunkOccluders ) );
+        *wc->occluders = (WorldChunkOccluders){
+            .grid = copyVoxelGridRegion( &wc->grid, 0, 0, 0, wc->grid.width, wc->grid.height, wc->grid.depth ),
+            .version = wc->editVersion,
+            .references = 1
+        };
+
+    }
+
+    pthread_mutex_lock( &wc->mutex );
+    wc->occluders->references++;
+    pthread_mutex_unlock( &wc->mutex );
+
+    return wc->occluders;
+
+}
+
+// called by the main thread and by the worker; the newest copy keeps its
+// own reference, so only the main thread frees it
+static void releaseOccluders( WorldChunks *wc, WorldChunkOccluders *occluders ) {
+
+    pthread_mutex_lock( &wc->mutex );
+    bool last = --occluders->references == 0;
+    pthread_mutex_unlock( &wc->mutex );
+
+    if ( last ) {
+        destroyVoxelGrid( &occluders->grid );
+        free( occluders );
+    }
+
+}
+
+// marks as changed the chunks that have voxels touching the box
+static void invalidateWorldChunks( WorldChunks *wc, BoundingBox box ) {
+
+    wc->editVersion++;
+
+    float s = wc->grid.voxelSize;
+
+    int x0 = (int) floorf( ( box.min.x - wc->grid.origin.x ) / s ) - 1;
+    int z0 = (int) floorf( ( box.min.z - wc->grid.origin.z ) / s ) - 1;
+    int x1 = (int) ceilf( ( box.max.x - wc->grid.origin.x ) / s ) + 1;
+    int z1 = (int) ceilf( ( box.max.z - wc->grid.origin.z ) / s ) + 1;
+
+    for ( int i = 0; i < wc->chunkQuantity; i++ ) {
+        WorldChunk *chunk = &wc->chunks[i];
+        if ( x0 < chunk->maxX && x1 > chunk->minX && z0 < chunk->maxZ && z1 > chunk->minZ ) {
+            chunk->version++;
+        }
+    }
+
+}
+
+static int getChunkIndexWorldChunks( WorldChunks *wc, Vector3 pos ) {
+
+    float s = wc->grid.voxelSize * WORLD_CHUNK_SIZE;
+
+    int x = (int) floorf( ( pos.x - wc->grid.origin.x ) / s );
+    int z = (int) floorf( ( pos.z - wc->grid.origin.z ) / s );
+
+    x = x < 0 ? 0 : ( x >= wc->chunkCountX ? wc->chunkCountX - 1 : x );
+    z = z < 0 ? 0 : ( z >= wc->chunkCountZ ? wc->chunkCountZ - 1 : z );
+
+    return z * wc->chunkCountX + x;
+
+}
+
+static unsigned char getBlockMaterial( Block *block ) {
+    return block->maxHp > 0 ? WORLD_CHUNK_MATERIAL_BREAKABLE_OBSTACLE : WORLD_CHUNK_MATERIAL_OBSTACLE;
+}
@@ -0,0 +1,400 @@
+/**
+ * @file WorldMesher.c
+ * @author Prof. Dr. David Buzatto
+ * @brief VoxelGrid and greedy mesher implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "WorldMesher.h"
+#include "Block.h"
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+// raylib meshes use 16 bit indices
+#define MAX_QUADS_PER_MESH 16384
+
+typedef struct QuadBuffer {
+    float *vertices;
+    float *texcoords;
+    float *normals;
+    unsigned char *colors;
+    int quadCount;
+    int capacity;
+} QuadBuffer;
+
+static void pushQuad( QuadBuffer *qb, Vector3 *corners, Vector3 normal, Color color, float uvScale, int uAxis, int vAxis );
+static float getAxis( Vector3 v, int axis );
+
+VoxelGrid createVoxelGrid( BoundingBox bounds, float voxelSize ) {
+
+    // the ground top is at y = 0
+    Vector3 min = Vector3Min( bounds.min, (Vector3){ bounds.min.x, 0.0f, bounds.min.z } );
+
+    VoxelGrid grid = {
+        .voxelSize = voxelSize,
+        .origin = {
+            floorf( min.x / voxelSize ) * voxelSize,
+            floorf( min.y / voxelSize ) * voxelSize,
+            floorf( min.z / voxelSize ) * voxelSize
+        }
+    };
+
+    grid.width = (int) ceilf( ( bounds.max.x - grid.origin.x ) / voxelSize );
+    grid.height = (int) ceilf( ( bounds.max.y - grid.origin.y ) / voxelSize );
+    grid.depth = (int) ceilf( ( bounds.max.z - grid.origin.z ) / voxelSize );
+    grid.groundLevel = (int) roundf( -grid.origin.y / voxelSize );
+
+    if ( grid.width > 0 && grid.height > 0 && grid.depth > 0 ) {
+        grid.cells = (unsigned char*) calloc( grid.width * grid.height * grid.depth, sizeof( unsigned char ) );
+    } else {
+        grid.width = 0;
+        grid.height = 0;
+        grid.depth = 0;
+    }
+
+    return grid;
+
+}
+
+void destroyVoxelGrid( VoxelGrid *grid ) {
+    free( grid->cells );
+    grid->cells = NULL;
+}
+
+void setVoxelGridBlock( VoxelGrid *grid, Block *block, unsigned char material ) {
+
+    BoundingBox bb = getBlockBoundingBox( block );
+    float s = grid->voxelSize;
+
+    int x0 = (int) roundf( ( bb.min.x - grid->origin.x ) / s );
+    int y0 = (int) roundf( ( bb.min.y - grid->origin.y ) / s );
+    int z0 = (int) roundf( ( bb.min.z - grid->origin.z ) / s );
+    int x1 = (int) roundf( ( bb.max.x - grid->origin.x ) / s );
+    int y1 = (int) roundf( ( bb.max.y - grid->origin.y ) / s );
+    int z1 = (int) roundf( ( bb.max.z - grid->origin.z ) / s );
+
+    for ( int y = y0 < 0 ? 0 : y0; y < y1 && y < grid->height; y++ ) {
+        for ( int z = z0 < 0 ? 0 : z0; z < z1 && z < grid->depth; z++ ) {
+            for ( int x = x0 < 0 ? 0 : x0; x < x1 && x < grid->width; x++ ) {
+                grid->cells[( y * grid->depth + z ) * grid->width + x] = material;
+            }
+        }
+    }
+
+}
+
+VoxelGrid copyVoxelGridRegion( VoxelGrid *grid, int minX, int minY, int minZ, int maxX, int maxY, int maxZ ) {
+
+    float s = grid->voxelSize;
+
+    VoxelGrid copy = {
+        .width = maxX - minX,
+        .height = maxY - minY,
+        .depth = maxZ - minZ,
+        .groundLevel = grid->groundLevel - minY,
+        .voxelSize = s,
+        .origin = {
+            grid->origin.x + minX * s,
+            grid->origin.y + minY * s,
+            grid->origin.z + minZ * s
+        }
+    };
+
+    copy.cells = (unsigned char*) malloc( copy.width * copy.height * copy.depth );
+
+    for ( int y = 0; y < copy.height; y++ ) {
+        for ( int z = 0; z < copy.depth; z++ ) {
+            for ( int x = 0; x < copy.width; x++ ) {
+                copy.cells[( y * copy.depth + z ) * copy.width + x] = getVoxelGridMaterial( grid, minX + x, minY + y, minZ + z );
+            }
+        }
+    }
+
+    return copy;
+
+}
+
+bool isVoxelGridSolid( VoxelGrid *grid, int x, int y, int z ) {
+
+    if ( y < grid->groundLevel ) {
+        return true;
+    }
+
+    return getVoxelGridMaterial( grid, x, y, z ) != 0;
+
+}
+
+unsigned char getVoxelGridMaterial( VoxelGrid *grid, int x, int y, int z ) {
+
+    if ( x < 0 || y < 0 || z < 0 || x >= grid->width || y >= grid->height || z >= grid->depth ) {
+        return 0;
+    }
+
+    return grid->cells[( y * grid->depth + z ) * grid->width + x];
+
+}
+
+GreedyMeshData buildGreedyMeshData( VoxelGrid *grid, int minX, int minY, int minZ, int maxX, int maxY, int maxZ, float uvScale, const Color *palette ) {
+
+    QuadBuffer qb = { 0 };
+    int regionMin[3] = { minX, minY, minZ };
+    int regionMax[3] = { maxX, maxY, maxZ };
+    float s = grid->voxelSize;
+
+    for ( int axis = 0; axis < 3; axis++ ) {
+
+        int u = ( axis + 1 ) % 3;
+        int v = ( axis + 2 ) % 3;
+        int uSize = regionMax[u] - regionMin[u];
+        int vSize = regionMax[v] - regionMin[v];
+
+        if ( uSize <= 0 || vSize <= 0 ) {
+            continue;
+        }
+
+        // positive: material of a face looking to +axis, negative: looking to -axis
+        short *mask = (short*) malloc( uSize * vSize * sizeof( short ) );
+
+        // each plane lies between the voxels p - 1 and p
+        for ( int p = regionMin[axis]; p <= regionMax[axis]; p++ ) {
+
+            int x[3];
+            int n = 0;
+
+            for ( int j = 0; j < vSize; j++ ) {
+                for ( int i = 0; i < uSize; i++ ) {
+
+                    int a[3];
+                    int b[3];
+
+                    a[axis] = p - 1; a[u] = regionMin[u] + i; a[v] = regionMin[v] + j;
+                    b[axis] = p;     b[u] = regionMin[u] + i; b[v] = regionMin[v] + j;
+
+                    bool sa = isVoxelGridSolid( grid, a[0], a[1], a[2] );
+                    bool sb = isVoxelGridSolid( grid, b[0], b[1], b[2] );
+
+                    // only faces owned by voxels inside the region are generated
+                    if ( sa && !sb && p - 1 >= regionMin[axis] && a[1] >= grid->groundLevel ) {
+                        mask[n] = getVoxelGridMaterial( grid, a[0], a[1], a[2] );
+                    } else if ( !sa && sb && p < regionMax[axis] && b[1] >= grid->groundLevel ) {
+                        mask[n] = -getVoxelGridMaterial( grid, b[0], b[1], b[2] );
+                    } else {
+                        mask[n] = 0;
+                    }
+
+                    n++;
+
+                }
+            }
+
+            n = 0;
+
+            for ( int j = 0; j < vSize; j++ ) {
+                for ( int i = 0; i < uSize; ) {
+
+                    short c = mask[n];
+
+                    if ( c == 0 ) {
+                        i++;
+                        n++;
+                        continue;
+                    }
+
+                    int w = 1;
+                    while ( i + w < uSize && mask[n + w] == c ) {
+                        w++;
+                    }
+
+                    int h = 1;
+                    bool done = false;
+                    while ( j + h < vSize && !done ) {
+                        for ( int k = 0; k < w; k++ ) {
+                            if ( mask[n + k + h * uSize] != c ) {
+                                done = true;
+                                break;
+                            }
+                        }
+                        if ( !done ) {
+                            h++;
+                        }
+                    }
+
+                    x[axis] = p;
+                    x[u] = regionMin[u] + i;
+                    x[v] = regionMin[v] + j;
+
+                    Vector3 base = {
+                        grid->origin.x + x[0] * s,
+                        grid->origin.y + x[1] * s,
+                        grid->origin.z + x[2] * s
+                    };
+
+                    float du[3] = { 0 };
+                    float dv[3] = { 0 };
+                    du[u] = w * s;
+                    dv[v] = h * s;
+
+                    Vector3 corners[4] = {
+                        base,
+                        { base.x + du[0], base.y + du[1], base.z + du[2] },
+                        { base.x + du[0] + dv[0], base.y + du[1] + dv[1], base.z + du[2] + dv[2] },
+                        { base.x + dv[0], base.y + dv[1], base.z + dv[2] }
+                    };
+
+                    float nv[3] = { 0 };
+                    nv[axis] = c > 0 ? 1.0f : -1.0f;
+
+                    if ( c < 0 ) {
+                        Vector3 t = corners[1];
+                        corners[1] = corners[3];
+                        corners[3] = t;
+                    }
+
+                    pushQuad( &qb, corners, (Vector3){ nv[0], nv[1], nv[2] }, palette[c > 0 ? c : -c], uvScale, u, v );
+
+                    for ( int l = 0; l < h; l++ ) {
+                        memset( &mask[n + l * uSize], 0, w * sizeof( short ) );
+                    }
+
+                    i += w;
+                    n += w;
+
+                }
+            }
+
+        }
+
+        free( mask );
+
+    }
+
+    GreedyMeshData data = {
+        .quadCount = qb.quadCount
+    };
+
+    if ( qb.quadCount > 0 ) {
+
+        data.meshCount = ( qb.quadCount + MAX_QUADS_PER_MESH - 1 ) / MAX_QUADS_PER_MESH;
+        data.meshes = (Mesh*) MemAlloc( data.meshCount * sizeof( Mesh ) );
+
+        for ( int m = 0; m < data.meshCount; m++ ) {
+
+            int firstQuad = m * MAX_QUADS_PER_MESH;
+            int quads = qb.quadCount - firstQuad < MAX_QUADS_PER_MESH ? qb.quadCount - firstQuad : MAX_QUADS_PER_MESH;
+            Mesh *mesh = &data.meshes[m];
+
+            mesh->vertexCount = quads * 4;
+            mesh->triangleCount = quads * 2;
+            mesh->vertices = (float*) MemAlloc( mesh->vertexCount * 3 * sizeof( float ) );
+            mesh->texcoords = (float*) MemAlloc( mesh->vertexCount * 2 * sizeof( float ) );
+            mesh->normals = (float*) MemAlloc( mesh->vertexCount * 3 * sizeof( float ) );
+            mesh->colors = (unsigned char*) MemAlloc( mesh->vertexCount * 4 * sizeof( unsigned char ) );
+            mesh->indices = (unsigned short*) MemAlloc( mesh->triangleCount * 3 * sizeof( unsigned short ) );
+
+            memcpy( mesh->vertices, &qb.vertices[firstQuad * 12], quads * 12 * sizeof( float ) );
+            memcpy( mesh->texcoords, &qb.texcoords[firstQuad * 8], quads * 8 * sizeof( float ) );
+            memcpy( mesh->normals, &qb.normals[firstQuad * 12], quads * 12 * sizeof( float ) );
+            memcpy( mesh->colors, &qb.colors[firstQuad * 16], quads * 16 * sizeof( unsigned char ) );
+
+            for ( int q = 0; q < quads; q++ ) {
+                unsigned short *id = &mesh->indices[q * 6];
+                unsigned short first = (unsigned short) ( q * 4 );
+                id[0] = first;
+                id[1] = first + 1;
+                id[2] = first + 2;
+                id[3] = first;
+                id[4] = first + 2;
+                id[5] = first + 3;
+            }
+
+        }
+
+    }
+
+    free( qb.vertices );
+    free( qb.texcoords );
+    free( qb.normals );
+    free( qb.colors );
+
+    return data;
+
+}
+
+void unloadGreedyMeshData( GreedyMeshData *data ) {
+
+    for ( int i = 0; i < data->meshCount; i++ ) {
+        UnloadMesh( data->meshes[i] );
+    }
+
+    MemFree( data->meshes );
+    *data = (GreedyMeshData){ 0 };
+
+}
+
+Model loadModelFromGreedyMeshData( GreedyMeshData *data ) {
+
+    Model model = { 0 };
+
+    model.transform = MatrixIdentity();
+    model.meshCount = data->meshCount;
+    model.meshes = data->meshes;
+    model.materialCount = 1;
+    model.materials = (Material*) MemAlloc( sizeof( Material ) );
+    model.materials[0] = LoadMaterialDefault();
+    model.meshMaterial = (int*) MemAlloc( ( data->meshCount > 0 ? data->meshCount : 1 ) * sizeof( int ) );
+
+    for ( int i = 0; i < model.meshCount; i++ ) {
+        UploadMesh( &model.meshes[i], false );
+    }
+
+    *data = (GreedyMeshData){ 0 };
+
+    return model;
+
+}
+
+static void pushQuad( QuadBuffer *qb, Vector3 *corners, Vector3 normal, Color color, float uvScale, int uAxis, int vAxis ) {
+
+    if ( qb->quadCount == qb->capacity ) {
+        qb->capacity = qb->capacity == 0 ? 256 : qb->capacity * 2;
+        qb->vertices = (float*) realloc( qb->vertices, qb->capacity * 12 * sizeof( float ) );
+        qb->texcoords = (float*) realloc( qb->texcoords, qb->capacity * 8 * sizeof( float ) );
+        qb->normals = (float*) realloc( qb->normals, qb->capacity * 12 * sizeof( float ) );
+        qb->colors = (unsigned char*) realloc( qb->colors, qb->capacity * 16 * sizeof( unsigned char ) );
+    }
+
+    float *vertices = &qb->vertices[qb->quadCount * 12];
+    float *texcoords = &qb->texcoords[qb->quadCount * 8];
+    float *normals = &qb->normals[qb->quadCount * 12];
+    unsigned char *colors = &qb->colors[qb->quadCount * 16];
+
+    for ( int i = 0; i < 4; i++ ) {
+        vertices[i * 3] = corners[i].x;
+        vertices[i * 3 + 1] = corners[i].y;
+        vertices[i * 3 + 2] = corners[i].z;
+        texcoords[i * 2] = getAxis( corners[i], uAxis ) / uvScale;
+        texcoords[i * 2 + 1] = getAxis( corners[i], vAxis ) / uvScale;
+        normals[i * 3] = normal.x;
+        normals[i * 3 + 1] = normal.y;
+        normals[i * 3 + 2] = normal.z;
+        colors[i * 4] = color.r;
+        colors[i * 4 + 1] = color.g;
+        colors[i * 4 + 2] = color.b;
+        colors[i * 4 + 3] = color.a;
+    }
+
+    qb->quadCount++;
+
+}
+
+static float getAxis( Vector3 v, int axis ) {
+    switch ( axis ) {
+        case 0: return v.x;
+        case 1: return v.y;
+        default: return v.z;
+    }
+}
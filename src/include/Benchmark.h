@@ -0,0 +1,72 @@
+/**
+ * @file Benchmark.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Benchmark struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "GameWorld.h"
+#include "GpuTimer.h"
+#include "raylib/raylib.h"
+
+#define BENCHMARK_DEFAULT_FRAMES 1000
+#define BENCHMARK_DEFAULT_MAP "resources/maps/stressMap.txt"
+#define BENCHMARK_REPORT_FILE_NAME "benchmark.csv"
+
+// control points of the camera path, a closed loop over the ground
+#define BENCHMARK_PATH_POINTS 8
+
+// frames drawn before the measures, to settle the caches and the driver
+#define BENCHMARK_WARMUP_FRAMES 30
+
+typedef struct BenchmarkFrame {
+    float frameTime;
+    float workTime;         // CPU time until the frame is presented
+    float presentTime;      // waiting in EndDrawing (swap and driver), not the GPU time
+    int drawCalls;
+    int triangleCount;
+    bool gpuMeasured;       // the queries of the last frames may not be read back
+    float gpuTime;
+    float passTimes[GPU_TIMER_PASS_QUANTITY];
+} BenchmarkFrame;
+
+/**
+ * @brief Renders a fixed number of frames with the camera flying along a
+ * spline that depends only on the size of the map, without updating the
+ * game, so two runs over the same map draw the same frames. The window
+ * must not limit the frame rate. The GPU pass timers are turned on, so
+ * the report tells where the GPU time of each frame goes.
+ */
+typedef struct Benchmark {
+
+    Vector3 path[BENCHMARK_PATH_POINTS];
+
+    BenchmarkFrame *frames;
+    int frameQuantity;
+    int frame;              // negative during the warm up
+
+} Benchmark;
+
+/**
+ * @brief Builds the camera path over the loaded map and fixes the quality
+ * of the game world.
+ */
+void initBenchmark( Benchmark *b, GameWorld *gw, int frameQuantity );
+void destroyBenchmark( Benchmark *b );
+
+/**
+ * @brief Moves the camera to the position of the current frame. Goes
+ * before drawGameWorld, recordBenchmark goes after it.
+ */
+void updateBenchmark( Benchmark *b, GameWorld *gw );
+void recordBenchmark( Benchmark *b, GameWorld *gw );
+bool isFinishedBenchmark( Benchmark *b );
+
+/**
+ * @brief Writes the frames as CSV, after a summary in comment lines.
+ */
+bool writeReportBenchmark( Benchmark *b, const char *filePath );
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "RenderQueue.h"
+#include "StreamBuffer.h"
 #include "raylib/raylib.h"
 
 typedef struct Block {
@@ -15,9 +17,26 @@ typedef struct Block {
 
     Model model;
     bool renderModel;
+
+    // baked static lighting, zero when the block has no lightmap
+    Texture2D lightmap;
     bool renderTouchColor;
 
+    // zero for indestructible blocks
+    int maxHp;
+    int currentHp;
+
 } Block;
 
+#define i_TYPE Obstacles, Block
+#include "stc/vec.h"
+
 void drawBlock( Block *block );
+
+/**
+ * @brief Queues the meshes of the model of the block that are visible (one
+ * flag per mesh, as the tiles of the ground, or NULL for all of them).
+ * The wires, when the shader doesn't draw the outlines, go to the stream.
+ */
+void drawBlockMeshes( Block *block, RenderQueue *rq, StreamBuffer *sb, const bool *visible );
 BoundingBox getBlockBoundingBox( Block *block );
@@ -2,6 +2,7 @@
 
 #include <stdbool.h>
 
+#include "SphereBatch.h"
 #include "raylib/raylib.h"
 
 typedef struct Bullet {
@@ -16,4 +17,4 @@ typedef struct Bullet {
 } Bullet;
 
 Bullet createBullet( Vector3 pos, Color color, float radius );
-void drawBullet( Bullet *bullet );
+void drawBullet( Bullet *bullet, SphereBatch *sb );
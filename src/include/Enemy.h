@@ -7,7 +7,9 @@ struct GameWorld;
 
 #include "Player.h"
 #include "Bullet.h"
-#include "ExplosionBillboard.h"
+#include "HpBarBatch.h"
+#include "SphereBatch.h"
+#include "RenderQueue.h"
 #include "raylib/raylib.h"
 
 typedef enum EnemyCollisionType {
@@ -33,6 +35,17 @@ typedef enum EnemyState {
     ENEMY_STATE_DEAD
 } EnemyState;
 
+// level of detail by the projected height of the enemy, in pixels
+typedef enum EnemyLod {
+    ENEMY_LOD_FULL,             // attached bullets and outlines
+    ENEMY_LOD_MEDIUM,           // model and eyes only
+    ENEMY_LOD_IMPOSTOR,         // billboard (see EnemyImpostors.h)
+    ENEMY_LOD_QUANTITY
+} EnemyLod;
+
+#define ENEMY_LOD_FULL_PIXELS 48.0f
+#define ENEMY_LOD_MEDIUM_PIXELS 16.0f
+
 typedef struct Enemy {
 
     int id;
@@ -87,14 +100,22 @@ typedef struct Enemy {
     int collidedBulletCount;
 
     Sound deathSound;
-    ExplosionBillboard eb;
+    float dyingTimeCounter;
+
+    // detail of the last frame it was drawn
+    EnemyLod lod;
 
 } Enemy;
 
 Enemy createEnemy( Vector3 pos, Color color, Color eyeColor );
-void drawEnemy( Enemy *enemy );
-void drawEnemyExplosionBillboard( Enemy *enemy, Camera3D camera );
-void drawEnemyHpBar( Enemy *enemy, Camera3D camera );
+void drawEnemy( Enemy *enemy, SphereBatch *sb, RenderQueue *rq, EnemyLod lod );
+
+/**
+ * @brief The detail of an enemy seen by the camera, that is rendered with
+ * the given viewport height.
+ */
+EnemyLod getEnemyLod( Enemy *enemy, Camera3D camera, int viewportHeight );
+void addEnemyHpBar( Enemy *enemy, HpBarBatch *hb );
 void updateEnemy( Enemy *enemy, struct Player *player, struct GameWorld *gw, float delta );
 void updateEnemyCollisionProbes( Enemy *enemy );
 void jumpEnemy( Enemy *enemy );
@@ -0,0 +1,58 @@
+/**
+ * @file EnemyImpostors.h
+ * @author Prof. Dr. David Buzatto
+ * @brief EnemyImpostors struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+struct Enemy;
+
+// views around the enemy and their resolution, in pixels
+#define ENEMY_IMPOSTOR_VIEWS 8
+#define ENEMY_IMPOSTOR_FRAME_SIZE 64
+
+typedef struct EnemyImpostor {
+    Vector3 pos;
+    float angle;
+} EnemyImpostor;
+
+/**
+ * @brief Billboards drawn in place of the enemies that are far away. The
+ * enemy is rendered once from several horizontal directions, side by side
+ * in a render texture, and each impostor shows the view closest to the
+ * direction of the camera, turned to it around the vertical axis. All of
+ * them are drawn in one batch with a shader that cuts out the empty
+ * texels, so they don't need to be sorted.
+ */
+typedef struct EnemyImpostors {
+
+    bool initialized;
+
+    RenderTexture2D atlas;
+    float size;         // side of the billboards, in world units
+    Shader shader;
+
+    EnemyImpostor *impostors;
+    int count;
+    int capacity;
+
+} EnemyImpostors;
+
+void initEnemyImpostors( EnemyImpostors *ei, Shader shader );
+void destroyEnemyImpostors( EnemyImpostors *ei );
+
+/**
+ * @brief Renders the views of an enemy, that all the impostors will show.
+ * Must be called again when the model or the colors of the enemies change.
+ */
+void bakeEnemyImpostors( EnemyImpostors *ei, struct Enemy *enemy );
+
+void beginEnemyImpostors( EnemyImpostors *ei );
+void addEnemyImpostor( EnemyImpostors *ei, struct Enemy *enemy );
+void drawEnemyImpostors( EnemyImpostors *ei, Camera3D camera );
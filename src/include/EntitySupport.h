@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdbool.h>
+
 #include "raylib.h"
 
 typedef enum EntityType {
@@ -21,3 +23,6 @@ typedef struct MultipleIdentifiedRayCollision {
 } MultipleIdentifiedRayCollision;
 
 extern int entityIdCounter;
+
+// when true the light shader draws the edges of the models, so their wires are skipped
+extern bool shaderOutlines;
@@ -0,0 +1,100 @@
+/**
+ * @file FrameCapture.h
+ * @author Prof. Dr. David Buzatto
+ * @brief FrameCapture struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "raylib/raylib.h"
+
+// frames between the copy of a frame and its read back
+#define FRAME_CAPTURE_SLOTS 3
+
+// frames read back and waiting for the encoder, more are dropped
+#define FRAME_CAPTURE_QUEUE_CAPACITY 8
+
+// name of the files written, in the working directory
+#define FRAME_CAPTURE_FILE_NAME "capture"
+
+typedef enum FrameCaptureFormat {
+    FRAME_CAPTURE_FORMAT_RAW,       // every frame appended to one rgba file
+    FRAME_CAPTURE_FORMAT_PNG,       // one png file per frame
+    FRAME_CAPTURE_FORMAT_ENCODER    // rgba frames piped to ffmpeg
+} FrameCaptureFormat;
+
+/**
+ * @brief Records the frames without waiting for the GPU. At the end of
+ * each frame glReadPixels copies the window, on the GPU, to one of a ring
+ * of pixel pack buffers and a fence is placed after the copy. The copy
+ * made FRAME_CAPTURE_SLOTS frames before, whose fence has long signalled,
+ * is mapped and handed to a worker thread that writes the frames to the
+ * disk or to the encoder.
+ *
+ * The counters are written by the main thread, except encodedFrames, that
+ * belongs to the worker and must be read with getEncodedFramesFrameCapture.
+ * writeFailed is also set by the worker and read under the mutex; the main
+ * thread then stops the recording.
+ */
+typedef struct FrameCapture {
+
+    bool recording;
+    FrameCaptureFormat format;
+
+    int width;
+    int height;
+
+    unsigned int pixelBuffers[FRAME_CAPTURE_SLOTS];
+    void *fences[FRAME_CAPTURE_SLOTS];  // NULL when the slot has no frame
+    int slot;
+
+    FILE *output;
+
+    pthread_t worker;
+    pthread_mutex_t mutex;
+    pthread_cond_t frameAvailable;
+    bool workerRunning;
+    bool writeFailed;
+
+    Image queue[FRAME_CAPTURE_QUEUE_CAPACITY];
+    int queueStart;
+    int queueCount;
+
+    int capturedFrames;
+    int encodedFrames;
+    int droppedFrames;
+
+} FrameCapture;
+
+/**
+ * @brief Starts recording the window with its current size. Returns false
+ * if the output or the worker thread couldn't be created, or without the
+ * GL 3.3 fences and buffer mapping (GL 2.1 and the web build). The encoder
+ * also needs a positive target FPS for the frame rate of the video.
+ */
+bool startFrameCapture( FrameCapture *fc, FrameCaptureFormat format, int targetFPS );
+
+/**
+ * @brief Stops recording, waiting for the frames still in the ring and in
+ * the queue to be written.
+ */
+void stopFrameCapture( FrameCapture *fc );
+
+/**
+ * @brief Captures the frame drawn so far. Must be called right before
+ * EndDrawing. If the window is resized or a frame couldn't be written the
+ * recording stops.
+ */
+void captureFrameCapture( FrameCapture *fc );
+
+/**
+ * @brief Frames written by the worker so far, only while recording.
+ */
+int getEncodedFramesFrameCapture( FrameCapture *fc );
+
+const char *getFrameCaptureFormatName( FrameCaptureFormat format );
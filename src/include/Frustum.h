@@ -0,0 +1,80 @@
+/**
+ * @file Frustum.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Frustum and FrustumCuller structs and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+typedef enum FrustumPlane {
+    FRUSTUM_PLANE_LEFT,
+    FRUSTUM_PLANE_RIGHT,
+    FRUSTUM_PLANE_BOTTOM,
+    FRUSTUM_PLANE_TOP,
+    FRUSTUM_PLANE_NEAR,
+    FRUSTUM_PLANE_FAR,
+    FRUSTUM_PLANE_QUANTITY
+} FrustumPlane;
+
+/**
+ * @brief Normalized planes (x, y, z is the normal pointing inside and w
+ * the distance) of the volume seen by a camera.
+ */
+typedef struct Frustum {
+    Vector4 planes[FRUSTUM_PLANE_QUANTITY];
+} Frustum;
+
+/**
+ * @brief Batch of axis aligned boxes tested together against a frustum.
+ * The boxes are stored as centers and half extents in separate arrays, so
+ * four of them can be tested at once with SSE.
+ */
+typedef struct FrustumCuller {
+
+    float *centerX;
+    float *centerY;
+    float *centerZ;
+    float *extentX;
+    float *extentY;
+    float *extentZ;
+
+    bool *visible;
+
+    int count;
+    int capacity;
+
+} FrustumCuller;
+
+/**
+ * @brief Extracts the frustum planes from the view-projection matrix that
+ * BeginMode3D would use for the camera.
+ */
+Frustum createFrustumFromCamera( Camera3D camera, float aspect );
+Frustum createFrustumFromMatrix( Matrix viewProjection );
+
+/**
+ * @brief The matrix used by BeginMode3D for the camera, with the cull
+ * distances of rlgl.
+ */
+Matrix getViewProjectionFromCamera( Camera3D camera, float aspect );
+bool isBoxInsideFrustum( Frustum *frustum, BoundingBox box );
+
+void resetFrustumCuller( FrustumCuller *fc );
+void destroyFrustumCuller( FrustumCuller *fc );
+
+/**
+ * @brief Adds a box to the batch, returning its index.
+ */
+int addBoxFrustumCuller( FrustumCuller *fc, BoundingBox box );
+
+/**
+ * @brief Tests all the boxes of the batch, filling the visible array.
+ * Returns how many boxes were culled.
+ */
+int cullFrustumCuller( FrustumCuller *fc, Frustum *frustum );
+int countVisibleFrustumCuller( FrustumCuller *fc, int start, int count );
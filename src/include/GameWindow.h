@@ -27,6 +27,9 @@ typedef struct GameWindow {
     bool loadResources;
     bool initAudio;
 
+    // when greater than zero the window runs the benchmark instead of the game
+    int benchmarkFrames;
+
     GameWorld *gw;
 
     bool initialized;
@@ -12,8 +12,24 @@
 #include "PowerUp.h"
 
 #include "Block.h"
-#define i_TYPE Obstacles, Block
-#include "stc/vec.h"
+#include "EnemyImpostors.h"
+#include "WorldChunks.h"
+#include "Frustum.h"
+#include "FrameCapture.h"
+#include "GpuTimer.h"
+#include "OcclusionCuller.h"
+#include "PickBuffer.h"
+#include "Pvs.h"
+#include "SphereBatch.h"
+#include "HpBarBatch.h"
+#include "HudPanel.h"
+#include "ImpactDecals.h"
+#include "LightClusters.h"
+#include "ParticleSystem.h"
+#include "RenderQueue.h"
+#include "QualityGovernor.h"
+#include "SceneTarget.h"
+#include "StreamBuffer.h"
 
 #include "Bullet.h"
 #include "raylib/raylib.h"
@@ -29,15 +45,37 @@ typedef enum CameraType {
     CAMERA_TYPE_FIRST_PERSON
 } CameraType;
 
+// local players, each one with a view in a region of the window
+#define GAME_WORLD_MAX_PLAYERS 4
+
+// groups of boxes tested against the camera frustum each frame
+typedef enum RenderableType {
+    RENDERABLE_TYPE_GROUND,
+    RENDERABLE_TYPE_WALL,
+    RENDERABLE_TYPE_PLAYER,
+    RENDERABLE_TYPE_WORLD_CHUNK,
+    RENDERABLE_TYPE_ENEMY,
+    RENDERABLE_TYPE_POWER_UP,
+    RENDERABLE_TYPE_LIGHT,
+    RENDERABLE_TYPE_QUANTITY
+} RenderableType;
+
 typedef struct GameWorld {
 
-    Camera3D camera;
+    // one camera for each player, the first player may use the keyboard
+    // and the others use the next gamepads
+    Camera3D cameras[GAME_WORLD_MAX_PLAYERS];
     CameraType cameraType;
     
-    Player player;
+    Player players[GAME_WORLD_MAX_PLAYERS];
+    int playerQuantity;
+    Vector3 playerStartPos;
+    float playerStartAngle;
 
     Enemy *enemies;
     int enemyQuantity;
+    EnemyImpostors impostors;
+    int enemyLodQuantity[ENEMY_LOD_QUANTITY];
 
     PowerUp *powerUps;
     int powerUpQuantity;
@@ -46,32 +84,73 @@ typedef struct GameWorld {
 
     // STC vector
     Obstacles obstacles;
+    Color obstacleColor;
+    Color breakableObstacleColor;
+    WorldChunks chunks;
+    Pvs pvs;
 
     Shader lightShader;
-    int ambientLoc;
+    LightingTier lightingTier;
+    LightingTier preferredLightingTier;
 
     Light *lights;
     int lightQuantity;
     int activeLights;
     float lightSpeed;
+    float lightRadius;
+    LightClusters lightClusters;
+
+    // the ground and the walls use a variant with a procedural checkerboard
+    Shader lightmapShader;
+    Shader checkerShader;
 
     Block leftWall;
     Block rightWall;
     Block farWall;
     Block nearWall;
 
-    Bullet collidedBullets[50];
-    int maxCollidedBullets;
-    int collidedBulletCount;
+    ImpactDecals impacts;
+    ParticleSystem particles;
+    HpBarBatch hpBars;
+
+    // cached 2D interface
+    HudPanel playerHuds[GAME_WORLD_MAX_PLAYERS];
+    HudPanel helpPanel;
+    HudPanel debugPanel;
     Color bulletColor;
     
     Music *currentBgMusic;
 
     GameWorldPlayerInputType playerInputType;
 
+    Frustum frustum;
+    FrustumCuller culler;
+    int renderableStart[RENDERABLE_TYPE_QUANTITY];
+    int renderableCount[RENDERABLE_TYPE_QUANTITY];
+    int culledQuantity;
+    int pvsCulledQuantity;
+
+    // enemies and power-ups hidden by the world in the last frames
+    OcclusionCuller occlusion;
+    int occlusionCulledQuantity;
+
+    SphereBatch spheres;
+    RenderQueue renderQueue;
+    StreamBuffer stream;
+    PickBuffer picking;
+    FrameCapture capture;
+    GpuTimer gpuTimer;
+
+    // the scene resolution and the features follow the frame time
+    SceneTarget scene;
+    QualityGovernor governor;
+    double frameStartTime;
+    float workTime;
+
 } GameWorld;
 
 extern const float GRAVITY;
+extern const char *customMapFilePath;
 
 /**
  * @brief Creates a dinamically allocated GameWorld struct instance.
@@ -93,7 +172,49 @@ void inputAndUpdateGameWorld( GameWorld *gw );
  * @brief Draws the state of the game.
  */
 void drawGameWorld( GameWorld *gw );
-void drawReticle( GameWorld *gw, CameraType cameraType, PlayerWeaponState weaponState, int reticleSize );
+
+/**
+ * @brief Draws the scene and the interface of a player in its region of
+ * the window. Only the culling and the drawing are repeated for each view.
+ */
+void drawViewGameWorld( GameWorld *gw, int view );
+void drawReticle( GameWorld *gw, int view, int reticleSize );
+void drawEnemies( GameWorld *gw, Camera3D camera );
+void drawPickGameWorld( GameWorld *gw );
+
+/**
+ * @brief Gathers the bounding boxes of everything that may be drawn, once
+ * per frame for all the views.
+ */
+void addRenderablesGameWorld( GameWorld *gw );
+
+/**
+ * @brief Tests the boxes gathered by addRenderablesGameWorld against the
+ * frustum of a camera, in a single batch, and then against the potentially
+ * visible set of its cell.
+ */
+void cullGameWorld( GameWorld *gw, Camera3D camera, float aspect );
+bool isRenderableVisible( GameWorld *gw, RenderableType type, int index );
+
+/**
+ * @brief The region of the window of a view: the whole window for one
+ * player, two halves one over the other for two and quarters for more.
+ */
+Rectangle getViewportGameWorld( GameWorld *gw, int view );
+
+/**
+ * @brief Changes the quantity of local players, the new ones start next to
+ * the start position of the map.
+ */
+void setPlayerQuantity( GameWorld *gw, int quantity );
+Camera3D *getPlayerCamera( GameWorld *gw, Player *player );
+
+/**
+ * @brief The gamepad of a player, or -1 if it uses the keyboard and the mouse.
+ */
+int getPlayerGamepadId( GameWorld *gw, int playerIndex );
+Player *getNearestAlivePlayer( GameWorld *gw, Vector3 pos );
+bool isAnyPlayerAlive( GameWorld *gw );
 
 void setupCamera( GameWorld *gw );
 void updateCameraTarget( GameWorld *gw, Player *player );
@@ -101,10 +222,23 @@ void updateCameraPosition( GameWorld *gw, Player *player, float xOffset, float y
 void showCameraInfo( Camera3D *camera, int x, int y );
 
 Block createGround( float thickness, int lines, int columns );
-void createObstacles( GameWorld *gw, Vector3 *positions, int obstacleQuantity, float blockSize, Color obstacleColor );
+void createObstacles( GameWorld *gw, Vector3 *positions, bool *breakable, int obstacleQuantity, float blockSize, Color obstacleColor, Color breakableObstacleColor );
 
 void createLights( GameWorld *gw, Vector3 *positions, int lightQuantity, Color lightColor );
 
+/**
+ * @brief Loads (or computes) the potentially visible sets of the map. Must
+ * be called after the obstacles are created.
+ */
+void createPvs( GameWorld *gw, const char *mapFilePath, unsigned int mapHash );
+void setConstantUniforms( Shader shader, float outlineWidth );
+void setEntityModelsShader( Shader shader );
+void setLightingTier( GameWorld *gw, LightingTier tier );
+void applyQualityLevel( GameWorld *gw );
+void bakeStaticLightmaps( GameWorld *gw );
+void setLightmapScale( GameWorld *gw, float scale );
+void unloadStaticLightmaps( GameWorld *gw );
+
 void createGroundModel( Block *ground );
 void createLRWallModel( Block *wall );
 void createFNWallModel( Block *wall );
@@ -112,9 +246,9 @@ void createObstaclesModel( Obstacles *obst );
 
 void createWalls( GameWorld *gw, Color wallColor, int groundLines, int groundColumns, int wallHeight );
 
-void processOptionsInput( Player *player, GameWorld *gw );
+void processOptionsInput( GameWorld *gw );
 void processPlayerInputByKeyboard( GameWorld *gw, Player *player, CameraType cameraType, float delta );
-void processPlayerInputByGamepad( GameWorld *gw, Player *player, CameraType cameraType, float delta );
+void processPlayerInputByGamepad( GameWorld *gw, Player *player, CameraType cameraType, int gamepadId, float delta );
 
 void resolveCollisionPlayerObstacles( Player *player, GameWorld *gw );
 void resolveCollisionEnemyObstacles( Enemy *enemy, GameWorld *gw );
@@ -125,18 +259,27 @@ void resolveCollisionPlayerWalls( Player *player, Block *leftWall, Block *rightW
 void resolveCollisionEnemyWalls( Enemy *enemy, Block *leftWall, Block *rightWall, Block *farWall, Block *nearWall );
 void resolveCollisionPlayerEnemy( Player *player, Enemy *enemy );
 void resolveCollisionPlayerPowerUp( Player *player, PowerUp *powerUp );
-IdentifiedRayCollision resolveHitsWorld( GameWorld *gw );
-MultipleIdentifiedRayCollision resolveMultipleHitsWorld( GameWorld *gw );
+
+/**
+ * @brief Applies damage to a breakable obstacle, removing it when its hp
+ * reaches zero. Returns true if the obstacle doesn't exist anymore.
+ */
+bool damageObstacle( GameWorld *gw, int obstacleId, int damage );
+IdentifiedRayCollision resolveHitsWorld( GameWorld *gw, Player *player );
+MultipleIdentifiedRayCollision resolveMultipleHitsWorld( GameWorld *gw, Player *player );
+void resolveHitsObstacles( GameWorld *gw, Ray ray );
 
 void resetGameWorld( GameWorld *gw );
 void drawDebugInfo( GameWorld *gw );
-void drawGameoverOverlay( void );
+void drawDebugInfoText( GameWorld *gw );
+void drawGpuTimerInfo( GameWorld *gw, int x, int y );
+void drawGameoverOverlay( Rectangle viewport );
 
 void processMapFile( const char *filePath, GameWorld *gw, float blockSize, Color wallColor, Color obstacleColor, Color enemyColor, Color enemyEyeColor, Color lightColor );
 void processImageMapFile( const char *filePath, GameWorld *gw, float blockSize, Color wallColor, Color obstacleColor, Color enemyColor, Color enemyEyeColor, Color lightColor );
 int compareRaycollision( const void *pr1, const void *pr2 );
 
-void updateShaders( GameWorld *gw );
+void updateShaders( GameWorld *gw, Camera3D camera );
 
 void drawLights( GameWorld *gw );
 void updateLights( GameWorld *gw, float delta );
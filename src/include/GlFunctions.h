@@ -0,0 +1,90 @@
+/**
+ * @file GlFunctions.h
+ * @author Prof. Dr. David Buzatto
+ * @brief OpenGL functions that rlgl doesn't wrap.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#ifndef __EMSCRIPTEN__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#define GL_API_PTR __stdcall
+#else
+#define GL_API_PTR
+#endif
+
+/*
+ * The pointers are filled by raylib's loader (glad) when the window is
+ * created, for the functions the driver has; a NULL pointer means the
+ * feature isn't there. Not available in the web build.
+ */
+
+// queries, GL 3.3
+typedef void ( GL_API_PTR *GenQueriesProc )( int n, unsigned int *ids );
+typedef void ( GL_API_PTR *DeleteQueriesProc )( int n, const unsigned int *ids );
+typedef void ( GL_API_PTR *BeginQueryProc )( unsigned int target, unsigned int id );
+typedef void ( GL_API_PTR *EndQueryProc )( unsigned int target );
+typedef void ( GL_API_PTR *QueryCounterProc )( unsigned int id, unsigned int target );
+typedef void ( GL_API_PTR *GetQueryObjectivProc )( unsigned int id, unsigned int pname, int *params );
+typedef void ( GL_API_PTR *GetQueryObjectuivProc )( unsigned int id, unsigned int pname, unsigned int *params );
+typedef void ( GL_API_PTR *GetQueryObjectui64vProc )( unsigned int id, unsigned int pname, uint64_t *params );
+
+extern GenQueriesProc glad_glGenQueries;
+extern DeleteQueriesProc glad_glDeleteQueries;
+extern BeginQueryProc glad_glBeginQuery;
+extern EndQueryProc glad_glEndQuery;
+extern QueryCounterProc glad_glQueryCounter;
+extern GetQueryObjectivProc glad_glGetQueryObjectiv;
+extern GetQueryObjectuivProc glad_glGetQueryObjectuiv;
+extern GetQueryObjectui64vProc glad_glGetQueryObjectui64v;
+
+// fences, GL 3.2; the sync objects are opaque pointers
+typedef void *( GL_API_PTR *FenceSyncProc )( unsigned int condition, unsigned int flags );
+typedef unsigned int ( GL_API_PTR *ClientWaitSyncProc )( void *sync, unsigned int flags, uint64_t timeout );
+typedef void ( GL_API_PTR *DeleteSyncProc )( void *sync );
+
+extern FenceSyncProc glad_glFenceSync;
+extern ClientWaitSyncProc glad_glClientWaitSync;
+extern DeleteSyncProc glad_glDeleteSync;
+
+// buffers, GL 3.0 (glBufferStorage is GL 4.4 or ARB_buffer_storage)
+typedef void ( GL_API_PTR *GenBuffersProc )( int n, unsigned int *buffers );
+typedef void ( GL_API_PTR *DeleteBuffersProc )( int n, const unsigned int *buffers );
+typedef void ( GL_API_PTR *BindBufferProc )( unsigned int target, unsigned int buffer );
+typedef void ( GL_API_PTR *BufferDataProc )( unsigned int target, ptrdiff_t size, const void *data, unsigned int usage );
+typedef void ( GL_API_PTR *BufferStorageProc )( unsigned int target, ptrdiff_t size, const void *data, unsigned int flags );
+typedef void *( GL_API_PTR *MapBufferRangeProc )( unsigned int target, ptrdiff_t offset, ptrdiff_t length, unsigned int access );
+typedef unsigned char ( GL_API_PTR *UnmapBufferProc )( unsigned int target );
+
+extern GenBuffersProc glad_glGenBuffers;
+extern DeleteBuffersProc glad_glDeleteBuffers;
+extern BindBufferProc glad_glBindBuffer;
+extern BufferDataProc glad_glBufferData;
+extern BufferStorageProc glad_glBufferStorage;
+extern MapBufferRangeProc glad_glMapBufferRange;
+extern UnmapBufferProc glad_glUnmapBuffer;
+
+// reading the framebuffer
+typedef void ( GL_API_PTR *ReadPixelsProc )( int x, int y, int width, int height, unsigned int format, unsigned int type, void *pixels );
+
+extern ReadPixelsProc glad_glReadPixels;
+
+// program binaries, GL 4.1 or ARB_get_program_binary
+typedef unsigned int ( GL_API_PTR *CreateProgramProc )( void );
+typedef void ( GL_API_PTR *GetProgramBinaryProc )( unsigned int program, int bufSize, int *length, unsigned int *binaryFormat, void *binary );
+typedef void ( GL_API_PTR *ProgramBinaryProc )( unsigned int program, unsigned int binaryFormat, const void *binary, int length );
+typedef void ( GL_API_PTR *GetProgramivProc )( unsigned int program, unsigned int pname, int *params );
+typedef const unsigned char *( GL_API_PTR *GetStringProc )( unsigned int name );
+
+extern CreateProgramProc glad_glCreateProgram;
+extern GetProgramBinaryProc glad_glGetProgramBinary;
+extern ProgramBinaryProc glad_glProgramBinary;
+extern GetProgramivProc glad_glGetProgramiv;
+extern GetStringProc glad_glGetString;
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file GpuTimer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief GpuTimer struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+// frames between the queries of a frame and their read back
+#define GPU_TIMER_FRAMES 3
+
+// timestamps per frame, the marks after the last one are ignored; each
+// split-screen view takes about ten
+#define GPU_TIMER_MAX_MARKS 48
+
+typedef enum GpuTimerPass {
+    GPU_TIMER_PASS_PICKING,         // the picking target, when enabled
+    GPU_TIMER_PASS_WORLD,           // the scene target and the render queue (blocks, player and enemies)
+    GPU_TIMER_PASS_LIGHTS,          // the upload of the light clusters
+    GPU_TIMER_PASS_ENTITIES,        // decals, spheres (power-ups, bullets and lights)
+    GPU_TIMER_PASS_BILLBOARDS,      // enemy impostors and particles
+    GPU_TIMER_PASS_HUD,             // hp bars, player hud and reticle
+    GPU_TIMER_PASS_OVERLAYS,        // debug info, help, game over and capture
+    GPU_TIMER_PASS_QUANTITY
+} GpuTimerPass;
+
+typedef struct GpuTimerFrame {
+    unsigned int queries[GPU_TIMER_MAX_MARKS];
+    GpuTimerPass passes[GPU_TIMER_MAX_MARKS];
+    int markCount;
+    int number;
+} GpuTimerFrame;
+
+/**
+ * @brief Measures how long the GPU takes in each pass of the frame with
+ * timestamp queries. A mark flushes the rlgl batch and records a timestamp,
+ * the time until the next mark goes to the pass of the mark, so a pass may
+ * be measured in more than one piece. The queries of a frame are read
+ * GPU_TIMER_FRAMES frames later, when they have long finished; if they
+ * haven't the frame is dropped instead of waiting.
+ */
+typedef struct GpuTimer {
+
+    bool initialized;
+    bool available;             // GL 3.3 timer queries, not in the web build
+    bool enabled;
+
+    GpuTimerFrame frames[GPU_TIMER_FRAMES];
+    int current;
+    int frameNumber;
+
+    // the last frame read back
+    float passTimes[GPU_TIMER_PASS_QUANTITY];
+    float frameTime;
+    int resultFrame;            // -1 when there is no result yet
+    int droppedFrames;
+
+} GpuTimer;
+
+void initGpuTimer( GpuTimer *gt );
+void destroyGpuTimer( GpuTimer *gt );
+
+/**
+ * @brief Turns the measures on or off, discarding the frames in flight.
+ * It stays off if the timer queries aren't available.
+ */
+void setEnabledGpuTimer( GpuTimer *gt, bool enabled );
+
+/**
+ * @brief Reads back the oldest frame and starts measuring a new one. Goes
+ * right after BeginDrawing, endGpuTimer right before EndDrawing.
+ */
+void beginGpuTimer( GpuTimer *gt );
+void markGpuTimer( GpuTimer *gt, GpuTimerPass pass );
+void endGpuTimer( GpuTimer *gt );
+
+/**
+ * @brief The number of frames between the frame being drawn and the one of
+ * the results, or -1 if there is no result.
+ */
+int getResultAgeGpuTimer( GpuTimer *gt );
+
+const char *getGpuTimerPassName( GpuTimerPass pass );
@@ -0,0 +1,53 @@
+/**
+ * @file HpBarBatch.h
+ * @author Prof. Dr. David Buzatto
+ * @brief HpBarBatch struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "StreamBuffer.h"
+#include "raylib/raylib.h"
+
+/**
+ * @brief Collects the HP bars of a frame, projects all their anchors at
+ * once with the view-projection matrix of the camera (four at a time, with
+ * SSE when available), drops the ones behind the camera or out of the
+ * screen and draws the rest as one batch of 2D quads.
+ */
+typedef struct HpBarBatch {
+
+    // world position of each bar and the fraction of the bar that is filled
+    float *anchorX;
+    float *anchorY;
+    float *anchorZ;
+    float *fill;
+
+    // projected center, in pixels, and the depth that sizes the bar
+    float *screenX;
+    float *screenY;
+    float *depth;
+
+    int count;
+    int capacity;
+
+    int drawnQuantity;
+
+} HpBarBatch;
+
+void destroyHpBarBatch( HpBarBatch *hb );
+
+/**
+ * @brief Clears the batch for a new frame.
+ */
+void beginHpBarBatch( HpBarBatch *hb );
+void addHpBarBatch( HpBarBatch *hb, Vector3 anchor, float fill );
+
+/**
+ * @brief Projects every bar in the region of the window of the view and
+ * draws them with the stream buffer. Must be called outside BeginMode3D.
+ */
+void drawHpBarBatch( HpBarBatch *hb, StreamBuffer *sb, Camera3D camera, Rectangle viewport );
@@ -0,0 +1,41 @@
+/**
+ * @file HudPanel.h
+ * @author Prof. Dr. David Buzatto
+ * @brief HudPanel struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+// values of the key kept by a panel
+#define HUD_PANEL_KEY_CAPACITY 8
+
+/**
+ * @brief A piece of the 2D interface cached in a render texture. The
+ * content is identified by a key, the values shown in it (the ammo, the
+ * HP, the toggles...), and is only drawn again when the key or the size
+ * change; every other frame the panel is a single textured quad.
+ */
+typedef struct HudPanel {
+    RenderTexture2D target;
+    int key[HUD_PANEL_KEY_CAPACITY];
+    int keyLength;
+    bool valid;
+    int redrawCount;
+} HudPanel;
+
+/**
+ * @brief Returns true if the content must be drawn again, compared to the
+ * key of the last drawing (at most HUD_PANEL_KEY_CAPACITY values). In this
+ * case the render texture is cleared and becomes the target of the drawing,
+ * with the origin at the top left corner of the panel, until endHudPanel.
+ */
+bool beginHudPanel( HudPanel *panel, int width, int height, const int *key, int keyLength );
+void endHudPanel( HudPanel *panel );
+
+void drawHudPanel( HudPanel *panel, int x, int y );
+void unloadHudPanel( HudPanel *panel );
@@ -0,0 +1,87 @@
+/**
+ * @file ImpactDecals.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ImpactDecals struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#define IMPACT_DECALS_CAPACITY 4096
+
+// seconds a decal stays on the world and how long it takes to fade out
+#define IMPACT_DECALS_LIFETIME 60.0f
+#define IMPACT_DECALS_FADE_TIME 10.0f
+
+/**
+ * @brief Per instance data, read by the vertex shader.
+ */
+typedef struct ImpactDecal {
+    Vector3 pos;
+    float size;         // zero for removed decals
+    Vector3 normal;
+    float time;         // when the impact happened
+    Color color;
+} ImpactDecal;
+
+/**
+ * @brief Marks left by the bullets on the world. The decals live in a ring
+ * buffer that is mirrored in a vertex buffer, so only the new ones are
+ * uploaded, and all of them are drawn as quads aligned to the surfaces
+ * with a single instanced call. The shader fades them out by age.
+ */
+typedef struct ImpactDecals {
+
+    bool initialized;
+
+    ImpactDecal *data;
+    int count;          // total of decals added, the ring keeps the last ones
+    float time;
+
+    // range of the ring changed since the last upload
+    int dirtyStart;
+    int dirtyEnd;
+
+    Mesh quad;
+    unsigned int vboId;
+
+    Shader shader;
+    bool instancing;
+    int timeLoc;
+    int fadeLoc;
+    int instancePositionLoc;
+    int instanceNormalLoc;
+    int instanceColorLoc;
+
+} ImpactDecals;
+
+/**
+ * @brief Creates the ring and its vertex buffer. If the shader isn't valid
+ * the decals are drawn one by one as small spheres.
+ */
+void initImpactDecals( ImpactDecals *id, Shader shader );
+void destroyImpactDecals( ImpactDecals *id );
+void clearImpactDecals( ImpactDecals *id );
+
+/**
+ * @brief Adds a decal, replacing the oldest one when the ring is full.
+ */
+void addImpactDecal( ImpactDecals *id, Vector3 pos, Vector3 normal, float size, Color color );
+
+/**
+ * @brief Removes the decals inside the box, as when an obstacle breaks.
+ */
+void removeImpactDecalsInBox( ImpactDecals *id, BoundingBox box );
+
+void updateImpactDecals( ImpactDecals *id, float delta );
+int getQuantityImpactDecals( ImpactDecals *id );
+
+/**
+ * @brief Draws every decal. Must be called inside BeginMode3D, after the
+ * opaque geometry.
+ */
+void drawImpactDecals( ImpactDecals *id );
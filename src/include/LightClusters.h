@@ -0,0 +1,104 @@
+/**
+ * @file LightClusters.h
+ * @author Prof. Dr. David Buzatto
+ * @brief LightClusters struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+#include "raylib/rlights.h"
+
+#define LIGHT_CLUSTERS_MAX_LIGHTS 128
+#define LIGHT_CLUSTERS_MAX_LIGHTS_PER_CLUSTER 32
+
+// clusters along the screen width, height and depth
+#define LIGHT_CLUSTERS_X 16
+#define LIGHT_CLUSTERS_Y 9
+#define LIGHT_CLUSTERS_Z 24
+#define LIGHT_CLUSTERS_QUANTITY ( LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z )
+
+// the depth slices are exponential between these distances, the first
+// and the last slices extend to the camera and to the far plane
+#define LIGHT_CLUSTERS_NEAR 1.0f
+#define LIGHT_CLUSTERS_FAR 250.0f
+
+// width of the light index texture
+#define LIGHT_CLUSTERS_INDEX_WIDTH 1024
+
+/**
+ * @brief Clustered forward lighting. Every frame the point lights are
+ * binned in a grid of view space clusters (screen tiles sliced by depth)
+ * and the light shader evaluates only the lights of the cluster of each
+ * fragment. The data goes to the shader in three float textures: the
+ * lights, the offset and count of each cluster and the light index list.
+ */
+typedef struct LightClusters {
+
+    bool initialized;
+
+    Shader shader;
+    int lightDataLoc;
+    int clusterDataLoc;
+    int lightIndicesLoc;
+    int clusterGridLoc;
+    int clusterDepthLoc;
+    int clusterViewportLoc;
+    int viewForwardLoc;
+    int lightCountLoc;
+
+    // two texels per light: position and radius, color and enabled
+    float *lightData;
+    float *clusterData;
+    float *lightIndices;
+
+    // lights of each cluster, before being packed in lightIndices
+    int *binnedLights;
+    int *binnedCounts;
+
+    unsigned int lightDataTextureId;
+    unsigned int clusterDataTextureId;
+    unsigned int lightIndicesTextureId;
+
+    // view space bounds of each cluster, recomputed when the projection changes
+    BoundingBox *clusterBounds;
+    float boundsFovy;
+    float boundsAspect;
+
+    Vector3 viewForward;
+    Rectangle viewport;
+
+    int lightQuantity;
+    int indexQuantity;
+    int maxLightsInCluster;
+    int droppedIndexes;
+
+} LightClusters;
+
+/**
+ * @brief Creates the textures and binds the samplers of the light shader.
+ */
+void initLightClusters( LightClusters *lc, Shader shader );
+void destroyLightClusters( LightClusters *lc );
+
+/**
+ * @brief Switches the light shader fed by the clusters, as when the
+ * lighting tier changes.
+ */
+void setShaderLightClusters( LightClusters *lc, Shader shader );
+
+/**
+ * @brief Bins the enabled lights in the clusters seen by the camera and
+ * uploads the result. The viewport is the region of the framebuffer where
+ * the camera is rendered.
+ */
+void updateLightClusters( LightClusters *lc, Camera3D camera, Rectangle viewport, Light *lights, int lightQuantity, float lightRadius );
+
+/**
+ * @brief Binds the textures and sets the uniforms of the light shader.
+ * Must be called before drawing with it.
+ */
+void bindLightClusters( LightClusters *lc );
@@ -0,0 +1,57 @@
+/**
+ * @file LightingShaders.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Lighting shader variants declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+// where the linked programs are saved, named by the hash of the sources,
+// the defines and the driver
+#define LIGHTING_SHADER_CACHE_DIRECTORY "resources/shaders/cache"
+
+/**
+ * @brief Quality tiers of the light shader. Each one is a variant of
+ * lighting.vs/lighting.fs compiled with its own defines, so the disabled
+ * features cost nothing in the shader.
+ */
+typedef enum LightingTier {
+    LIGHTING_TIER_HIGH,         // per fragment, specular and gamma correction
+    LIGHTING_TIER_MEDIUM,       // per fragment, diffuse only
+    LIGHTING_TIER_LOW,          // per vertex (Gouraud), diffuse only
+    LIGHTING_TIER_QUANTITY
+} LightingTier;
+
+// features of a variant, turned into defines of the shader source
+#define LIGHTING_VARIANT_SPECULAR 0x1
+#define LIGHTING_VARIANT_GAMMA 0x2
+#define LIGHTING_VARIANT_PER_VERTEX 0x4
+
+/**
+ * @brief Loads a shader inserting the defines right after the #version
+ * line of both sources. Any of the file names may be NULL, as in LoadShader.
+ */
+Shader loadShaderVariant( const char *vsFileName, const char *fsFileName, const char *defines );
+
+/**
+ * @brief Same as loadShaderVariant, but the linked program is kept in the
+ * cache directory with glGetProgramBinary and loaded with glProgramBinary
+ * the next time. A binary the driver rejects, or written by another
+ * driver, is compiled again. cached tells where the shader came from; the
+ * cache isn't used without GL 4.1 program binaries or in the web build.
+ */
+Shader loadCachedShaderVariant( const char *vsFileName, const char *fsFileName, const char *defines, bool *cached );
+
+/**
+ * @brief Loads the light shader of a tier, with the light limits of the
+ * light clusters as constants, through the program binary cache.
+ */
+Shader loadLightingShader( LightingTier tier, bool *cached );
+
+int getLightingTierVariant( LightingTier tier );
+const char *getLightingTierName( LightingTier tier );
@@ -0,0 +1,53 @@
+/**
+ * @file Lightmap.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Lightmap baker function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "WorldMesher.h"
+#include "raylib/raylib.h"
+#include "raylib/rlights.h"
+
+// lightmap resolution, in texels per world unit
+#define LIGHTMAP_TEXELS_PER_UNIT 2.0f
+#define LIGHTMAP_BAKE_THREADS 4
+
+// the lightmaps store half of the light, so two lights can overlap without saturating
+#define LIGHTMAP_RANGE 2.0f
+
+/**
+ * @brief Static lighting of a set of meshes made of quads (four consecutive
+ * vertices each, as the cube and the greedy meshes). Every quad gets its own
+ * region (chart) of the lightmap and the diffuse light of each texel is
+ * computed on the CPU, with the shadows of the solid voxels of occluders.
+ */
+typedef struct LightmapBakeInput {
+    Mesh *meshes;
+    int meshCount;
+    Vector3 offset;             // position where the meshes are drawn
+    VoxelGrid *occluders;       // may be NULL
+    const Light *lights;
+    int lightQuantity;
+    float lightRadius;
+    int threadQuantity;
+} LightmapBakeInput;
+
+/**
+ * @brief Generates the lightmap coordinates (texcoords2) of the meshes and
+ * returns the lightmap. Doesn't use the GPU, so it can run outside the main
+ * thread. The layout depends only on the quads, so a mesh shared by several
+ * blocks gets the same coordinates for each of them.
+ */
+Image bakeLightmap( LightmapBakeInput *input );
+
+/**
+ * @brief Uploads the texcoords2 of a mesh that is already in the GPU.
+ */
+void uploadLightmapCoordinates( Mesh *mesh );
+
+Texture2D loadLightmapTexture( Image *lightmap );
@@ -0,0 +1,103 @@
+/**
+ * @file OcclusionCuller.h
+ * @author Prof. Dr. David Buzatto
+ * @brief OcclusionCuller struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+// frames between the queries of a frame and the last time they may be read
+#define OCCLUSION_CULLER_FRAMES 3
+
+// views with their own queries, one for each split-screen player
+#define OCCLUSION_CULLER_VIEWS 4
+
+// the entities closer than this to the camera are always drawn
+#define OCCLUSION_CULLER_NEAR_DISTANCE 8.0f
+
+// the proxies grow to cover what the entities move until the results are used
+#define OCCLUSION_CULLER_MARGIN 0.5f
+
+typedef struct OcclusionCullerFrame {
+    unsigned int *queries;      // one for each entity
+    bool *tested;               // the entities with a proxy in the frame
+    int count;                  // entities when the frame was drawn
+    int testedCount;
+    int number;                 // -1 when nothing was drawn
+} OcclusionCullerFrame;
+
+typedef struct OcclusionCullerView {
+    OcclusionCullerFrame frames[OCCLUSION_CULLER_FRAMES];
+    bool *occluded;             // the results used in the current frame
+    int resultAge;              // frames since the results were drawn, -1 when there are none
+} OcclusionCullerView;
+
+/**
+ * @brief Conservative occlusion culling of the dynamic entities. Each view
+ * draws the bounding boxes of the entities that survived the frustum and
+ * the PVS, without color and depth writes, over the depth of the world,
+ * each one inside an occlusion query. The results are read one or two
+ * frames later, without waiting for the GPU, and an entity whose box had
+ * no visible sample is skipped; a query without result, an entity near the
+ * camera or a change in the quantity of entities means the entity is drawn.
+ */
+typedef struct OcclusionCuller {
+
+    bool initialized;
+    bool available;             // GL 3.3 occlusion queries, not in the web build
+    bool enabled;
+
+    OcclusionCullerView views[OCCLUSION_CULLER_VIEWS];
+    int capacity;
+    int frameNumber;
+
+    // the view being culled and its proxies waiting to be drawn
+    int view;
+    int count;
+    BoundingBox *boxes;
+    int *indexes;
+    int pendingCount;
+
+    // statistics of the last view
+    int occludedQuantity;
+    int queryQuantity;
+
+} OcclusionCuller;
+
+void initOcclusionCuller( OcclusionCuller *oc );
+void destroyOcclusionCuller( OcclusionCuller *oc );
+
+/**
+ * @brief Turns the culling on or off, discarding the queries in flight.
+ * It stays off if the occlusion queries aren't available.
+ */
+void setEnabledOcclusionCuller( OcclusionCuller *oc, bool enabled );
+
+/**
+ * @brief Starts a new frame, once before all the views.
+ */
+void advanceOcclusionCuller( OcclusionCuller *oc );
+
+/**
+ * @brief Reads the newest results of a view for entities indexed from 0
+ * to count - 1.
+ */
+void beginOcclusionCuller( OcclusionCuller *oc, int view, int count );
+
+/**
+ * @brief Returns false if the entity was occluded in the results of the
+ * view, and queues its box to be tested again in this frame.
+ */
+bool testOcclusionCuller( OcclusionCuller *oc, int index, BoundingBox box, Vector3 viewPosition );
+
+/**
+ * @brief Draws the queued boxes inside their queries. Goes inside the 3D
+ * mode of the view, after the occluders and before the entities, so only
+ * the world writes the depth tested by the boxes.
+ */
+void drawProxiesOcclusionCuller( OcclusionCuller *oc );
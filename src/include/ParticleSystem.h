@@ -0,0 +1,96 @@
+/**
+ * @file ParticleSystem.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ParticleSystem struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#define PARTICLE_SYSTEM_CAPACITY 2048
+
+// the explosion of the enemies: the blood frames, one after the other
+#define PARTICLE_EXPLOSION_FRAME_TIME 0.1f
+#define PARTICLE_EXPLOSION_DURATION ( PARTICLE_EXPLOSION_FRAME_TIME * 3 )
+
+/**
+ * @brief Sprites packed in the particle atlas.
+ */
+typedef enum ParticleFrame {
+    PARTICLE_FRAME_BLOOD0,
+    PARTICLE_FRAME_BLOOD1,
+    PARTICLE_FRAME_BLOOD2,
+    PARTICLE_FRAME_QUANTITY
+} ParticleFrame;
+
+/**
+ * @brief A camera facing quad. Billboards are particles that don't move,
+ * animated through a sequence of frames of the atlas.
+ */
+typedef struct Particle {
+    Vector3 pos;
+    Vector3 vel;
+    float gravity;
+    float size;             // height, the width follows the frame aspect
+    Color color;
+    int firstFrame;
+    int frameCount;
+    float frameTime;        // seconds of each frame
+    float lifetime;
+    float fadeTime;         // seconds fading out at the end of the lifetime
+    float age;
+    float depth;            // distance to the camera, for sorting
+} Particle;
+
+/**
+ * @brief Every active particle lives in one contiguous array, simulated in
+ * place, and all of them are drawn as a single quad batch with the atlas
+ * texture.
+ */
+typedef struct ParticleSystem {
+
+    bool initialized;
+
+    Particle *particles;
+    int count;
+
+    Texture2D atlas;
+    Rectangle frames[PARTICLE_FRAME_QUANTITY];
+
+    // fraction of the secondary particles that are emitted (quality setting)
+    float density;
+    int droppedParticles;
+
+} ParticleSystem;
+
+/**
+ * @brief Packs the sprites side by side in one texture. The frames receive
+ * the region of each sprite in the atlas.
+ */
+Texture2D loadParticleAtlas( const char **fileNames, int fileQuantity, Rectangle *frames );
+
+void initParticleSystem( ParticleSystem *ps, Texture2D atlas, const Rectangle *frames );
+void destroyParticleSystem( ParticleSystem *ps );
+void clearParticleSystem( ParticleSystem *ps );
+
+/**
+ * @brief Adds a particle. Returns false if the pool is full.
+ */
+bool emitParticle( ParticleSystem *ps, Particle particle );
+
+/**
+ * @brief The animated blood billboard of a dying enemy and a spray of drops.
+ */
+void emitExplosionParticles( ParticleSystem *ps, Vector3 pos );
+
+void updateParticleSystem( ParticleSystem *ps, float delta );
+
+/**
+ * @brief Draws every particle facing the camera, from back to front. Must
+ * be called inside BeginMode3D, after the opaque geometry.
+ */
+void drawParticleSystem( ParticleSystem *ps, Camera3D camera );
@@ -0,0 +1,83 @@
+/**
+ * @file PickBuffer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief PickBuffer struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "EntitySupport.h"
+#include "Frustum.h"
+#include "raylib/raylib.h"
+
+// readbacks in flight, the oldest one is usually done when it's read
+#define PICK_BUFFER_FRAMES 3
+
+// field of view of the picking camera, only a thin cone around the ray
+#define PICK_BUFFER_FOVY 0.05f
+
+/**
+ * @brief Finds what is under a ray with the GPU. The pickable meshes are
+ * drawn along the ray in a one pixel float target, with the entity in the
+ * red channel and the distance in the green one, so both come from the
+ * same fragment. The pixel is copied to a pixel pack buffer of a ring,
+ * with a fence after the copy, and a buffer is only mapped once its fence
+ * has signalled, so reading the hit never waits for the GPU; the result
+ * has one or two frames of delay.
+ *
+ * The obstacles are merged in the meshes of the chunks, so only their type
+ * is known, their id is zero.
+ */
+typedef struct PickBuffer {
+
+    bool initialized;
+    bool available;
+    bool enabled;
+
+    Shader shader;
+    int entityLoc;
+    int clipPlanesLoc;
+
+    RenderTexture2D target;
+    unsigned int pixelBuffers[PICK_BUFFER_FRAMES];
+    void *fences[PICK_BUFFER_FRAMES];   // NULL when the buffer has nothing to read
+    Ray rays[PICK_BUFFER_FRAMES];
+    int current;
+
+    Frustum frustum;
+    Camera3D camera;
+
+    IdentifiedRayCollision hit;
+    int drawCalls;
+
+} PickBuffer;
+
+/**
+ * @brief Creates the target and the pixel buffers. Picking isn't available
+ * if the shader isn't valid or the GL context can't read back without
+ * blocking (GL 2.1 and the web build).
+ */
+void initPickBuffer( PickBuffer *pb, Shader shader );
+void destroyPickBuffer( PickBuffer *pb );
+void setEnabledPickBuffer( PickBuffer *pb, bool enabled );
+
+/**
+ * @brief Reads the newest hit the GPU has finished and starts drawing the
+ * pickable meshes along the ray.
+ */
+void beginPickBuffer( PickBuffer *pb, Ray ray );
+
+/**
+ * @brief Draws a mesh in the target if its bounds are touched by the ray.
+ */
+void addMeshPickBuffer( PickBuffer *pb, Mesh *mesh, Material *material, Matrix transform, BoundingBox bounds, EntityType type, int id );
+void endPickBuffer( PickBuffer *pb );
+
+/**
+ * @brief The closest hit along the newest ray read back, zeroed when
+ * nothing was hit.
+ */
+IdentifiedRayCollision getHitPickBuffer( PickBuffer *pb );
@@ -10,6 +10,7 @@ struct GameWorld;
 #include "Enemy.h"
 #include "PowerUp.h"
 #include "GameWorld.h"
+#include "HudPanel.h"
 #include "ResourceManager.h"
 #include "raylib/raylib.h"
 
@@ -126,8 +127,8 @@ typedef struct Player {
 } Player;
 
 Player createPlayer( Vector3 pos );
-void drawPlayer( Player *player );
-void drawPlayerHud( Player *player );
+void drawPlayer( Player *player, RenderQueue *rq );
+void drawPlayerHud( Player *player, HudPanel *panel, Rectangle viewport );
 void updatePlayer( Player *player, float delta );
 void updatePlayerCollisionProbes( Player *player );
 void jumpPlayer( Player *player );
@@ -3,6 +3,7 @@
 struct GameWorld;
 
 #include "GameWorld.h"
+#include "SphereBatch.h"
 #include "raylib/raylib.h"
 
 typedef enum PowerUpType {
@@ -56,7 +57,7 @@ typedef struct PowerUp {
 } PowerUp;
 
 PowerUp createPowerUp( Vector3 pos, PowerUpType powerUpType );
-void drawPowerUp( PowerUp *powerUp );
+void drawPowerUp( PowerUp *powerUp, SphereBatch *sb );
 void updatePowerUp( PowerUp *powerUp, float delta );
 void jumpPowerUp( PowerUp *powerUp );
 PowerUpCollisionType checkCollisionPowerUpBlock( PowerUp *powerUp, Block *block );
@@ -0,0 +1,105 @@
+/**
+ * @file Pvs.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Potentially visible set (Pvs) struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "WorldMesher.h"
+#include "raylib/raylib.h"
+
+// cell side, in voxels, along the x and z axis
+#define PVS_CELL_SIZE 4
+
+/**
+ * @brief Cell to cell visibility of a grid map. The map is divided in
+ * columns of PVS_CELL_SIZE x PVS_CELL_SIZE voxels and two cells are hidden
+ * from each other only when a wall of obstacles stacked from the ground
+ * crosses every sight line between any points of them, considering that
+ * the player can jump and that entities can stand on top of the obstacles.
+ * The set is conservative: it may keep hidden cells, never drops visible
+ * ones. The result is saved next to the map, so it is computed only when
+ * the map changes.
+ */
+typedef struct Pvs {
+
+    bool initialized;
+
+    int cellsX;
+    int cellsZ;
+    int cellQuantity;
+
+    float voxelSize;
+    Vector3 origin;
+    int groundLevel;
+
+    // bit matrix, cellQuantity x cellQuantity
+    unsigned char *visible;
+    int rowBytes;
+
+    // obstacle heights (in voxels) of each voxel column
+    int columnsX;
+    int columnsZ;
+    unsigned char *occluderHeights;
+    unsigned char *topHeights;
+
+    // highest point (in voxels) of each cell
+    float *eyeHeights;
+    float *targetHeights;
+
+    // time sliced recomputation, after the obstacles change, resumed from
+    // the pair ( rebuildCell, rebuildOther )
+    unsigned char *rebuilding;
+    int rebuildCell;
+    int rebuildOther;
+
+} Pvs;
+
+/**
+ * @brief Loads the visibility from cacheFilePath if it was computed for a
+ * map with the same hash, computing and saving it otherwise.
+ */
+void initPvs( Pvs *pvs, VoxelGrid *grid, const char *cacheFilePath, unsigned int mapHash );
+void destroyPvs( Pvs *pvs );
+
+/**
+ * @brief Starts the recomputation of the visibility from the current state
+ * of the grid. Until it finishes every cell is considered visible.
+ */
+void invalidatePvs( Pvs *pvs, VoxelGrid *grid );
+
+/**
+ * @brief Advances the recomputation, for at most budget seconds.
+ */
+void updatePvs( Pvs *pvs, double budget );
+bool isReadyPvs( Pvs *pvs );
+
+/**
+ * @brief Returns the cell that contains the position or -1 if it is outside
+ * the map.
+ */
+int getCellPvs( Pvs *pvs, Vector3 pos );
+
+/**
+ * @brief Returns the cell from where the camera is looking or -1 if the
+ * camera is above any point the player could reach (in this case everything
+ * is potentially visible).
+ */
+int getViewerCellPvs( Pvs *pvs, Vector3 cameraPos );
+
+bool isCellVisiblePvs( Pvs *pvs, int fromCell, int toCell );
+
+/**
+ * @brief Tests the cell of the position and its neighbours, where an entity
+ * at the position may reach.
+ */
+bool isPositionVisiblePvs( Pvs *pvs, int fromCell, Vector3 pos );
+
+/**
+ * @brief Tests the cells of the voxel region [min, max).
+ */
+bool isRegionVisiblePvs( Pvs *pvs, int fromCell, int minX, int minZ, int maxX, int maxZ );
@@ -0,0 +1,73 @@
+/**
+ * @file QualityGovernor.h
+ * @author Prof. Dr. David Buzatto
+ * @brief QualityGovernor struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief Render features switched off by the governor, one per level, in
+ * the order they are given up. Each level keeps the reductions of the
+ * previous ones.
+ */
+typedef enum QualityLevel {
+    QUALITY_LEVEL_FULL,
+    QUALITY_LEVEL_FEWER_PARTICLES,
+    QUALITY_LEVEL_NO_DECALS,
+    QUALITY_LEVEL_NO_OUTLINES,
+    QUALITY_LEVEL_MEDIUM_LIGHTING,
+    QUALITY_LEVEL_LOW_LIGHTING,
+    QUALITY_LEVEL_SHORT_DYNAMIC_LIGHTS,     // only the entities, the lightmaps keep the full radius
+    QUALITY_LEVEL_QUANTITY
+} QualityLevel;
+
+/**
+ * @brief Keeps the frame time inside a budget. When the frames are too
+ * slow the resolution of the scene is reduced first and, once it reaches
+ * its minimum, the features are given up one level at a time; with spare
+ * time they come back in the opposite order. The changes wait for a
+ * cooldown, longer to raise the quality than to lower it, so the governor
+ * doesn't oscillate around the budget.
+ *
+ * The frame time includes the wait for the target FPS and for the GPU, so
+ * it only tells if the frame is over the budget. The work time is what the
+ * game spends before presenting the frame and the GPU time, when the timer
+ * queries measure it, is what the GPU spends on it; both tell how much is
+ * left.
+ */
+typedef struct QualityGovernor {
+
+    bool enabled;
+    float budget;
+
+    float frameTime;
+    float workTime;
+    float gpuTime;      // negative when not measured
+    float cooldown;
+
+    float resolutionScale;
+    QualityLevel level;
+
+    // the level changed in the last update
+    bool changed;
+
+} QualityGovernor;
+
+void initQualityGovernor( QualityGovernor *qg, float budget );
+
+/**
+ * @brief Feeds the times of the last frame, in seconds. The GPU time is
+ * negative when it isn't measured.
+ */
+void updateQualityGovernor( QualityGovernor *qg, float frameTime, float workTime, float gpuTime );
+
+/**
+ * @brief Goes back to the full quality and, if disabled, stays there.
+ */
+void setEnabledQualityGovernor( QualityGovernor *qg, bool enabled );
+
+const char *getQualityLevelName( QualityLevel level );
@@ -0,0 +1,90 @@
+/**
+ * @file RenderQueue.h
+ * @author Prof. Dr. David Buzatto
+ * @brief RenderQueue struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+/**
+ * @brief A mesh to be drawn by the queue. The models of the blocks are
+ * shared, so the tint and the lightmap of each one go with the item.
+ */
+typedef struct RenderItem {
+    unsigned long long key;
+    Mesh *mesh;
+    Material *material;
+    Matrix transform;
+    Color tint;
+    Texture2D lightmap;     // bound to the metalness map when not zero
+    bool outline;           // false turns off the shader outline
+} RenderItem;
+
+/**
+ * @brief The opaque meshes of a frame, collected instead of being drawn
+ * in code order. The sort key groups the items by shader, outline and
+ * diffuse texture, so these change as few times as possible, and inside
+ * each group the items go from the nearest to the farthest, so the early
+ * depth test rejects the hidden fragments before the light shader runs.
+ *
+ * With the depth prepass every item is drawn first only in the depth
+ * buffer, with a shader that does nothing, and the shading pass (depth
+ * function less or equal) only runs the light shader for the visible
+ * fragments. The lines, spheres and billboards have their own batches
+ * and aren't queued.
+ */
+typedef struct RenderQueue {
+
+    bool initialized;
+
+    RenderItem *items;
+    int count;
+    int capacity;
+
+    Vector3 viewPosition;
+    Vector3 viewForward;
+
+    Shader depthShader;
+    bool depthPrepass;
+    float outlineWidth;
+
+    // of the last drawn frame
+    int shaderChanges;
+    int textureChanges;
+    int drawCalls;          // with the depth prepass
+    int triangleCount;
+
+} RenderQueue;
+
+void initRenderQueue( RenderQueue *rq, Shader depthShader );
+void destroyRenderQueue( RenderQueue *rq );
+
+/**
+ * @brief Empties the queue for a new frame, seen by the camera.
+ */
+void beginRenderQueue( RenderQueue *rq, Camera3D camera );
+
+/**
+ * @brief Queues a mesh. The center is used to sort by depth.
+ */
+void addRenderQueue( RenderQueue *rq, Mesh *mesh, Material *material, Matrix transform, Vector3 center, Color tint, Texture2D lightmap, bool outline );
+
+/**
+ * @brief Queues all the meshes of a model, as DrawModelEx would draw them.
+ */
+void addModelRenderQueue( RenderQueue *rq, Model *model, Matrix transform, Vector3 center, Color tint, Texture2D lightmap, bool outline );
+
+/**
+ * @brief Sorts and draws the queued items. Must be called in the 3D mode.
+ */
+void drawRenderQueue( RenderQueue *rq );
+
+/**
+ * @brief Transform of DrawModelEx: scale, rotation in degrees and translation.
+ */
+Matrix getRenderTransform( Vector3 position, Vector3 rotationAxis, float rotationAngle, Vector3 scale );
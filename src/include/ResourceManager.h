@@ -9,6 +9,8 @@
 
 #include <stdlib.h>
 
+#include "LightingShaders.h"
+#include "ParticleSystem.h"
 #include "raylib/raylib.h"
 
 typedef struct ResourceManager {
@@ -29,11 +31,17 @@ typedef struct ResourceManager {
     bool lrWallModelCreated;
     bool fnWallModelCreated;
 
-    Texture2D explosion0;
-    Texture2D explosion1;
-    Texture2D explosion2;
+    Texture2D particleAtlas;
+    Rectangle particleFrames[PARTICLE_FRAME_QUANTITY];
 
-    Shader lightShader;
+    Shader lightShaders[LIGHTING_TIER_QUANTITY];    // compiled on first use
+    Shader sphereShader;
+    Shader lightmapShader;
+    Shader checkerShader;           // lightmap shader painting a checkerboard
+    Shader decalShader;
+    Shader impostorShader;
+    Shader depthShader;
+    Shader pickShader;
 
     Sound handgunSound;
     Sound submachinegunSound;
@@ -67,6 +75,12 @@ extern ResourceManager rm;
  */
 void loadResourcesResourceManager( void );
 
+/**
+ * @brief Returns the light shader of a tier. Only the tiers that are used
+ * are compiled, the first time they are asked for.
+ */
+Shader getLightShaderResourceManager( LightingTier tier );
+
 /**
  * @brief Unload global game resources.
  */
@@ -0,0 +1,57 @@
+/**
+ * @file SceneTarget.h
+ * @author Prof. Dr. David Buzatto
+ * @brief SceneTarget struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+// smallest fraction of the window resolution used to render the scene
+#define SCENE_TARGET_MIN_SCALE 0.5f
+
+/**
+ * @brief Render texture where the 3D scene of a view is drawn with a
+ * fraction of the window resolution, to be scaled up to the region of the
+ * view afterwards. The texture has the size of the window and only its
+ * bottom left corner is used, so changing the scale or the view doesn't
+ * allocate anything. With the full scale the scene is drawn directly in
+ * the region of the window, which keeps the multisampling of the default
+ * framebuffer.
+ */
+typedef struct SceneTarget {
+    RenderTexture2D target;
+    Rectangle viewport;     // region of the window, in screen coordinates
+    int x;                  // region being drawn, in framebuffer pixels (bottom up)
+    int y;
+    int width;
+    int height;
+    bool offscreen;
+} SceneTarget;
+
+/**
+ * @brief Starts drawing the scene of the view in a region of the window
+ * with a scale of its render size, clearing only that region. x, y, width
+ * and height receive the region being drawn, which is the viewport of the
+ * 3D mode.
+ */
+void beginSceneTarget( SceneTarget *st, float scale, Rectangle viewport, Color background );
+
+/**
+ * @brief BeginMode3D with the aspect ratio of the region being drawn,
+ * since BeginMode3D takes the one of the whole framebuffer.
+ */
+void beginSceneMode3D( SceneTarget *st, Camera3D camera );
+
+/**
+ * @brief Stops drawing in the target and draws it stretched over the
+ * region of the view. Everything drawn after it has the native resolution
+ * and the whole window.
+ */
+void endSceneTarget( SceneTarget *st );
+
+void unloadSceneTarget( SceneTarget *st );
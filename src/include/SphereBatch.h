@@ -0,0 +1,90 @@
+/**
+ * @file SphereBatch.h
+ * @author Prof. Dr. David Buzatto
+ * @brief SphereBatch struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#define SPHERE_BATCH_LOD_QUANTITY 3
+
+typedef enum SphereBatchFlag {
+    SPHERE_BATCH_FLAG_NONE = 0,
+    SPHERE_BATCH_FLAG_CHECKERED = 1,    // checkered like the power-ups texture
+    SPHERE_BATCH_FLAG_UNLIT = 2,        // flat color, like the light markers
+    SPHERE_BATCH_FLAG_WIRES = 4,        // black wires drawn over the sphere
+    SPHERE_BATCH_FLAG_WIRES_ONLY = 8
+} SphereBatchFlag;
+
+/**
+ * @brief Per instance data, read by the vertex shader.
+ */
+typedef struct SphereInstance {
+    Vector3 pos;
+    float radius;
+    Color color;
+    float angle;
+    float flags;
+} SphereInstance;
+
+typedef struct SphereInstanceList {
+    SphereInstance *data;
+    int count;
+    int capacity;
+    unsigned int vboId;
+    int vboCapacity;
+} SphereInstanceList;
+
+/**
+ * @brief Collects every sphere of a frame and draws them with one instanced
+ * call per level of detail. The level of detail of each sphere is chosen by
+ * its radius on the screen.
+ */
+typedef struct SphereBatch {
+
+    bool initialized;
+
+    Mesh lods[SPHERE_BATCH_LOD_QUANTITY];
+    SphereInstanceList solids[SPHERE_BATCH_LOD_QUANTITY];
+    SphereInstanceList wires[SPHERE_BATCH_LOD_QUANTITY];    // only without instancing, the shader draws the wires
+
+    Shader shader;
+    bool instancing;
+    int viewPosLoc;
+    int gridSizeLoc;
+    int instancePositionLoc;
+    int instanceColorLoc;
+    int instanceParamsLoc;
+
+    Camera3D camera;
+    float pixelsPerUnit;
+
+    int drawCalls;
+    int instanceCount;
+    int triangleCount;
+
+} SphereBatch;
+
+/**
+ * @brief Creates the meshes of each level of detail. If the shader isn't
+ * valid the spheres are drawn one by one with DrawSphereEx.
+ */
+void initSphereBatch( SphereBatch *sb, Shader shader );
+void destroySphereBatch( SphereBatch *sb );
+
+/**
+ * @brief Clears the batch for a new frame.
+ */
+void beginSphereBatch( SphereBatch *sb, Camera3D camera, int screenHeight );
+void addSphereBatch( SphereBatch *sb, Vector3 pos, float radius, Color color, float angle, int flags );
+
+/**
+ * @brief Draws every sphere added since beginSphereBatch. Must be called
+ * inside BeginMode3D.
+ */
+void drawSphereBatch( SphereBatch *sb );
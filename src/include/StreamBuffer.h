@@ -0,0 +1,105 @@
+/**
+ * @file StreamBuffer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief StreamBuffer struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+// frames of vertices in the buffer and the vertices of each frame
+#define STREAM_BUFFER_FRAMES 3
+#define STREAM_BUFFER_FRAME_VERTICES 131072
+
+typedef struct StreamVertex {
+    Vector3 pos;
+    Color color;
+} StreamVertex;
+
+typedef enum StreamBufferMode {
+    STREAM_BUFFER_MODE_PERSISTENT,  // mapped once (GL 4.4), the vertices are written in the buffer
+    STREAM_BUFFER_MODE_MAPPED,      // each draw maps its range unsynchronized (GL 3.3)
+    STREAM_BUFFER_MODE_SUB_DATA,    // each draw copies with glBufferSubData (GL 2.1, web)
+    STREAM_BUFFER_MODE_QUANTITY
+} StreamBufferMode;
+
+/**
+ * @brief Ring of vertices for the geometry that changes every frame (wire
+ * cubes, HP bars, the reticle and the debug lines). The buffer has one
+ * segment per frame in flight and each frame writes only to its own
+ * segment. A fence is placed after the draws of a segment and waited on
+ * before the segment is written again, so the driver never has to
+ * synchronize the writes by itself. With a persistent mapping the vertices
+ * go straight to the buffer; otherwise they are collected in memory and
+ * every draw writes the ones added since the last draw, at their offset
+ * in the segment, with one call.
+ *
+ * Lines are drawn as triangles, quads facing the camera (1 pixel wide in
+ * 2D, 1.5 in 3D), so the whole frame uses a single vertex format and
+ * primitive.
+ */
+typedef struct StreamBuffer {
+
+    bool initialized;
+    StreamBufferMode mode;
+
+    unsigned int vaoId;
+    unsigned int vboId;
+
+    StreamVertex *vertices;         // where the frame writes, in memory or in the mapped segment
+    StreamVertex *memory;           // NULL with a persistent mapping
+    StreamVertex *mapped;
+    void *fences[STREAM_BUFFER_FRAMES];
+    int count;
+    int drawnCount;
+    int segment;
+
+    // to size the 3D lines in pixels
+    Vector3 viewPosition;
+    float pixelSize;
+
+    int drawCalls;
+    int uploadedBytes;
+    int droppedVertices;
+    int fenceWaits;                 // segments the GPU was still reading
+
+} StreamBuffer;
+
+void initStreamBuffer( StreamBuffer *sb );
+void destroyStreamBuffer( StreamBuffer *sb );
+
+/**
+ * @brief Fences the segment of the last frame and moves to the next one,
+ * waiting for the GPU if it is still reading it.
+ */
+void beginStreamBuffer( StreamBuffer *sb );
+
+/**
+ * @brief Sets the camera the 3D lines face, for each view of the frame.
+ * The viewport height is the height where the camera is rendered.
+ */
+void setCameraStreamBuffer( StreamBuffer *sb, Camera3D camera, int viewportHeight );
+
+void addTriangleStreamBuffer( StreamBuffer *sb, Vector3 v1, Vector3 v2, Vector3 v3, Color color );
+void addLine3DStreamBuffer( StreamBuffer *sb, Vector3 startPos, Vector3 endPos, Color color );
+void addCubeWiresStreamBuffer( StreamBuffer *sb, Vector3 pos, Vector3 dim, Color color );
+
+/**
+ * @brief The 2D primitives use screen coordinates, as DrawLine and the
+ * other shapes of raylib.
+ */
+void addRectangleStreamBuffer( StreamBuffer *sb, float x, float y, float width, float height, Color color );
+void addLine2DStreamBuffer( StreamBuffer *sb, Vector2 startPos, Vector2 endPos, Color color );
+void addCircleLinesStreamBuffer( StreamBuffer *sb, Vector2 center, float radius, Color color );
+
+/**
+ * @brief Uploads and draws the vertices added since the last draw with the
+ * current matrices, so it goes inside BeginMode3D after the 3D primitives
+ * and outside it after the 2D ones.
+ */
+void drawStreamBuffer( StreamBuffer *sb );
+const char *getStreamBufferModeName( StreamBufferMode mode );
@@ -0,0 +1,154 @@
+/**
+ * @file WorldChunks.h
+ * @author Prof. Dr. David Buzatto
+ * @brief WorldChunks struct and function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "Block.h"
+#include "WorldMesher.h"
+#include "raylib/raylib.h"
+#include "raylib/rlights.h"
+
+#define i_TYPE BlockIndexes, int
+#include "stc/vec.h"
+
+// chunk side, in voxels, along the x and z axis
+#define WORLD_CHUNK_SIZE 16
+
+typedef enum WorldChunkMaterial {
+    WORLD_CHUNK_MATERIAL_NONE,
+    WORLD_CHUNK_MATERIAL_OBSTACLE,
+    WORLD_CHUNK_MATERIAL_BREAKABLE_OBSTACLE,
+    WORLD_CHUNK_MATERIAL_QUANTITY
+} WorldChunkMaterial;
+
+typedef struct WorldChunk {
+
+    // voxel region [min, max) covered by the chunk
+    int minX;
+    int minZ;
+    int maxX;
+    int maxZ;
+
+    // region plus the blocks that cross its border
+    BoundingBox bounds;
+
+    // indexes of the obstacles whose center lies inside the chunk
+    BlockIndexes blocks;
+
+    Model model;
+    bool modelLoaded;
+    int quadCount;
+    Texture2D lightmap;
+
+    int version;
+    int meshedVersion;
+    bool jobPending;
+
+} WorldChunk;
+
+/**
+ * @brief Read-only copy of the whole world, for the shadows of the
+ * lightmaps. The jobs submitted between two edits share the same copy,
+ * which is freed when the last of them is done with it.
+ */
+typedef struct WorldChunkOccluders {
+    VoxelGrid grid;
+    int version;            // editVersion of the world when it was copied
+    int references;         // the jobs using it, plus one while it is the newest
+} WorldChunkOccluders;
+
+typedef struct WorldChunkJob {
+    int chunk;
+    int version;
+    VoxelGrid grid;
+    WorldChunkOccluders *occluders;
+    GreedyMeshData data;
+    Image lightmap;
+} WorldChunkJob;
+
+typedef struct WorldChunks {
+
+    bool initialized;
+
+    Obstacles *obstacles;
+    VoxelGrid grid;
+    float blockSize;
+
+    WorldChunk *chunks;
+    int chunkQuantity;
+
+    // changes with every edit of the grid
+    int editVersion;
+    WorldChunkOccluders *occluders;
+    int chunkCountX;
+    int chunkCountZ;
+
+    Texture2D texture;
+    Shader shader;
+    Color palette[WORLD_CHUNK_MATERIAL_QUANTITY];
+
+    // static lights baked in the lightmap of each chunk
+    Light *lights;
+    int lightQuantity;
+    float lightRadius;
+
+    // the meshes are generated in a worker thread and uploaded by the main thread
+    pthread_t worker;
+    pthread_mutex_t mutex;
+    pthread_cond_t jobAvailable;
+    bool workerRunning;
+
+    WorldChunkJob *jobs;
+    int jobStart;
+    int jobCount;
+
+    WorldChunkJob *results;
+    int resultStart;
+    int resultCount;
+
+} WorldChunks;
+
+/**
+ * @brief Splits the obstacles into chunks, meshing all of them and baking
+ * the lights in their lightmaps. The obstacles vector is referenced and must
+ * outlive the chunks.
+ */
+void initWorldChunks( WorldChunks *wc, Obstacles *obstacles, BoundingBox worldBounds, float blockSize, Color obstacleColor, Color breakableObstacleColor, const Light *lights, int lightQuantity, float lightRadius );
+
+/**
+ * @brief Stops the worker thread and unloads the chunk models.
+ */
+void destroyWorldChunks( WorldChunks *wc );
+
+void setShaderWorldChunks( WorldChunks *wc, Shader shader );
+
+/**
+ * @brief Sends the changed chunks to be remeshed and uploads the meshes
+ * that are ready. Must be called by the main thread once per frame.
+ */
+void updateWorldChunks( WorldChunks *wc );
+
+/**
+ * @brief Draws the chunks. visibleChunks, if not NULL, tells which chunks
+ * are inside the camera frustum.
+ */
+void drawWorldChunks( WorldChunks *wc, RenderQueue *rq, StreamBuffer *sb, bool renderTouchColor, const bool *visibleChunks );
+
+void addBlockWorldChunks( WorldChunks *wc, Block block );
+void removeBlockWorldChunks( WorldChunks *wc, int index );
+
+/**
+ * @brief Collects the indexes of the obstacles that intersect the box.
+ * Returns how many indexes were written.
+ */
+int queryBoxWorldChunks( WorldChunks *wc, BoundingBox box, int *indexes, int maxIndexes );
+
+int getQuadCountWorldChunks( WorldChunks *wc );
+int getPendingJobsWorldChunks( WorldChunks *wc );
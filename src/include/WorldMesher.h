@@ -0,0 +1,69 @@
+/**
+ * @file WorldMesher.h
+ * @author Prof. Dr. David Buzatto
+ * @brief VoxelGrid struct and greedy mesher function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Block.h"
+#include "raylib/raylib.h"
+
+/**
+ * @brief Occupancy grid of the static world. Each voxel has voxelSize units
+ * per side and the voxel (0, 0, 0) has its minimum corner at origin.
+ * Everything below groundLevel (in voxels) is considered solid (the ground).
+ * Each cell stores a material index (zero means empty) used to pick the
+ * vertex color of the generated faces.
+ */
+typedef struct VoxelGrid {
+    int width;
+    int height;
+    int depth;
+    int groundLevel;
+    float voxelSize;
+    Vector3 origin;
+    unsigned char *cells;
+} VoxelGrid;
+
+/**
+ * @brief CPU side result of the greedy mesher. The meshes are not uploaded
+ * to the GPU, so the data can be generated outside the main thread.
+ */
+typedef struct GreedyMeshData {
+    Mesh *meshes;
+    int meshCount;
+    int quadCount;
+} GreedyMeshData;
+
+VoxelGrid createVoxelGrid( BoundingBox bounds, float voxelSize );
+void destroyVoxelGrid( VoxelGrid *grid );
+
+/**
+ * @brief Copies the region [min, max) of the grid to a new grid, keeping
+ * the world position of each voxel. Used to mesh a region of the world
+ * without sharing the original grid.
+ */
+VoxelGrid copyVoxelGridRegion( VoxelGrid *grid, int minX, int minY, int minZ, int maxX, int maxY, int maxZ );
+void setVoxelGridBlock( VoxelGrid *grid, Block *block, unsigned char material );
+bool isVoxelGridSolid( VoxelGrid *grid, int x, int y, int z );
+unsigned char getVoxelGridMaterial( VoxelGrid *grid, int x, int y, int z );
+
+/**
+ * @brief Generates merged quads for the solid voxels inside the region
+ * [min, max) of the grid. Faces touching other solid voxels or the ground
+ * are dropped and coplanar faces of the same material are merged into larger
+ * quads. Texture coordinates are world aligned and repeat every uvScale
+ * units and vertex colors come from palette, indexed by material.
+ */
+GreedyMeshData buildGreedyMeshData( VoxelGrid *grid, int minX, int minY, int minZ, int maxX, int maxY, int maxZ, float uvScale, const Color *palette );
+void unloadGreedyMeshData( GreedyMeshData *data );
+
+/**
+ * @brief Uploads the meshes to the GPU and returns a model that owns them.
+ * The data is moved to the model and must not be unloaded after that.
+ */
+Model loadModelFromGreedyMeshData( GreedyMeshData *data );
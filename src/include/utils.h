@@ -11,4 +11,6 @@
 
 Color interpolate2Color( Color c1, Color c2, float t );
 Color interpolate3Color( Color c1, Color c2, Color c3, float t );
-bool colorEqualsIgnoreAlpha( Color c1, Color c2 );
\ No newline at end of file
+bool colorEqualsIgnoreAlpha( Color c1, Color c2 );
+BoundingBox expandBoundingBox( BoundingBox bb, float amount );
+unsigned int hashFnv1a( const unsigned char *data, int size );
\ No newline at end of file
@@ -9,18 +9,26 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
+#include "Benchmark.h"
 #include "GameWindow.h"
+#include "GameWorld.h"
 
-int main( void ) {
+/**
+ * Usage: MyShooter [--benchmark [map file] [frames]]
+ */
+int main( int argc, char **argv ) {
+
+    bool benchmark = argc > 1 && strcmp( argv[1], "--benchmark" ) == 0;
 
     GameWindow *gameWindow = createGameWindow(
         800,             // width
         450,             // height
         "My Shooter",    // title
-        60,              // target FPS
+        benchmark ? 0 : 60,  // target FPS (unlimited in the benchmark)
         true,            // antialiasing
-        true,            // resizable
+        !benchmark,      // resizable
         false,           // full screen
         false,           // undecorated
         false,           // always on top
@@ -29,6 +37,14 @@ int main( void ) {
         true             // init audio
     );
 
+    if ( benchmark ) {
+        customMapFilePath = argc > 2 ? argv[2] : BENCHMARK_DEFAULT_MAP;
+        gameWindow->benchmarkFrames = argc > 3 ? atoi( argv[3] ) : BENCHMARK_DEFAULT_FRAMES;
+        if ( gameWindow->benchmarkFrames <= 0 ) {
+            gameWindow->benchmarkFrames = BENCHMARK_DEFAULT_FRAMES;
+        }
+    }
+
     initGameWindow( gameWindow );
 
     return 0;
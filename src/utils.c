@@ -29,4 +29,24 @@ Color interpolate3Color( Color c1, Color c2, Color c3, float t ) {
 
 bool colorEqualsIgnoreAlpha( Color c1, Color c2 ) {
     return c1.r == c2.r && c1.g == c2.g && c1.b == c2.b;
+}
+
+BoundingBox expandBoundingBox( BoundingBox bb, float amount ) {
+    return (BoundingBox){
+        .min = { bb.min.x - amount, bb.min.y - amount, bb.min.z - amount },
+        .max = { bb.max.x + amount, bb.max.y + amount, bb.max.z + amount }
+    };
+}
+
+unsigned int hashFnv1a( const unsigned char *data, int size ) {
+
+    unsigned int hash = 2166136261u;
+
+    for ( int i = 0; i < size; i++ ) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+
 }
\ No newline at end of file